@@ -264,7 +264,7 @@ void CLTBMode::loadIncludes()
       if (inp.fail()) {
         USER_ERROR("Cannot open included file: "+fname);
       }
-      Parse::TPTP parser(inp);
+      Parse::TPTP parser(inp,fname);
       parser.parse();
       UnitList* funits = parser.units();
       if (parser.containsConjecture()) {
@@ -282,7 +282,22 @@ void CLTBMode::loadIncludes()
   _baseProblem = new Problem(theoryAxioms);
   //ensure we scan the theory axioms for property here, so we don't need to
   //do it afterward in each problem
-  _baseProblem->getProperty();
+  Shell::Property* property = _baseProblem->getProperty();
+
+  _baseNormalised = false;
+  if (env.options->ltbResidentBase()) {
+    // whatever we do here is inherited by the processes solving the problems
+    TimeCounter tc(TC_PREPROCESSING);
+    if (property->atoms()<=1000000) {
+      env.statistics->phase=Statistics::NORMALIZATION;
+      Normalisation norm;
+      norm.normalise(*_baseProblem);
+      _baseNormalised = true;
+    }
+    env.statistics->phase=Statistics::SINE_SELECTION;
+    _theorySelector = new Shell::SineTheorySelector(*env.options);
+    _theorySelector->initSelectionStructure(_baseProblem->units());
+  }
   env.statistics->phase=Statistics::UNKNOWN_PHASE;
 } // CLTBMode::loadIncludes
 
@@ -583,7 +598,7 @@ vstring CLTBProblem::problemFinishedString = "##Problem finished##vn;3-d-ca-12=1
 
 CLTBProblem::CLTBProblem(CLTBMode* parent, vstring problemFile, vstring outFile)
   : parent(parent), problemFile(problemFile), outFile(outFile),
-    prb(*parent->_baseProblem), _syncSemaphore(1)
+    prb(*parent->_baseProblem), _problemUnits(0), _syncSemaphore(1)
 {
   //add the privileges into the semaphore
   _syncSemaphore.set(0,1);
@@ -711,7 +726,7 @@ void CLTBProblem::searchForProof(int terminationTime,int timeLimit,const Categor
     if (inp.fail()) {
       USER_ERROR("Cannot open problem file: " + problemFile);
     }
-    Parse::TPTP parser(inp);
+    Parse::TPTP parser(inp,problemFile);
     List<vstring>::Iterator iit(parent->_theoryIncludes);
     while (iit.hasNext()) {
       parser.addForbiddenInclude(iit.next());
@@ -719,6 +734,13 @@ void CLTBProblem::searchForProof(int terminationTime,int timeLimit,const Categor
     parser.parse();
     UnitList* probUnits = parser.units();
     UIHelper::setConjecturePresence(parser.containsConjecture());
+    if (parent->_baseNormalised) {
+      // the theory axioms are normalised already, so only normalise the rest
+      TimeCounter tc(TC_PREPROCESSING);
+      Normalisation norm;
+      probUnits = norm.normalise(probUnits);
+    }
+    _problemUnits = UnitList::copy(probUnits);
     prb.addUnits(probUnits);
 
     // Now we iterate over all units in the problem and populate
@@ -755,7 +777,7 @@ void CLTBProblem::searchForProof(int terminationTime,int timeLimit,const Categor
   }
 
   Shell::Property* property = prb.getProperty();
-  if (property->atoms()<=1000000) {
+  if (!parent->_baseNormalised && property->atoms()<=1000000) {
     TimeCounter tc(TC_PREPROCESSING);
     env.statistics->phase=Statistics::NORMALIZATION;
     Normalisation norm;
@@ -1001,17 +1023,18 @@ void CLTBProblem::runSlice(Options& strategyOpt)
   opt.setProblemName(problemFile);
   *env.options = opt; //just temporarily until we get rid of dependencies on env.options in solving
 
-//  if (env.options->sineSelection()!=Options::SS_OFF) {
-//    //add selected axioms from the theory
-//    parent->theorySelector.perform(probUnits);
-//
-//    env.options->setSineSelection(Options::SS_OFF);
-//    env.options->forceIncompleteness();
-//  }
-//  else {
-//    //if there wasn't any sine selection, just put in all theory axioms
-//    probUnits=UnitList::concat(probUnits, parent->theoryAxioms);
-//  }
+  if (parent->_theorySelector && parent->_theorySelector->supports(opt)) {
+    // select the theory axioms using the structure the batch process built,
+    // rather than letting the preprocessing rebuild it over the whole problem
+    UnitList* units = UnitList::copy(_problemUnits);
+    parent->_theorySelector->perform(units);
+    prb.units() = units;
+    prb.reportIncompleteTransformation();
+    prb.invalidateByRemoval();
+
+    opt.setSineSelection(Options::SineSelection::OFF);
+    *env.options = opt;
+  }
 
   env.beginOutput();
   CLTBMode::lineOutput() << opt.testId() << " on " << opt.problemName() << endl;
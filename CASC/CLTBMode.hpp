@@ -111,6 +111,17 @@ private:
 
   ScopedPtr<Problem> _baseProblem;
 
+  /**
+   * SInE selection structure over the axioms of @c _baseProblem
+   *
+   * Only built with the ltb_resident_base option, in which case the
+   * axioms of @c _baseProblem are also already normalised. The problem
+   * processes inherit both from this process.
+   */
+  ScopedPtr<Shell::SineTheorySelector> _theorySelector;
+  /** true if the axioms of @c _baseProblem were normalised by this process */
+  bool _baseNormalised;
+
   // This contains formulas 'learned' in the sense that they were input
   // formulas used in proofs of previous problems
   // Note: this relies on the assurance that formulas are consistently named
@@ -165,6 +176,9 @@ private:
    */
   Problem& prb;
 
+  /** Formulas of the problem itself, without the axioms of the parent's base problem */
+  UnitList* _problemUnits;
+
   Semaphore _syncSemaphore; // semaphore for synchronizing writing if the solution
 
   /**
@@ -292,7 +292,7 @@ void CLTBModeLearning::loadIncludes()
       if (inp.fail()) {
         USER_ERROR("Cannot open included file: "+fname);
       }
-      Parse::TPTP parser(inp);
+      Parse::TPTP parser(inp,fname);
       parser.parse();
       UnitList* funits = parser.units();
       if (parser.containsConjecture()) {
@@ -843,7 +843,7 @@ void CLTBProblemLearning::searchForProof(int terminationTime,int timeLimit, Sche
     if (inp.fail()) {
       USER_ERROR("Cannot open problem file: " + problemFile);
     }
-    Parse::TPTP parser(inp);
+    Parse::TPTP parser(inp,problemFile);
     List<vstring>::Iterator iit(parent->_theoryIncludes);
     while (iit.hasNext()) {
       parser.addForbiddenInclude(iit.next());
@@ -35,6 +35,7 @@
 #include "Shell/Statistics.hpp"
 #include "Shell/UIHelper.hpp"
 #include "Shell/Normalisation.hpp"
+#include "Shell/SineUtils.hpp"
 #include "Shell/TheoryFinder.hpp"
 
 #include <unistd.h>
@@ -131,6 +132,13 @@ bool PortfolioMode::searchForProof()
     Normalisation().normalise(*_prb);
 
     TheoryFinder(_prb->units(),property).search();
+
+    //slices with different SInE settings can share the symbol generality
+    //and the D-relation, unless the units change before SInE runs
+    if (!_prb->hasInterpretedOperations() && !_prb->hasFOOL()) {
+      ScopedLet<Statistics::ExecutionPhase> phaseLet(env.statistics->phase,Statistics::SINE_SELECTION);
+      SineIndex::setShared(new SineIndex(_prb->units()));
+    }
   }
 
   // now all the cpu usage will be in children, we'll just be waiting for them
@@ -0,0 +1,147 @@
+
+/*
+ * File CombinedDP.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file CombinedDP.cpp
+ * Implements class CombinedDP.
+ */
+
+#include "Kernel/Term.hpp"
+
+#include "CombinedDP.hpp"
+
+namespace DP
+{
+
+CombinedDP::CombinedDP(DecisionProcedure* dp1, DecisionProcedure* dp2)
+{
+  CALL("CombinedDP::CombinedDP");
+
+  _inner.push(dp1);
+  _inner.push(dp2);
+}
+
+CombinedDP::~CombinedDP()
+{
+  CALL("CombinedDP::~CombinedDP");
+
+  while (_inner.isNonEmpty()) {
+    delete _inner.pop();
+  }
+}
+
+void CombinedDP::addLiterals(LiteralIterator lits, bool onlyEqualites)
+{
+  CALL("CombinedDP::addLiterals");
+
+  static LiteralStack added;
+  added.reset();
+  added.loadFromIterator(lits);
+
+  Stack<DecisionProcedure*>::Iterator it(_inner);
+  while (it.hasNext()) {
+    it.next()->addLiterals(pvi(LiteralStack::Iterator(added)), onlyEqualites);
+  }
+}
+
+/**
+ * Return UNSATISFIABLE if one of the inner procedures is, taking the cores
+ * of the first such one (or of all of them if @b getMultipleCores),
+ * SATISFIABLE if all of them are and UNKNOWN otherwise
+ */
+DecisionProcedure::Status CombinedDP::getStatus(bool getMultipleCores)
+{
+  CALL("CombinedDP::getStatus");
+
+  _unsatCores.reset();
+  Status res = SATISFIABLE;
+  Stack<DecisionProcedure*>::BottomFirstIterator it(_inner);
+  while (it.hasNext()) {
+    DecisionProcedure* dp = it.next();
+    Status status = dp->getStatus(getMultipleCores);
+    if (status==UNKNOWN && res==SATISFIABLE) {
+      res = UNKNOWN;
+    }
+    if (status!=UNSATISFIABLE) {
+      continue;
+    }
+    res = UNSATISFIABLE;
+    unsigned cnt = dp->getUnsatCoreCount();
+    for (unsigned i=0; i<cnt; i++) {
+      _unsatCores.push(LiteralStack());
+      dp->getUnsatCore(_unsatCores.top(), i);
+    }
+    if (!getMultipleCores) {
+      break;
+    }
+  }
+  return res;
+}
+
+void CombinedDP::getUnsatCore(LiteralStack& res, unsigned coreIndex)
+{
+  CALL("CombinedDP::getUnsatCore");
+  ASS(res.isEmpty());
+  ASS_L(coreIndex, _unsatCores.size());
+
+  res = _unsatCores[coreIndex];
+}
+
+void CombinedDP::getModel(LiteralStack& model)
+{
+  CALL("CombinedDP::getModel");
+
+  Stack<DecisionProcedure*>::BottomFirstIterator it(_inner);
+  while (it.hasNext()) {
+    it.next()->getModel(model);
+  }
+}
+
+void CombinedDP::reset()
+{
+  CALL("CombinedDP::reset");
+
+  Stack<DecisionProcedure*>::Iterator it(_inner);
+  while (it.hasNext()) {
+    it.next()->reset();
+  }
+  _unsatCores.reset();
+}
+
+void CombinedDP::push()
+{
+  CALL("CombinedDP::push");
+
+  Stack<DecisionProcedure*>::Iterator it(_inner);
+  while (it.hasNext()) {
+    it.next()->push();
+  }
+}
+
+void CombinedDP::pop(unsigned levelCnt)
+{
+  CALL("CombinedDP::pop");
+
+  Stack<DecisionProcedure*>::Iterator it(_inner);
+  while (it.hasNext()) {
+    it.next()->pop(levelCnt);
+  }
+  _unsatCores.reset();
+}
+
+}
@@ -0,0 +1,81 @@
+
+/*
+ * File CombinedDP.hpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file CombinedDP.hpp
+ * Defines class CombinedDP.
+ */
+
+#ifndef __CombinedDP__
+#define __CombinedDP__
+
+#include "Forwards.hpp"
+
+#include "Lib/Stack.hpp"
+
+#include "DecisionProcedure.hpp"
+
+namespace DP {
+
+using namespace Lib;
+using namespace Kernel;
+
+/**
+ * Decision procedure passing the literals to several inner decision
+ * procedures, each of which ignores the literals it does not understand.
+ *
+ * The literal set is unsatisfiable if one of the inner procedures says so
+ * and the unsat cores are theirs. The procedures do not exchange any
+ * information, so conflicts that need reasoning in more theories at once
+ * are not found.
+ */
+class CombinedDP : public DecisionProcedure
+{
+public:
+  CLASS_NAME(CombinedDP);
+  USE_ALLOCATOR(CombinedDP);
+
+  /**
+   * Create object combining @c dp1 and @c dp2. Object takes ownership of them.
+   */
+  CombinedDP(DecisionProcedure* dp1, DecisionProcedure* dp2);
+  ~CombinedDP();
+
+  virtual void addLiterals(LiteralIterator lits, bool onlyEqualites) override;
+
+  virtual Status getStatus(bool getMultipleCores) override;
+  virtual unsigned getUnsatCoreCount() override { return _unsatCores.size(); }
+  virtual void getUnsatCore(LiteralStack& res, unsigned coreIndex) override;
+
+  void getModel(LiteralStack& model) override;
+
+  virtual void reset() override;
+
+  virtual void push() override;
+  virtual void pop(unsigned levelCnt=1) override;
+  virtual unsigned level() const override { return _inner[0]->level(); }
+
+private:
+  Stack<DecisionProcedure*> _inner;
+
+  Stack<LiteralStack> _unsatCores;
+};
+
+}
+
+#endif // __CombinedDP__
@@ -69,6 +69,19 @@ public:
   virtual void getUnsatCore(LiteralStack& res, unsigned coreIndex=0) = 0;
   /** reset decision procedure object into state equivalent to its initial state */
   virtual void reset() = 0;
+
+  /**
+   * Open a new backtracking level. Literals added from now on
+   * are retracted by the matching call to pop().
+   */
+  virtual void push() = 0;
+  /**
+   * Retract the literals added since the @c levelCnt most recent calls
+   * to push() (and everything that was derived from them).
+   */
+  virtual void pop(unsigned levelCnt=1) = 0;
+  /** Return the number of backtracking levels currently open */
+  virtual unsigned level() const = 0;
 };
 
 }
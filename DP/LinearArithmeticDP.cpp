@@ -0,0 +1,655 @@
+
+/*
+ * File LinearArithmeticDP.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file LinearArithmeticDP.cpp
+ * Implements class LinearArithmeticDP.
+ */
+
+#include "Debug/RuntimeStatistics.hpp"
+
+#include "Lib/DHSet.hpp"
+#include "Lib/Environment.hpp"
+
+#include "Kernel/Signature.hpp"
+#include "Kernel/SortHelper.hpp"
+#include "Kernel/Sorts.hpp"
+
+#include "LinearArithmeticDP.hpp"
+
+namespace DP
+{
+
+LinearArithmeticDP::LinearArithmeticDP()
+: _conflict(false), _incomplete(false)
+{
+  CALL("LinearArithmeticDP::LinearArithmeticDP");
+}
+
+LinearArithmeticDP::~LinearArithmeticDP()
+{
+  CALL("LinearArithmeticDP::~LinearArithmeticDP");
+
+  reset();
+}
+
+void LinearArithmeticDP::reset()
+{
+  CALL("LinearArithmeticDP::reset");
+
+  while (_vars.isNonEmpty()) {
+    delete _vars.pop();
+  }
+  while (_rows.isNonEmpty()) {
+    delete _rows.pop();
+  }
+  _atomVars.reset();
+  _slackVars.reset();
+  _trail.reset();
+  _levels.reset();
+  _conflict = false;
+  _incomplete = false;
+  _unsatCore.reset();
+}
+
+void LinearArithmeticDP::push()
+{
+  CALL("LinearArithmeticDP::push");
+
+  LevelInfo li;
+  li.trailSize = _trail.size();
+  li.conflict = _conflict;
+  li.incomplete = _incomplete;
+  _levels.push(li);
+}
+
+/**
+ * Restore the bounds from before the @c levelCnt most recent calls to push()
+ *
+ * The assignment stays as it is: it satisfies the tableau and, since the
+ * bounds only become weaker, the non-basic variables stay within them.
+ */
+void LinearArithmeticDP::pop(unsigned levelCnt)
+{
+  CALL("LinearArithmeticDP::pop");
+  ASS_LE(levelCnt,_levels.size());
+
+  if (!levelCnt) {
+    return;
+  }
+
+  _levels.truncate(_levels.size()-levelCnt+1);
+  LevelInfo li = _levels.pop();
+
+  while (_trail.size()>li.trailSize) {
+    TrailEntry te = _trail.pop();
+    Var* v = _vars[te.var];
+    (te.upper ? v->upper : v->lower) = te.old;
+  }
+  _conflict = li.conflict;
+  _incomplete = li.incomplete;
+  if (!_conflict) {
+    _unsatCore.reset();
+  }
+}
+
+void LinearArithmeticDP::addLiterals(LiteralIterator lits, bool onlyEqualites)
+{
+  CALL("LinearArithmeticDP::addLiterals");
+
+  while (lits.hasNext()) {
+    Literal* l = lits.next();
+    if (!l->ground()) {
+      _incomplete = true;
+      continue;
+    }
+    if (!onlyEqualites || (l->isEquality() && l->isPositive())) {
+      addLiteral(l);
+    }
+  }
+}
+
+/**
+ * Assert the bound given by the literal @b lit, if it is an inequality or
+ * a positive equality of a numeric sort
+ */
+void LinearArithmeticDP::addLiteral(Literal* lit)
+{
+  CALL("LinearArithmeticDP::addLiteral");
+
+  if (_conflict) {
+    // the bounds are inconsistent until the level is popped
+    return;
+  }
+
+  unsigned sort;
+  TermList lhs;
+  TermList rhs;
+  // the literal says lhs-rhs<0 if strict, lhs-rhs<=0 if not, lhs-rhs=0 if equality
+  bool strict = false;
+  bool equality = false;
+
+  if (lit->isEquality()) {
+    sort = SortHelper::getEqualityArgumentSort(lit);
+    if (!Polynomial::isPolynomialSort(sort) || lit->isNegative()) {
+      _incomplete = true;
+      return;
+    }
+    equality = true;
+    lhs = *lit->nthArgument(0);
+    rhs = *lit->nthArgument(1);
+  }
+  else {
+    if (!theory->isInterpretedPredicate(lit)) {
+      _incomplete = true;
+      return;
+    }
+    Interpretation itp = theory->interpretPredicate(lit);
+    switch(itp) {
+    case Theory::INT_LESS:
+    case Theory::RAT_LESS:
+    case Theory::REAL_LESS:
+      strict = true;
+      // no break
+    case Theory::INT_LESS_EQUAL:
+    case Theory::RAT_LESS_EQUAL:
+    case Theory::REAL_LESS_EQUAL:
+      lhs = *lit->nthArgument(0);
+      rhs = *lit->nthArgument(1);
+      break;
+    case Theory::INT_GREATER:
+    case Theory::RAT_GREATER:
+    case Theory::REAL_GREATER:
+      strict = true;
+      // no break
+    case Theory::INT_GREATER_EQUAL:
+    case Theory::RAT_GREATER_EQUAL:
+    case Theory::REAL_GREATER_EQUAL:
+      lhs = *lit->nthArgument(1);
+      rhs = *lit->nthArgument(0);
+      break;
+    default:
+      _incomplete = true;
+      return;
+    }
+    sort = theory->getOperationSort(itp);
+    if (lit->isNegative()) {
+      // ~(l<r) is r<=l and ~(l<=r) is r<l
+      swap(lhs, rhs);
+      strict = !strict;
+    }
+  }
+  if (sort==Sorts::SRT_INTEGER) {
+    _incomplete = true;
+  }
+
+  Rational one(IntegerConstantType(1));
+  Rational zero(IntegerConstantType(0));
+
+  Polynomial p(sort);
+  _polynomials.add(lhs, one, p);
+  _polynomials.add(rhs, -one, p);
+  p.normalize();
+
+  // the linear part of p compared to bound
+  Rational bound = -p.constant();
+  if (p.isConstant()) {
+    bool holds = equality ? bound==zero : (strict ? zero<bound : zero<=bound);
+    if (!holds) {
+      conflictFromBounds(lit, 0);
+    }
+    return;
+  }
+
+  unsigned var;
+  Rational factor;
+  getVar(p, var, factor);
+
+  DeltaRational val(bound/factor, zero);
+  if (equality) {
+    assertBound(var, true, val, lit);
+    if (!_conflict) {
+      assertBound(var, false, val, lit);
+    }
+    return;
+  }
+  // dividing by a negative factor turns an upper bound into a lower one
+  bool upper = factor>zero;
+  if (strict) {
+    val.d = upper ? -one : one;
+  }
+  assertBound(var, upper, val, lit);
+}
+
+/**
+ * Return in @b var the variable and in @b factor the number such that
+ * the linear part of @b p is @b factor times @b var
+ *
+ * The linear part is divided by its leading coefficient, or for integers by
+ * the greatest common divisor of the coefficients with the sign of the
+ * leading one, so that the slack variable stays integral and is shared by
+ * all the multiples of the same linear part.
+ */
+void LinearArithmeticDP::getVar(const Polynomial& p, unsigned& var, Rational& factor)
+{
+  CALL("LinearArithmeticDP::getVar");
+
+  const Polynomial::MonomialStack& monomials = p.monomials();
+  bool integer = p.sort()==Sorts::SRT_INTEGER;
+
+  if (monomials.size()==1) {
+    var = atomVar(monomials[0].atom, integer);
+    factor = monomials[0].coeff;
+    return;
+  }
+
+  Rational zero(IntegerConstantType(0));
+  if (integer) {
+    IntegerConstantType gcd = monomials[0].coeff.numerator();
+    for (unsigned i=1; i<monomials.size(); i++) {
+      gcd = IntegerConstantType::gcd(gcd, monomials[i].coeff.numerator());
+    }
+    if (gcd<IntegerConstantType(0)) {
+      gcd = -gcd;
+    }
+    factor = Rational(gcd);
+    if (monomials[0].coeff<zero) {
+      factor = -factor;
+    }
+  }
+  else {
+    factor = monomials[0].coeff;
+  }
+
+  static Polynomial::MonomialStack scaled;
+  scaled.reset();
+  Polynomial::MonomialStack::BottomFirstIterator mit(monomials);
+  while (mit.hasNext()) {
+    const Polynomial::Monomial& m = mit.next();
+    scaled.push(Polynomial::Monomial(m.coeff/factor, m.atom));
+  }
+  TermList key = Polynomial::sum(p.sort(), scaled, zero);
+
+  unsigned* slack;
+  if (!_slackVars.getValuePtr(key, slack)) {
+    var = *slack;
+    return;
+  }
+  RSTAT_CTR_INC("linear arithmetic dp slack variables");
+
+  // the row of the slack variable has to be expressed in the
+  // non-basic variables
+  Row* row = new Row();
+  static Stack<Entry> entries;
+  Polynomial::MonomialStack::BottomFirstIterator sit(scaled);
+  while (sit.hasNext()) {
+    const Polynomial::Monomial& m = sit.next();
+    unsigned atom = atomVar(m.atom, integer);
+    int atomRow = _vars[atom]->row;
+    if (atomRow>=0) {
+      addMultiple(row, _rows[atomRow]->entries, m.coeff, UINT_MAX);
+    }
+    else {
+      entries.reset();
+      entries.push(Entry(atom, m.coeff));
+      addMultiple(row, entries, Rational(IntegerConstantType(1)), UINT_MAX);
+    }
+  }
+
+  *slack = addVar(integer);
+  var = *slack;
+  Var* v = _vars[var];
+  row->basic = var;
+  Stack<Entry>::BottomFirstIterator eit(row->entries);
+  while (eit.hasNext()) {
+    const Entry& e = eit.next();
+    v->value = v->value + _vars[e.var]->value*e.coeff;
+  }
+  v->row = _rows.size();
+  _rows.push(row);
+}
+
+unsigned LinearArithmeticDP::addVar(bool integer)
+{
+  CALL("LinearArithmeticDP::addVar");
+
+  Var* v = new Var();
+  v->row = -1;
+  v->integer = integer;
+  _vars.push(v);
+  return _vars.size()-1;
+}
+
+unsigned LinearArithmeticDP::atomVar(TermList atom, bool integer)
+{
+  CALL("LinearArithmeticDP::atomVar");
+
+  unsigned* var;
+  if (_atomVars.getValuePtr(atom, var)) {
+    *var = addVar(integer);
+  }
+  return *var;
+}
+
+/**
+ * Round the bound @b val of an integer variable to an integer
+ */
+LinearArithmeticDP::DeltaRational LinearArithmeticDP::roundToInteger(const DeltaRational& val, bool upper)
+{
+  CALL("LinearArithmeticDP::roundToInteger");
+
+  Rational zero(IntegerConstantType(0));
+  Rational one(IntegerConstantType(1));
+  if (upper) {
+    return DeltaRational(val.d<zero ? val.r.ceiling()-one : val.r.floor(), zero);
+  }
+  return DeltaRational(val.d>zero ? val.r.floor()+one : val.r.ceiling(), zero);
+}
+
+/**
+ * Assert the bound @b val (an upper bound if @b upper) on @b var
+ * because of the literal @b reason
+ */
+void LinearArithmeticDP::assertBound(unsigned var, bool upper, const DeltaRational& val, Literal* reason)
+{
+  CALL("LinearArithmeticDP::assertBound");
+
+  Var* v = _vars[var];
+  DeltaRational b = v->integer ? roundToInteger(val, upper) : val;
+  Bound& same = upper ? v->upper : v->lower;
+  Bound& other = upper ? v->lower : v->upper;
+
+  if (same.isSet() && !(upper ? b<same.val : b>same.val)) {
+    return;
+  }
+  if (other.isSet() && (upper ? b<other.val : b>other.val)) {
+    conflictFromBounds(reason, other.reason);
+    return;
+  }
+  _trail.push(TrailEntry(var, upper, same));
+  same = Bound(b, reason);
+  if (v->row<0 && (upper ? b<v->value : b>v->value)) {
+    update(var, b);
+  }
+}
+
+void LinearArithmeticDP::conflictFromBounds(Literal* l1, Literal* l2)
+{
+  CALL("LinearArithmeticDP::conflictFromBounds");
+
+  _conflict = true;
+  _unsatCore.reset();
+  _unsatCore.push(l1);
+  if (l2 && l2!=l1) {
+    _unsatCore.push(l2);
+  }
+}
+
+DecisionProcedure::Status LinearArithmeticDP::getStatus(bool getMultipleCores)
+{
+  CALL("LinearArithmeticDP::getStatus");
+
+  if (_conflict) {
+    return UNSATISFIABLE;
+  }
+  _unsatCore.reset();
+  if (!check()) {
+    return UNSATISFIABLE;
+  }
+  return _incomplete ? UNKNOWN : SATISFIABLE;
+}
+
+void LinearArithmeticDP::getUnsatCore(LiteralStack& res, unsigned coreIndex)
+{
+  CALL("LinearArithmeticDP::getUnsatCore");
+  ASS(res.isEmpty());
+  ASS_EQ(coreIndex, 0);
+  ASS(_unsatCore.isNonEmpty());
+
+  res = _unsatCore;
+}
+
+/**
+ * Fix the basic variables violating their bounds by pivoting, choosing the
+ * variables by Bland's rule (the smallest one first) to ensure termination.
+ * Return false and save the unsat core if the bounds are inconsistent.
+ */
+bool LinearArithmeticDP::check()
+{
+  CALL("LinearArithmeticDP::check");
+
+  for (;;) {
+    Row* viol = 0;
+    bool belowLower = false;
+    Stack<Row*>::Iterator rit(_rows);
+    while (rit.hasNext()) {
+      Row* row = rit.next();
+      if (viol && viol->basic<row->basic) {
+        continue;
+      }
+      Var* v = _vars[row->basic];
+      if (v->lower.isSet() && v->value<v->lower.val) {
+        viol = row;
+        belowLower = true;
+      }
+      else if (v->upper.isSet() && v->value>v->upper.val) {
+        viol = row;
+        belowLower = false;
+      }
+    }
+    if (!viol) {
+      return true;
+    }
+    RSTAT_CTR_INC("linear arithmetic dp pivots");
+
+    Rational zero(IntegerConstantType(0));
+    int entering = -1;
+    Stack<Entry>::BottomFirstIterator eit(viol->entries);
+    while (eit.hasNext()) {
+      const Entry& e = eit.next();
+      Var* v = _vars[e.var];
+      bool canIncrease = !v->upper.isSet() || v->value<v->upper.val;
+      bool canDecrease = !v->lower.isSet() || v->value>v->lower.val;
+      // the basic variable has to move up if it is below its lower bound
+      bool increase = (e.coeff>zero)==belowLower;
+      if (increase ? canIncrease : canDecrease) {
+        entering = e.var;
+        break;
+      }
+    }
+    if (entering<0) {
+      explainRow(viol, belowLower);
+      return false;
+    }
+    Var* basic = _vars[viol->basic];
+    pivotAndUpdate(viol->basic, entering, belowLower ? basic->lower.val : basic->upper.val);
+  }
+}
+
+/**
+ * Save into _unsatCore the bounds making it impossible to satisfy
+ * the violated bound of the basic variable of @b row
+ */
+void LinearArithmeticDP::explainRow(Row* row, bool belowLower)
+{
+  CALL("LinearArithmeticDP::explainRow");
+
+  Rational zero(IntegerConstantType(0));
+
+  static DHSet<Literal*> seen;
+  seen.reset();
+  _unsatCore.reset();
+
+  Var* basic = _vars[row->basic];
+  Literal* reason = belowLower ? basic->lower.reason : basic->upper.reason;
+  seen.insert(reason);
+  _unsatCore.push(reason);
+
+  Stack<Entry>::BottomFirstIterator eit(row->entries);
+  while (eit.hasNext()) {
+    const Entry& e = eit.next();
+    Var* v = _vars[e.var];
+    bool atUpper = (e.coeff>zero)==belowLower;
+    reason = atUpper ? v->upper.reason : v->lower.reason;
+    ASS(reason);
+    if (seen.insert(reason)) {
+      _unsatCore.push(reason);
+    }
+  }
+}
+
+/**
+ * Set the value of the non-basic variable @b var to @b val and
+ * update the basic variables accordingly
+ */
+void LinearArithmeticDP::update(unsigned var, const DeltaRational& val)
+{
+  CALL("LinearArithmeticDP::update");
+  ASS_L(_vars[var]->row, 0);
+
+  DeltaRational diff = val-_vars[var]->value;
+  Rational coeff;
+  Stack<Row*>::Iterator rit(_rows);
+  while (rit.hasNext()) {
+    Row* row = rit.next();
+    if (getCoeff(row, var, coeff)) {
+      Var* b = _vars[row->basic];
+      b->value = b->value + diff*coeff;
+    }
+  }
+  _vars[var]->value = val;
+}
+
+/**
+ * Set the value of the basic variable @b basic to @b val by changing the
+ * non-basic variable @b nonbasic and swap the two
+ */
+void LinearArithmeticDP::pivotAndUpdate(unsigned basic, unsigned nonbasic, const DeltaRational& val)
+{
+  CALL("LinearArithmeticDP::pivotAndUpdate");
+
+  unsigned rowIdx = _vars[basic]->row;
+  Rational coeff;
+  ALWAYS(getCoeff(_rows[rowIdx], nonbasic, coeff));
+
+  Rational one(IntegerConstantType(1));
+  DeltaRational theta = (val-_vars[basic]->value)*(one/coeff);
+  _vars[basic]->value = val;
+  _vars[nonbasic]->value = _vars[nonbasic]->value + theta;
+  for (unsigned i=0; i<_rows.size(); i++) {
+    if (i!=rowIdx && getCoeff(_rows[i], nonbasic, coeff)) {
+      Var* b = _vars[_rows[i]->basic];
+      b->value = b->value + theta*coeff;
+    }
+  }
+  pivot(rowIdx, nonbasic);
+}
+
+/**
+ * Make @b nonbasic the basic variable of the row @b rowIdx and
+ * eliminate it from the other rows
+ */
+void LinearArithmeticDP::pivot(unsigned rowIdx, unsigned nonbasic)
+{
+  CALL("LinearArithmeticDP::pivot");
+
+  Row* row = _rows[rowIdx];
+  unsigned basic = row->basic;
+  Rational coeff;
+  ALWAYS(getCoeff(row, nonbasic, coeff));
+  Rational one(IntegerConstantType(1));
+  Rational inv = one/coeff;
+
+  // basic = coeff*nonbasic + rest gives nonbasic = inv*basic - inv*rest
+  static Stack<Entry> entries;
+  entries.reset();
+  entries.push(Entry(basic, inv));
+  Row* solved = new Row();
+  addMultiple(solved, entries, one, UINT_MAX);
+  addMultiple(solved, row->entries, -inv, nonbasic);
+  solved->basic = nonbasic;
+  _rows[rowIdx] = solved;
+  delete row;
+
+  _vars[nonbasic]->row = rowIdx;
+  _vars[basic]->row = -1;
+
+  for (unsigned i=0; i<_rows.size(); i++) {
+    if (i!=rowIdx && getCoeff(_rows[i], nonbasic, coeff)) {
+      addMultiple(_rows[i], solved->entries, coeff, nonbasic);
+    }
+  }
+}
+
+bool LinearArithmeticDP::getCoeff(const Row* row, unsigned var, Rational& res)
+{
+  CALL("LinearArithmeticDP::getCoeff");
+
+  Stack<Entry>::ConstIterator eit(row->entries);
+  while (eit.hasNext()) {
+    const Entry& e = eit.next();
+    if (e.var==var) {
+      res = e.coeff;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Add @b factor times @b entries to the entries of @b row, leaving
+ * out the variable @b skip
+ */
+void LinearArithmeticDP::addMultiple(Row* row, const Stack<Entry>& entries, const Rational& factor, unsigned skip)
+{
+  CALL("LinearArithmeticDP::addMultiple");
+
+  Rational zero(IntegerConstantType(0));
+
+  static Stack<Entry> res;
+  res.reset();
+  unsigned i = 0;
+  unsigned j = 0;
+  unsigned len1 = row->entries.size();
+  unsigned len2 = entries.size();
+  while (i<len1 || j<len2) {
+    if (j==len2 || (i<len1 && row->entries[i].var<entries[j].var)) {
+      if (row->entries[i].var!=skip) {
+        res.push(row->entries[i]);
+      }
+      i++;
+    }
+    else if (i==len1 || entries[j].var<row->entries[i].var) {
+      if (entries[j].var!=skip) {
+        res.push(Entry(entries[j].var, entries[j].coeff*factor));
+      }
+      j++;
+    }
+    else {
+      Rational sum = row->entries[i].coeff+entries[j].coeff*factor;
+      if (row->entries[i].var!=skip && sum!=zero) {
+        res.push(Entry(row->entries[i].var, sum));
+      }
+      i++;
+      j++;
+    }
+  }
+  row->entries = res;
+}
+
+}
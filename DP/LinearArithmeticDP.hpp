@@ -0,0 +1,209 @@
+
+/*
+ * File LinearArithmeticDP.hpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file LinearArithmeticDP.hpp
+ * Defines class LinearArithmeticDP.
+ */
+
+#ifndef __LinearArithmeticDP__
+#define __LinearArithmeticDP__
+
+#include "Forwards.hpp"
+
+#include "Lib/DHMap.hpp"
+#include "Lib/Stack.hpp"
+
+#include "Kernel/Polynomial.hpp"
+#include "Kernel/Term.hpp"
+#include "Kernel/Theory.hpp"
+
+#include "DecisionProcedure.hpp"
+
+namespace DP {
+
+using namespace Lib;
+using namespace Kernel;
+
+/**
+ * Decision procedure for ground linear arithmetic literals, the simplex
+ * variant of Dutertre and de Moura (2006) "A Fast Linear-Arithmetic Solver
+ * for DPLL(T)".
+ *
+ * Each ground inequality or equality of integers, rationals or reals is
+ * brought into the polynomial normal form of Kernel::Polynomial and
+ * becomes a bound on a tableau variable: on the atom itself if the
+ * polynomial has a single monomial, otherwise on a slack variable defined
+ * by a row of the tableau, shared by all the literals with the same
+ * linear part. Strict bounds use infinitesimals. Literals of other kinds,
+ * including disequalities, are ignored.
+ *
+ * Integers are only handled by their rational relaxation, in which bounds
+ * on integer combinations are rounded to integers, so unsatisfiability is
+ * exact while satisfiability of integer constraints is reported as UNKNOWN.
+ *
+ * Bounds are asserted incrementally and undone on pop() from a trail; the
+ * tableau and the assignment are never undone, as pivoting keeps them
+ * valid for any set of bounds. A conflict is explained by the reasons of
+ * the bounds of one row, which gives a single unsat core.
+ */
+class LinearArithmeticDP : public DecisionProcedure
+{
+public:
+  CLASS_NAME(LinearArithmeticDP);
+  USE_ALLOCATOR(LinearArithmeticDP);
+
+  LinearArithmeticDP();
+  ~LinearArithmeticDP();
+
+  virtual void addLiterals(LiteralIterator lits, bool onlyEqualites) override;
+
+  virtual Status getStatus(bool getMultipleCores) override;
+  virtual unsigned getUnsatCoreCount() override { return _unsatCore.isEmpty() ? 0 : 1; }
+  virtual void getUnsatCore(LiteralStack& res, unsigned coreIndex) override;
+
+  /** Arithmetic does not contribute to the equality models of AVATAR */
+  void getModel(LiteralStack& model) override {}
+
+  virtual void reset() override;
+
+  virtual void push() override;
+  virtual void pop(unsigned levelCnt=1) override;
+  virtual unsigned level() const override { return _levels.size(); }
+
+private:
+  typedef RationalConstantType Rational;
+
+  /** The number r + d*delta for an infinitesimal delta */
+  struct DeltaRational
+  {
+    DeltaRational() : r(IntegerConstantType(0)), d(IntegerConstantType(0)) {}
+    DeltaRational(const Rational& r, const Rational& d) : r(r), d(d) {}
+
+    DeltaRational operator+(const DeltaRational& o) const { return DeltaRational(r+o.r, d+o.d); }
+    DeltaRational operator-(const DeltaRational& o) const { return DeltaRational(r-o.r, d-o.d); }
+    DeltaRational operator*(const Rational& c) const { return DeltaRational(r*c, d*c); }
+    bool operator<(const DeltaRational& o) const { return r<o.r || (r==o.r && d<o.d); }
+    bool operator>(const DeltaRational& o) const { return o<*this; }
+
+    Rational r;
+    Rational d;
+  };
+
+  struct Bound
+  {
+    Bound() : reason(0) {}
+    Bound(const DeltaRational& val, Literal* reason) : val(val), reason(reason) {}
+
+    bool isSet() const { return reason; }
+
+    DeltaRational val;
+    /** the literal implying the bound, zero if there is no bound */
+    Literal* reason;
+  };
+
+  struct Var
+  {
+    CLASS_NAME(LinearArithmeticDP::Var);
+    USE_ALLOCATOR(LinearArithmeticDP::Var);
+
+    Bound lower;
+    Bound upper;
+    DeltaRational value;
+    /** the row defining the variable, -1 if the variable is not basic */
+    int row;
+    bool integer;
+  };
+
+  struct Entry
+  {
+    Entry() {}
+    Entry(unsigned var, const Rational& coeff) : var(var), coeff(coeff) {}
+
+    unsigned var;
+    Rational coeff;
+  };
+  /** Row of the tableau, the basic variable is the sum of the entries ordered by their variables */
+  struct Row
+  {
+    CLASS_NAME(LinearArithmeticDP::Row);
+    USE_ALLOCATOR(LinearArithmeticDP::Row);
+
+    unsigned basic;
+    Stack<Entry> entries;
+  };
+
+  /** A change of a bound, to be undone on pop() */
+  struct TrailEntry
+  {
+    TrailEntry() {}
+    TrailEntry(unsigned var, bool upper, const Bound& old) : var(var), upper(upper), old(old) {}
+
+    unsigned var;
+    bool upper;
+    Bound old;
+  };
+
+  struct LevelInfo
+  {
+    unsigned trailSize;
+    bool conflict;
+    bool incomplete;
+  };
+
+  void addLiteral(Literal* lit);
+  void getVar(const Polynomial& p, unsigned& var, Rational& factor);
+  unsigned addVar(bool integer);
+  unsigned atomVar(TermList atom, bool integer);
+
+  static DeltaRational roundToInteger(const DeltaRational& val, bool upper);
+  void assertBound(unsigned var, bool upper, const DeltaRational& val, Literal* reason);
+  void conflictFromBounds(Literal* l1, Literal* l2);
+
+  bool check();
+  void explainRow(Row* row, bool belowLower);
+  void update(unsigned var, const DeltaRational& val);
+  void pivotAndUpdate(unsigned basic, unsigned nonbasic, const DeltaRational& val);
+  void pivot(unsigned rowIdx, unsigned nonbasic);
+  static bool getCoeff(const Row* row, unsigned var, Rational& res);
+  static void addMultiple(Row* row, const Stack<Entry>& entries, const Rational& factor, unsigned skip);
+
+  Stack<Var*> _vars;
+  Stack<Row*> _rows;
+
+  /** variables of the atoms (the non-linear terms) */
+  DHMap<TermList, unsigned> _atomVars;
+  /** slack variables of the linear parts of polynomials, normalized as in getVar() */
+  DHMap<TermList, unsigned> _slackVars;
+
+  PolynomialCache _polynomials;
+
+  Stack<TrailEntry> _trail;
+  Stack<LevelInfo> _levels;
+
+  /** a bound conflict was found while adding literals at the current level */
+  bool _conflict;
+  /** some of the added literals were ignored or are on integers */
+  bool _incomplete;
+
+  LiteralStack _unsatCore;
+};
+
+}
+
+#endif // __LinearArithmeticDP__
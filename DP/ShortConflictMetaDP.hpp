@@ -63,6 +63,19 @@ public:
     _unsatCores.reset();
   }
 
+  virtual void push() override {
+    CALL("ShortConflictMetaDP::push");
+    _inner->push();
+  }
+
+  virtual void pop(unsigned levelCnt=1) override {
+    CALL("ShortConflictMetaDP::pop");
+    _inner->pop(levelCnt);
+    _unsatCores.reset();
+  }
+
+  virtual unsigned level() const override { return _inner->level(); }
+
   virtual Status getStatus(bool getMultipleCores) override;
 
   void getModel(LiteralStack& model) override {
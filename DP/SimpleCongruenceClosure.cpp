@@ -91,6 +91,7 @@ void SimpleCongruenceClosure::ConstInfo::init() {
   term.makeEmpty();
   lit = 0;
   namedPair = CPair(0,0);
+  registered = false;
   reprConst = 0;
   proofPredecessor = 0;
   predecessorPremise = CEq(0,0);
@@ -98,36 +99,6 @@ void SimpleCongruenceClosure::ConstInfo::init() {
   useList.reset();
 }
 
-void SimpleCongruenceClosure::ConstInfo::resetEquivalences(SimpleCongruenceClosure& parent, unsigned selfIndex) {
-  CALL("SimpleCongruenceClosure::ConstInfo::resetEquivalences");
-
-  reprConst = 0;
-  proofPredecessor = 0;
-  predecessorPremise = CEq(0,0);
-  classList.reset();
-
-  static ArraySet seen;
-  seen.ensure(parent.getMaxConst()+1);
-  seen.reset();
-
-  Stack<unsigned>::DelIterator ulit(useList);
-  // Martin: keep only those namedPairs in useList for which selfIndex
-  // is one of the arguments, and keep each such exactly once
-  while(ulit.hasNext()) {
-    unsigned p = ulit.next();
-    ConstInfo& pInfo = parent._cInfos[p];
-    if(pInfo.namedPair.first!=selfIndex && pInfo.namedPair.second!=selfIndex) {
-      ulit.del();
-      continue;
-    }
-    if(seen.find(p)) {
-      ulit.del();
-      continue;
-    }
-    seen.insert(p);
-  }
-}
-
 #ifdef VDEBUG
 
 void SimpleCongruenceClosure::ConstInfo::assertValid(SimpleCongruenceClosure& parent, unsigned selfIndex) const
@@ -161,50 +132,20 @@ SimpleCongruenceClosure::SimpleCongruenceClosure(Ordering* ord) :
   _posLitConst = getFreshConst();
   _negLitConst = getFreshConst();
   _negEqualities.push(CEq(_posLitConst, _negLitConst, 0));
-
-  _hadPropagated = false;
 }
 
 void SimpleCongruenceClosure::reset()
 {
   CALL("SimpleCongruenceClosure::reset");
 
-#if 0
-  _cInfos.expand(1);
-  _sigConsts.reset();
-  _pairNames.reset();
-  _termNames.reset();
-  _litNames.reset();
-
-  _negEqualities.reset();
-  _posLitConst = getFreshConst();
-  _negLitConst = getFreshConst();
-  _negEqualities.push(CEq(_posLitConst, _negLitConst, 0));
-
-#else
-  //do reset that keeps the data for converting terms to constants
-
-  unsigned maxConst = getMaxConst();
-  for(unsigned i=1; i<=maxConst; i++) {
-    _cInfos[i].resetEquivalences(*this, i);
-  }
-
-  PairMap::DelIterator pmit(_pairNames);
-  while(pmit.hasNext()) {
-    CPair namePair;
-    unsigned nameConst;
-    pmit.next(namePair, nameConst);
-
-    if(_cInfos[nameConst].namedPair!=namePair) {
-      pmit.del();
-    }
-  }
+  //the reset keeps the data for converting terms to constants
+  undoTrail(0);
+  _levels.reset();
 
   //this leaves us just with the true!=false non-equality
   _negEqualities.truncate(1);
   ASS_EQ(_negEqualities.top().c1,_posLitConst);
   ASS_EQ(_negEqualities.top().c2,_negLitConst);
-#endif
 
   //no unsat non-equality
   _unsatEqs.reset();
@@ -212,8 +153,89 @@ void SimpleCongruenceClosure::reset()
   _pendingEqualities.reset();
   _distinctConstraints.reset();
   _negDistinctConstraints.reset();
+}
+
+/**
+ * Open a new backtracking level.
+ *
+ * Pending equalities are propagated first, so that they
+ * belong to the current level rather than to the new one.
+ */
+void SimpleCongruenceClosure::push()
+{
+  CALL("SimpleCongruenceClosure::push");
+
+  propagate();
+
+  LevelInfo li;
+  li.trailSize = _trail.size();
+  li.negEqualitiesSize = _negEqualities.size();
+  li.distinctSize = _distinctConstraints.size();
+  li.negDistinctSize = _negDistinctConstraints.size();
+  _levels.push(li);
+}
+
+/**
+ * Undo all the changes done since the @c levelCnt most recent calls to push().
+ */
+void SimpleCongruenceClosure::pop(unsigned levelCnt)
+{
+  CALL("SimpleCongruenceClosure::pop");
+  ASS_LE(levelCnt,_levels.size());
+
+  if(!levelCnt) {
+    return;
+  }
+
+  _levels.truncate(_levels.size()-levelCnt+1);
+  LevelInfo li = _levels.pop();
 
-  _hadPropagated = false;
+  //pending equalities can only come from the levels being popped
+  _pendingEqualities.reset();
+  undoTrail(li.trailSize);
+
+  _negEqualities.truncate(li.negEqualitiesSize);
+  _distinctConstraints.truncate(li.distinctSize);
+  _negDistinctConstraints.truncate(li.negDistinctSize);
+
+  _unsatEqs.reset();
+}
+
+/**
+ * Undo the changes recorded on the trail until it has @c trailSize entries.
+ */
+void SimpleCongruenceClosure::undoTrail(unsigned trailSize)
+{
+  CALL("SimpleCongruenceClosure::undoTrail");
+  ASS_LE(trailSize,_trail.size());
+
+  while(_trail.size()>trailSize) {
+    TrailEntry e = _trail.pop();
+    ConstInfo& cInfo = _cInfos[e.c];
+    switch(e.kind) {
+    case TrailEntry::SET_REPR:
+      cInfo.reprConst = e.prev;
+      break;
+    case TrailEntry::CLASS_PUSH:
+      cInfo.classList.pop();
+      break;
+    case TrailEntry::USE_PUSH:
+      cInfo.useList.pop();
+      break;
+    case TrailEntry::PAIR_INSERT:
+      ALWAYS(_pairNames.remove(e.key));
+      break;
+    case TrailEntry::PROOF_EDGE:
+      cInfo.proofPredecessor = e.prev;
+      cInfo.predecessorPremise = e.prevPremise;
+      break;
+    case TrailEntry::REGISTER:
+      ASS(cInfo.registered);
+      cInfo.registered = false;
+      _unregisteredPairs.push(e.c);
+      break;
+    }
+  }
 }
 
 /** Introduce fresh congruence closure constant */
@@ -249,29 +271,49 @@ unsigned SimpleCongruenceClosure::getPairName(CPair p)
   CALL("SimpleCongruenceClosure::getPairName");
 
   unsigned* pRes;
-  if(!_pairNames.getValuePtr(p, pRes)) {
+  if(!_rawPairNames.getValuePtr(p, pRes)) {
     return *pRes;
   }
   unsigned res = getFreshConst();
   _cInfos[res].namedPair = p;
   *pRes = res;
 
-  _cInfos[p.first].useList.push(res);
-  if(_cInfos[p.first].reprConst!=0) {
-    // Martin: if we are here, the above insertion was not needed now,
-    // but will become necessary after reset(); see resetEquivalences
-    unsigned fRepr = _cInfos[p.first].reprConst;
-    _cInfos[fRepr].useList.push(res);
+  registerPair(res);
+  return res;
+}
+
+/**
+ * Insert the pair named by @c c into the lookup table _pairNames
+ * (and into the use lists of the representatives of its arguments).
+ * If a congruent pair is there already, we only record the equality
+ * with it.
+ */
+void SimpleCongruenceClosure::registerPair(unsigned c)
+{
+  CALL("SimpleCongruenceClosure::registerPair");
+
+  ConstInfo& cInfo = _cInfos[c];
+  ASS(!cInfo.registered);
+  cInfo.registered = true;
+  _trail.push(TrailEntry(TrailEntry::REGISTER, c));
+
+  CPair derefPair = deref(cInfo.namedPair);
+  unsigned* pName;
+  if(!_pairNames.getValuePtr(derefPair, pName)) {
+    addPendingEquality(CEq(*pName, c));
+    return;
   }
-  _cInfos[p.second].useList.push(res);
-  if(_cInfos[p.second].reprConst!=0) {
-    // Martin: if we are here, the above insertion was not needed now,
-    // but will become necessary after reset(); see resetEquivalences
-    unsigned sRepr = _cInfos[p.second].reprConst;
-    _cInfos[sRepr].useList.push(res);
+  *pName = c;
+  TrailEntry ins(TrailEntry::PAIR_INSERT, c);
+  ins.key = derefPair;
+  _trail.push(ins);
+
+  _cInfos[derefPair.first].useList.push(c);
+  _trail.push(TrailEntry(TrailEntry::USE_PUSH, derefPair.first));
+  if(derefPair.second!=derefPair.first) {
+    _cInfos[derefPair.second].useList.push(c);
+    _trail.push(TrailEntry(TrailEntry::USE_PUSH, derefPair.second));
   }
-
-  return res;
 }
 
 struct SimpleCongruenceClosure::FOConversionWorker
@@ -444,7 +486,6 @@ SimpleCongruenceClosure::CEq SimpleCongruenceClosure::convertFOEquality(Literal*
 void SimpleCongruenceClosure::addLiterals(LiteralIterator lits, bool onlyEqualites)
 {
   CALL("SimpleCongruenceClosure::addLiterals");
-  ASS(!_hadPropagated);
 
   while(lits.hasNext()) {
     Literal* l = lits.next();
@@ -514,6 +555,10 @@ void SimpleCongruenceClosure::makeProofRepresentant(unsigned c)
   unsigned prevC = 0;
 
   do{
+    TrailEntry edge(TrailEntry::PROOF_EDGE, c, _cInfos[c].proofPredecessor);
+    edge.prevPremise = _cInfos[c].predecessorPremise;
+    _trail.push(edge);
+
     unsigned newC = _cInfos[c].proofPredecessor;
     _cInfos[c].proofPredecessor = prevC;
     swap(_cInfos[c].predecessorPremise, transfPrem);
@@ -532,7 +577,12 @@ void SimpleCongruenceClosure::propagate()
 {
   CALL("SimpleCongruenceClosure::propagate");
 
-  _hadPropagated = true;
+  while(_unregisteredPairs.isNonEmpty()) {
+    unsigned c = _unregisteredPairs.pop();
+    if(!_cInfos[c].registered) {
+      registerPair(c);
+    }
+  }
 
   while(_pendingEqualities.isNonEmpty()) {
     CEq curr0 = _pendingEqualities.pop_back();
@@ -553,6 +603,9 @@ void SimpleCongruenceClosure::propagate()
       makeProofRepresentant(aProofRep);
       ConstInfo& aProofInfo = _cInfos[aProofRep];
       ASS_EQ(aProofInfo.proofPredecessor,0);
+      TrailEntry edge(TrailEntry::PROOF_EDGE, aProofRep, 0);
+      edge.prevPremise = aProofInfo.predecessorPremise;
+      _trail.push(edge);
       aProofInfo.proofPredecessor = bProofRep;
       aProofInfo.predecessorPremise = curr0;
     }
@@ -573,11 +626,15 @@ void SimpleCongruenceClosure::propagate()
     // To do this we update the representative for all constants in
     // the class of aRep to be bRep
     aInfo.reprConst = bRep;
+    _trail.push(TrailEntry(TrailEntry::SET_REPR, aRep, 0));
     bInfo.classList.push(aRep);
+    _trail.push(TrailEntry(TrailEntry::CLASS_PUSH, bRep));
     Stack<unsigned>::Iterator aChildIt(aInfo.classList);
     while(aChildIt.hasNext()) {
       unsigned aChild = aChildIt.next();
       bInfo.classList.push(aChild);
+      _trail.push(TrailEntry(TrailEntry::CLASS_PUSH, bRep));
+      _trail.push(TrailEntry(TrailEntry::SET_REPR, aChild, _cInfos[aChild].reprConst));
       _cInfos[aChild].reprConst = bRep;
     }
     // Now update all places where aRep has been used as a
@@ -596,7 +653,11 @@ void SimpleCongruenceClosure::propagate()
       }
       else {
 	*pDerefPairName = usePairConst;
+	TrailEntry ins(TrailEntry::PAIR_INSERT, usePairConst);
+	ins.key = derefPair;
+	_trail.push(ins);
 	bInfo.useList.push(usePairConst);
+	_trail.push(TrailEntry(TrailEntry::USE_PUSH, bRep));
       }
     }
   }
@@ -680,6 +741,8 @@ DecisionProcedure::Status SimpleCongruenceClosure::getStatus(bool retrieveMultip
 {
   CALL("SimpleCongruenceClosure::getStatus");
 
+  _unsatEqs.reset();
+
   // Propagate any pending equalities
   propagate();
 
@@ -53,6 +53,14 @@ using namespace Kernel;
  * 
  * However, classList of a representative 
  * does not (physically) contain that representative (only logically)
+ *
+ * The procedure is incremental and backtrackable: push() opens a new level
+ * and every change the propagation makes to the union-find, the use lists,
+ * the lookup table and the proof forest is recorded on a trail, so that pop()
+ * can undo it in time proportional to the work done since the push.
+ * The conversion of terms to constants (_termNames, _rawPairNames) is never
+ * undone; pairs named at a popped level are just re-registered in the lookup
+ * table at the next propagation.
  */
 class SimpleCongruenceClosure : public DecisionProcedure
 {
@@ -72,6 +80,10 @@ public:
   
   virtual void reset() override;
 
+  virtual void push() override;
+  virtual void pop(unsigned levelCnt=1) override;
+  virtual unsigned level() const override { return _levels.size(); }
+
   /**
    * New, more fine-grained way of insertion. The terms may contain variables which are treated as constants.
    */
@@ -172,6 +184,7 @@ private:
 
   void addPendingEquality(CEq eq);
   void makeProofRepresentant(unsigned c);
+  void registerPair(unsigned c);
   void propagate();
 
   unsigned getProofDepth(unsigned c);
@@ -181,7 +194,6 @@ private:
   struct ConstInfo
   {
     void init();
-    void resetEquivalences(SimpleCongruenceClosure& parent, unsigned selfIndex);
 
 #ifdef VDEBUG
     void assertValid(SimpleCongruenceClosure& parent, unsigned selfIndex) const;
@@ -196,6 +208,11 @@ private:
     Literal* lit;
     /** (0,0) means the constant doesn't name a pair */
     CPair namedPair;
+    /**
+     * Meaningful for namedPairs. True if the pair is present in the lookup
+     * table _pairNames (possibly via a congruent pair).
+     */
+    bool registered;
 
     /** 0 means the symbol is its own representative */
     unsigned reprConst;
@@ -280,6 +297,51 @@ private:
   typedef DHMap<CPair,unsigned> PairMap;
   /** Names of constant pairs (modulo the congruence!)*/
   PairMap _pairNames;
+  /** Names of constant pairs as they were created by the term conversion */
+  PairMap _rawPairNames;
+  /** Pairs which have to be registered in _pairNames before the next propagation */
+  Stack<unsigned> _unregisteredPairs;
+
+  /**
+   * Record of a single change done by propagation, so that it can be undone on pop()
+   */
+  struct TrailEntry
+  {
+    enum Kind {
+      /** reprConst of c was set, old value in prev */
+      SET_REPR,
+      /** c's classList was pushed to */
+      CLASS_PUSH,
+      /** c's useList was pushed to */
+      USE_PUSH,
+      /** key was inserted into _pairNames */
+      PAIR_INSERT,
+      /** c's proof predecessor was changed, old value in prev and prevPremise */
+      PROOF_EDGE,
+      /** pair c was registered in _pairNames */
+      REGISTER
+    };
+    TrailEntry(Kind kind, unsigned c, unsigned prev=0) : kind(kind), c(c), prev(prev) {}
+
+    Kind kind;
+    unsigned c;
+    unsigned prev;
+    CPair key;
+    CEq prevPremise;
+  };
+  Stack<TrailEntry> _trail;
+
+  /** Sizes of the backtrackable stacks at the moment of a push() */
+  struct LevelInfo
+  {
+    unsigned trailSize;
+    unsigned negEqualitiesSize;
+    unsigned distinctSize;
+    unsigned negDistinctSize;
+  };
+  Stack<LevelInfo> _levels;
+
+  void undoTrail(unsigned trailSize);
 
   /** Constants corresponding to terms */
   DHMap<TermList,unsigned> _termNames;
@@ -307,12 +369,6 @@ private:
    * http://www.cs.miami.edu/~tptp/TPTP/SyntaxBNF.html
    * "It can be used only as a fact, not under any connective." */  
   DistinctStack _negDistinctConstraints;
-
-  /**
-   * used to assert we don't add literals after propagation.
-   * this would cause problems with term caches upon reset.
-   */
-  bool _hadPropagated;
 }; // class SimpleCongruenceClosure
 
 }
@@ -26,8 +26,11 @@
 #include "Kernel/Signature.hpp"
 #include "Kernel/SortHelper.hpp"
 
+#include "Debug/RuntimeStatistics.hpp"
+
 #include "Lib/Backtrackable.hpp"
 #include "Lib/Environment.hpp"
+#include "Lib/Sort.hpp"
 #include "Lib/Stack.hpp"
 
 #include "AcyclicityIndex.hpp"
@@ -151,6 +154,414 @@ namespace Indexing
     List<TermList>* subterms;
   };
 
+  /**
+   * An over-approximation of the search done by CycleSearchIterator for
+   * the entries of one sort, used to skip queries that cannot find a cycle.
+   *
+   * A node stands for a possible top symbol of the non-constructor side t
+   * of an entry: there is a node for each function symbol, the node
+   * VAR_NODE for variables and the node ANY_NODE, which has an edge to the
+   * node of every entry. An entry adds an edge from the node of t to the
+   * nodes that the left-hand sides its subterms unify with can have: for a
+   * variable subterm to ANY_NODE, for any other to VAR_NODE and, if it is
+   * not a constructor term, also to the node of its top symbol. Every cycle
+   * the search can find is then a cycle of this graph going through the
+   * node of the query.
+   *
+   * Strongly connected components are contracted as soon as they appear,
+   * so the query is just a lookup. The components are kept in a
+   * topological order, which is updated on an edge insertion by the
+   * algorithm of Pearce and Kelly, only visiting the components ordered
+   * between the two ends of the edge. A removal cannot invalidate the
+   * order, so edges are removed lazily by decreasing their multiplicity.
+   * Components that might not be cyclic any more are only split by
+   * rebuilding the graph, once there were more removals than there are
+   * edges left.
+   */
+  class AcyclicityIndex::SubtermGraph
+  {
+  public:
+    CLASS_NAME(AcyclicityIndex::SubtermGraph);
+    USE_ALLOCATOR(AcyclicityIndex::SubtermGraph);
+
+    SubtermGraph() : _nextOrd(0), _liveEdges(0), _removedEdges(0)
+    {
+      addNode(); // VAR_NODE
+      addNode(); // ANY_NODE
+    }
+
+    ~SubtermGraph()
+    {
+      Stack<Node*>::Iterator it(_nodes);
+      while (it.hasNext()) {
+        delete it.next();
+      }
+    }
+
+    void addEntry(IndexEntry* entry) { updateEntry(entry, 1); }
+    void removeEntry(IndexEntry* entry) { updateEntry(entry, -1); }
+
+    /** False if the search for a cycle through @b entry cannot succeed */
+    bool mayHaveCycle(IndexEntry* entry)
+    {
+      CALL("AcyclicityIndex::SubtermGraph::mayHaveCycle");
+
+      return _nodes[find(termNode(entry->t))]->cyclic;
+    }
+
+  private:
+    static const unsigned VAR_NODE = 0;
+    static const unsigned ANY_NODE = 1;
+
+    struct Node
+    {
+      CLASS_NAME(AcyclicityIndex::SubtermGraph::Node);
+      USE_ALLOCATOR(AcyclicityIndex::SubtermGraph::Node);
+
+      /** union-find parent, the node itself for the representative of a component */
+      unsigned parent;
+      /** position of the component in the topological order, if a representative */
+      unsigned ord;
+      /** the component contains a cycle, if a representative */
+      bool cyclic;
+      bool forward;
+      bool backward;
+      /** nodes of the component, if a representative */
+      Stack<unsigned> members;
+      /** ends of the edges that were ever added, including removed ones */
+      Stack<unsigned> out;
+      Stack<unsigned> in;
+    };
+
+    /** Orders pairs of a position in the topological order and a representative by the position */
+    struct OrdComparator
+    {
+      static Comparison compare(const pair<unsigned,unsigned>& a, const pair<unsigned,unsigned>& b)
+      {
+        return DefaultComparator::compare(a.first, b.first);
+      }
+    };
+
+    /** Sort the representatives @b nodes by their position in the topological order */
+    void sortByOrd(Stack<unsigned>& nodes)
+    {
+      CALL("AcyclicityIndex::SubtermGraph::sortByOrd");
+
+      static Stack<pair<unsigned,unsigned> > byOrd;
+      byOrd.reset();
+      for (unsigned i=0; i<nodes.size(); i++) {
+        byOrd.push(make_pair(_nodes[nodes[i]]->ord, nodes[i]));
+      }
+      sort<OrdComparator>(byOrd.begin(), byOrd.end());
+      for (unsigned i=0; i<nodes.size(); i++) {
+        nodes[i] = byOrd[i].second;
+      }
+    }
+
+    unsigned addNode()
+    {
+      unsigned n = _nodes.size();
+      Node* node = new Node();
+      node->parent = n;
+      node->ord = _nextOrd++;
+      node->cyclic = false;
+      node->forward = false;
+      node->backward = false;
+      node->members.push(n);
+      _nodes.push(node);
+      return n;
+    }
+
+    unsigned termNode(TermList t)
+    {
+      if (t.isVar()) {
+        return VAR_NODE;
+      }
+      unsigned* node;
+      if (_functorNodes.getValuePtr(t.term()->functor(), node)) {
+        *node = addNode();
+      }
+      return *node;
+    }
+
+    unsigned find(unsigned n)
+    {
+      unsigned root = n;
+      while (_nodes[root]->parent != root) {
+        root = _nodes[root]->parent;
+      }
+      while (_nodes[n]->parent != root) {
+        unsigned next = _nodes[n]->parent;
+        _nodes[n]->parent = root;
+        n = next;
+      }
+      return root;
+    }
+
+    bool isLive(unsigned from, unsigned to)
+    {
+      return _edges.get(make_pair(from, to)) > 0;
+    }
+
+    void updateEntry(IndexEntry* entry, int delta)
+    {
+      CALL("AcyclicityIndex::SubtermGraph::updateEntry");
+
+      unsigned n = termNode(entry->t);
+      updateEdge(ANY_NODE, n, delta);
+
+      List<TermList>::Iterator it(entry->subterms);
+      while (it.hasNext()) {
+        TermList s = it.next();
+        if (s.isVar()) {
+          updateEdge(n, ANY_NODE, delta);
+          continue;
+        }
+        updateEdge(n, VAR_NODE, delta);
+        if (!env.signature->getFunction(s.term()->functor())->termAlgebraCons()) {
+          updateEdge(n, termNode(s), delta);
+        }
+      }
+    }
+
+    void updateEdge(unsigned from, unsigned to, int delta)
+    {
+      CALL("AcyclicityIndex::SubtermGraph::updateEdge");
+
+      unsigned* cnt;
+      if (_edges.getValuePtr(make_pair(from, to), cnt, 0)) {
+        _nodes[from]->out.push(to);
+        _nodes[to]->in.push(from);
+      }
+      if (delta > 0) {
+        if ((*cnt)++ == 0) {
+          _liveEdges++;
+          link(from, to);
+        }
+        return;
+      }
+      ASS_G(*cnt, 0);
+      if (--(*cnt) == 0) {
+        _liveEdges--;
+        _removedEdges++;
+        if (_removedEdges > _liveEdges) {
+          rebuild();
+        }
+      }
+    }
+
+    /**
+     * Restore the topological order after the live edge @b from -> @b to
+     * was added, contracting the cycle it closes if there is one
+     */
+    void link(unsigned from, unsigned to)
+    {
+      CALL("AcyclicityIndex::SubtermGraph::link");
+
+      unsigned rfrom = find(from);
+      unsigned rto = find(to);
+      if (rfrom == rto) {
+        _nodes[rfrom]->cyclic = true;
+        return;
+      }
+      unsigned lower = _nodes[rto]->ord;
+      unsigned upper = _nodes[rfrom]->ord;
+      if (upper < lower) {
+        return;
+      }
+
+      // the components reachable from rto and the components reaching
+      // rfrom that are ordered within [lower,upper]; the ones in both lie
+      // on a cycle with the new edge
+      _forward.reset();
+      _backward.reset();
+      search(rto, upper, true, _forward);
+      search(rfrom, lower, false, _backward);
+
+      static Stack<unsigned> ords;
+      static Stack<unsigned> cycle;
+      ords.reset();
+      cycle.reset();
+      Stack<unsigned>::Iterator fit(_forward);
+      while (fit.hasNext()) {
+        unsigned n = fit.next();
+        ords.push(_nodes[n]->ord);
+        if (_nodes[n]->backward) {
+          cycle.push(n);
+        }
+      }
+      Stack<unsigned>::Iterator bit(_backward);
+      while (bit.hasNext()) {
+        unsigned n = bit.next();
+        if (!_nodes[n]->forward) {
+          ords.push(_nodes[n]->ord);
+        }
+      }
+      sort<DefaultComparator>(ords.begin(), ords.end());
+      sortByOrd(_forward);
+      sortByOrd(_backward);
+
+      // components reaching the new edge go first, then the contracted
+      // cycle, then the components reachable from it
+      unsigned next = 0;
+      Stack<unsigned>::BottomFirstIterator bit2(_backward);
+      while (bit2.hasNext()) {
+        unsigned n = bit2.next();
+        if (!_nodes[n]->forward) {
+          _nodes[n]->ord = ords[next++];
+        }
+      }
+      if (cycle.isNonEmpty()) {
+        _nodes[contract(cycle)]->ord = ords[next++];
+      }
+      Stack<unsigned>::BottomFirstIterator fit2(_forward);
+      while (fit2.hasNext()) {
+        unsigned n = fit2.next();
+        if (!_nodes[n]->backward) {
+          _nodes[n]->ord = ords[next++];
+        }
+      }
+
+      Stack<unsigned>::Iterator fit3(_forward);
+      while (fit3.hasNext()) {
+        _nodes[fit3.next()]->forward = false;
+      }
+      Stack<unsigned>::Iterator bit3(_backward);
+      while (bit3.hasNext()) {
+        _nodes[bit3.next()]->backward = false;
+      }
+    }
+
+    /**
+     * Collect into @b res the components reachable from @b start (or
+     * reaching it, if not @b forward) through live edges, without passing
+     * components ordered after (before) @b bound
+     */
+    void search(unsigned start, unsigned bound, bool forward, Stack<unsigned>& res)
+    {
+      CALL("AcyclicityIndex::SubtermGraph::search");
+
+      static Stack<unsigned> toVisit;
+      toVisit.reset();
+      mark(start, forward);
+      toVisit.push(start);
+      res.push(start);
+
+      while (toVisit.isNonEmpty()) {
+        unsigned c = toVisit.pop();
+        Stack<unsigned>::Iterator mit(_nodes[c]->members);
+        while (mit.hasNext()) {
+          unsigned m = mit.next();
+          Stack<unsigned>::Iterator eit(forward ? _nodes[m]->out : _nodes[m]->in);
+          while (eit.hasNext()) {
+            unsigned n = eit.next();
+            if (!(forward ? isLive(m, n) : isLive(n, m))) {
+              continue;
+            }
+            unsigned rn = find(n);
+            if (marked(rn, forward)) {
+              continue;
+            }
+            if (forward ? _nodes[rn]->ord > bound : _nodes[rn]->ord < bound) {
+              continue;
+            }
+            mark(rn, forward);
+            toVisit.push(rn);
+            res.push(rn);
+          }
+        }
+      }
+    }
+
+    bool marked(unsigned n, bool forward) { return forward ? _nodes[n]->forward : _nodes[n]->backward; }
+    void mark(unsigned n, bool forward) { (forward ? _nodes[n]->forward : _nodes[n]->backward) = true; }
+
+    /** Merge the components @b comps into a cyclic one and return its representative */
+    unsigned contract(Stack<unsigned>& comps)
+    {
+      CALL("AcyclicityIndex::SubtermGraph::contract");
+
+      unsigned rep = comps.top();
+      Stack<unsigned>::Iterator it(comps);
+      while (it.hasNext()) {
+        unsigned c = it.next();
+        if (_nodes[c]->members.size() > _nodes[rep]->members.size()) {
+          rep = c;
+        }
+      }
+      Stack<unsigned>::Iterator it2(comps);
+      while (it2.hasNext()) {
+        unsigned c = it2.next();
+        if (c == rep) {
+          continue;
+        }
+        _nodes[c]->parent = rep;
+        _nodes[rep]->members.loadFromIterator(Stack<unsigned>::Iterator(_nodes[c]->members));
+        _nodes[c]->members.reset();
+      }
+      _nodes[rep]->cyclic = true;
+      return rep;
+    }
+
+    /** Build the graph again from the live edges only */
+    void rebuild()
+    {
+      CALL("AcyclicityIndex::SubtermGraph::rebuild");
+
+      RSTAT_CTR_INC("acyclicity graph rebuilds");
+
+      _nextOrd = 0;
+      for (unsigned n = 0; n < _nodes.size(); n++) {
+        Node* node = _nodes[n];
+        node->parent = n;
+        node->ord = _nextOrd++;
+        node->cyclic = false;
+        node->members.reset();
+        node->members.push(n);
+        node->out.reset();
+        node->in.reset();
+      }
+
+      static Stack<pair<pair<unsigned,unsigned>,unsigned> > live;
+      live.reset();
+      EdgeMap::Iterator it(_edges);
+      while (it.hasNext()) {
+        pair<unsigned,unsigned> edge;
+        unsigned cnt;
+        it.next(edge, cnt);
+        if (cnt) {
+          live.push(make_pair(edge, cnt));
+        }
+      }
+      _edges.reset();
+      _removedEdges = 0;
+
+      Stack<pair<pair<unsigned,unsigned>,unsigned> >::Iterator lit(live);
+      while (lit.hasNext()) {
+        pair<pair<unsigned,unsigned>,unsigned> e = lit.next();
+        unsigned from = e.first.first;
+        unsigned to = e.first.second;
+        _edges.insert(e.first, e.second);
+        _nodes[from]->out.push(to);
+        _nodes[to]->in.push(from);
+        link(from, to);
+      }
+    }
+
+    typedef DHMap<pair<unsigned,unsigned>, unsigned> EdgeMap;
+
+    Stack<Node*> _nodes;
+    DHMap<unsigned, unsigned> _functorNodes;
+    /** multiplicities of the edges, zero for the removed ones */
+    EdgeMap _edges;
+    unsigned _nextOrd;
+    unsigned _liveEdges;
+    unsigned _removedEdges;
+
+    Stack<unsigned> _forward;
+    Stack<unsigned> _backward;
+  };
+
   struct AcyclicityIndex::CycleSearchTreeNode
   {
     CycleSearchTreeNode(TermList t,
@@ -224,13 +635,17 @@ namespace Indexing
         if (aindex._sIndexes.find(sort)) {
           _index = aindex._sIndexes.get(sort);
           _tis = aindex._tis;
-          if (_index->find(make_pair(queryLit, queryClause))) {
-            IndexEntry *entry = _index->get(make_pair(queryLit, queryClause));
-            _stack.push(CycleSearchTreeNode::unificationNode(entry->t,
-                                                             queryLit,
-                                                             queryClause,
-                                                             nullptr,
-                                                             _nextAvailableIndex++));
+          IndexEntry *entry;
+          if (_index->find(make_pair(queryLit, queryClause), entry)) {
+            if (aindex._graphs.get(sort)->mayHaveCycle(entry)) {
+              _stack.push(CycleSearchTreeNode::unificationNode(entry->t,
+                                                               queryLit,
+                                                               queryClause,
+                                                               nullptr,
+                                                               _nextAvailableIndex++));
+            } else {
+              RSTAT_CTR_INC("acyclicity queries skipped");
+            }
           }
         }
       }
@@ -422,6 +837,16 @@ namespace Indexing
     }
   }
     
+  AcyclicityIndex::~AcyclicityIndex()
+  {
+    CALL("AcyclicityIndex::~AcyclicityIndex");
+
+    DHMap<unsigned, SubtermGraph*>::Iterator git(_graphs);
+    while (git.hasNext()) {
+      delete git.next();
+    }
+  }
+
   void AcyclicityIndex::insert(Literal *lit, Clause *c)
   {
     CALL("AcyclicityIndex::insert");
@@ -440,11 +865,14 @@ namespace Indexing
         // initialize the index for this sort
         index = new SIndex();
         _sIndexes.insert(sort, index);
+        _graphs.insert(sort, new SubtermGraph());
       }
 
       ULit ulit = make_pair(lit, c);
       if (!index->find(ulit)) {
-        index->insert(ulit, new IndexEntry(lit, c, *t, getSubterms(fs->term())));
+        IndexEntry* entry = new IndexEntry(lit, c, *t, getSubterms(fs->term()));
+        index->insert(ulit, entry);
+        _graphs.get(sort)->addEntry(entry);
         _tis->insert(*t, lit, c);
       }
     }
@@ -460,9 +888,11 @@ namespace Indexing
      
     if (matchesPattern(lit, fs, t, &sort) && _sIndexes.find(sort)) {
       ULit ulit = make_pair(lit, c);
-      if (!_sIndexes.get(sort)->find(ulit))
+      IndexEntry* entry;
+      if (!_sIndexes.get(sort)->find(ulit, entry))
         return;
 
+      _graphs.get(sort)->removeEntry(entry);
       _sIndexes.get(sort)->remove(ulit);
      _tis->remove(*t, lit, c);
     }
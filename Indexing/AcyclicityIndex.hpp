@@ -67,10 +67,11 @@ class AcyclicityIndex
 public:
   AcyclicityIndex(Indexing::TermIndexingStructure* tis) :
     _sIndexes(),
+    _graphs(),
     _tis(tis)
   {}
 
-  ~AcyclicityIndex() {}
+  ~AcyclicityIndex();
   
   void insert(Kernel::Literal *lit, Kernel::Clause *c);
   void remove(Kernel::Literal *lit, Kernel::Clause *c);
@@ -88,10 +89,13 @@ private:
   struct IndexEntry;
   struct CycleSearchTreeNode;
   struct CycleSearchIterator;
+  class SubtermGraph;
   typedef pair<Kernel::Literal*, Kernel::Clause*> ULit;
   typedef Lib::DHMap<ULit, IndexEntry*> SIndex;
 
   Lib::DHMap<unsigned, SIndex*> _sIndexes;
+  /** over-approximations of the cycles in _sIndexes, for the same sorts */
+  Lib::DHMap<unsigned, SubtermGraph*> _graphs;
   Indexing::TermIndexingStructure* _tis;
 };
 
@@ -52,7 +52,8 @@ GroundingIndex::GroundingIndex(const Options& opt)
       //cout << "Warning, Z3 not curently used for Global Subsumption" << endl; 
 #endif
     case Options::SatSolver::MINISAT:
-      _solver = new MinisatInterfacing(opt,true);
+      // global subsumption asks for a refutation after each successful check
+      _solver = new MinisatInterfacing(opt,true,true);
     	break;
     default:
       ASSERTION_VIOLATION_REP(opt.satSolver());
@@ -171,7 +171,7 @@ Clause* GlobalSubsumption::perform(Clause* cl, Stack<Unit*>& prems)
   SATClause* scl = SATClause::fromStack(plits);
   SATInference* inf = new FOConversionInference(cl);
   scl->setInference(inf);
-  solver.addClause(scl);
+  solver.addDisposableClause(scl);
 
   // check for subsuming clause by looking for a proper subset of used assumptions
   SATSolver::Status res = solver.solveUnderAssumptions(assumps, _uprOnly, true /* only proper subsets */);
@@ -68,6 +68,91 @@ TermList TermReplacement::transformSubterm(TermList trm)
   return trm;
 }
 
+TermList SymbolRenaming::transformSubterm(TermList trm)
+{
+  CALL("SymbolRenaming::transformSubterm");
+
+  unsigned f;
+  if(trm.isTerm() && _functions.find(trm.term()->functor(),f)){
+    Term* t = trm.term();
+    static Stack<TermList> args;
+    args.reset();
+    for(unsigned i=0;i<t->arity();i++){
+      args.push(*t->nthArgument(i));
+    }
+    return TermList(Term::create(f,t->arity(),args.begin()));
+  }
+  return trm;
+}
+
+Formula* PlaceholderReplacement::applyLiteral(Formula* f)
+{
+  CALL("PlaceholderReplacement::applyLiteral");
+
+  Literal* l = f->literal();
+  unsigned freshPred;
+  if(_predicates.find(l->functor(),freshPred)){
+    static Stack<TermList> args;
+    args.reset();
+    for(unsigned i=0;i<l->arity();i++){
+      args.push(*l->nthArgument(i));
+    }
+    return new AtomicFormula(Literal::create(freshPred,l->arity(),l->polarity(),false,args.begin()));
+  }
+  if(l->functor()!=_placeholder){
+    return f;
+  }
+  TermReplacement cr(_term,*l->nthArgument(0));
+  Literal* inst = cr.transform(_clit);
+  return new AtomicFormula(l->isPositive() ? inst : Literal::complementaryLiteral(inst));
+}
+
+/**
+ * Return the unit of the schema number @b index of the template
+ * instantiated for this instance, build it if it does not exist yet
+ */
+FormulaUnit* InductionInstance::hypothesis(unsigned index)
+{
+  CALL("InductionInstance::hypothesis");
+
+  while(hypotheses.size()<templ->hypotheses.size()){
+    hypotheses.push(0);
+  }
+  if(!hypotheses[index]){
+    PlaceholderReplacement pr(templ->placeholder,clit,term,predicates);
+    Formula* hyp = pr.transform(templ->hypotheses[index]);
+    hypotheses[index] = new FormulaUnit(hyp,new Inference(Inference::INDUCTION),Unit::AXIOM);
+  }
+  return hypotheses[index];
+}
+
+InductionInstanceInference::InductionInstanceInference(Clause* templClause, SmartPtr<InductionInstance> instance, unsigned hypothesis)
+  : Inference1(Inference::CLAUSIFY,templClause),
+    _instance(instance),
+    _hypothesis(hypothesis),
+    _materialized(false)
+{
+  // the depth of a clausification of the instantiated schema
+  _maxDepth = 1;
+}
+
+/**
+ * Replace the template clause by the instantiated schema as the premise
+ */
+void InductionInstanceInference::minimizePremises()
+{
+  CALL("InductionInstanceInference::minimizePremises");
+
+  if(_materialized){
+    return;
+  }
+  Unit* hyp = _instance->hypothesis(_hypothesis);
+  hyp->incRefCnt();
+  _premise1->decRefCnt();
+  _premise1 = hyp;
+  _materialized = true;
+}
+
 ClauseIterator Induction::generateClauses(Clause* premise)
 {
   CALL("Induction::generateClauses");
@@ -192,15 +277,71 @@ void InductionClauseIterator::process(Clause* premise, Literal* lit)
    }
 }
 
+/**
+ * Return the literal of the placeholder predicate of @b templ standing for
+ * the complement of the inducted literal with the inducted term replaced
+ * by @b t
+ */
+static Literal* placeholder(InductionTemplate* templ, TermList t, bool polarity = true)
+{
+  return Literal::create1(templ->placeholder,polarity,t);
+}
+
+/**
+ * Create an empty template for a schema on terms of sort @b srt
+ */
+static InductionTemplate* newTemplate(unsigned srt)
+{
+  CALL("newTemplate");
+
+  InductionTemplate* templ = new InductionTemplate();
+  templ->placeholder = env.signature->addFreshPredicate(1,"induction_template");
+  env.signature->getPredicate(templ->placeholder)->setType(OperatorType::getPredicateType({srt}));
+  RSTAT_CTR_INC("induction templates");
+  return templ;
+}
+
+/**
+ * Clausify the schema @b hypothesis into the clauses of @b templ and
+ * remember the skolem functions it introduced
+ */
+static void clausifyTemplate(InductionTemplate* templ, Formula* hypothesis)
+{
+  CALL("clausifyTemplate");
+
+  unsigned firstFunction = env.signature->functions();
+
+  NewCNF cnf(0);
+  cnf.setForInduction();
+  FormulaUnit* fu = new FormulaUnit(hypothesis,new Inference(Inference::INDUCTION),Unit::AXIOM);
+  unsigned firstClause = templ->clauses.size();
+  cnf.clausify(NNF::ennf(fu), templ->clauses);
+
+  for(unsigned i=firstClause;i<templ->clauses.size();i++){
+    // the instances refer to the clauses as their premises
+    templ->clauses[i]->incRefCnt();
+    templ->clauseHypotheses.push(templ->hypotheses.size());
+  }
+  templ->hypotheses.push(hypothesis);
+
+  for(unsigned f=firstFunction;f<env.signature->functions();f++){
+    templ->functions.push(f);
+  }
+}
+
       // deal with integer constants using two hypotheses
       // (L[0] & (![X] : (X>=0 & L[X]) -> L[x+1])) -> (![Y] : Y>=0 -> L[Y])
       // (L[0] & (![X] : (X<=0 & L[X]) -> L[x-1])) -> (![Y] : Y<=0 -> L[Y])
       // for some ~L[a]
-void InductionClauseIterator::performMathInductionOne(Clause* premise, Literal* lit, Term* term) 
+InductionTemplate* InductionClauseIterator::mathInductionOneTemplate()
 {
-  CALL("InductionClauseIterator::performMathInductionOne");
+  CALL("InductionClauseIterator::mathInductionOneTemplate");
 
-        //cout << "PERFORM INDUCTION on " << env.signature->functionName(c) << endl;
+        static InductionTemplate* templ = 0;
+        if(templ){
+          return templ;
+        }
+        templ = newTemplate(Sorts::SRT_INTEGER);
 
         TermList zero(theory->representConstant(IntegerConstantType(0)));
         TermList one(theory->representConstant(IntegerConstantType(1)));
@@ -209,29 +350,22 @@ void InductionClauseIterator::performMathInductionOne(Clause* premise, Literal*
         TermList x(0,false);
         TermList y(1,false);
 
-        Literal* clit = Literal::complementaryLiteral(lit);
-
         // create L[zero]
-        TermReplacement cr1(term,zero);
-        Formula* Lzero = new AtomicFormula(cr1.transform(clit));
+        Formula* Lzero = new AtomicFormula(placeholder(templ,zero));
 
         // create L[X] 
-        TermReplacement cr2(term,x);
-        Formula* Lx = new AtomicFormula(cr2.transform(clit));
+        Formula* Lx = new AtomicFormula(placeholder(templ,x));
 
         // create L[Y] 
-        TermReplacement cr3(term,y);
-        Formula* Ly = new AtomicFormula(cr3.transform(clit));
+        Formula* Ly = new AtomicFormula(placeholder(templ,y));
 
         // create L[X+1] 
         TermList fpo(Term::create2(env.signature->getInterpretingSymbol(Theory::INT_PLUS),x,one));
-        TermReplacement cr4(term,fpo);
-        Formula* Lxpo = new AtomicFormula(cr4.transform(clit));
+        Formula* Lxpo = new AtomicFormula(placeholder(templ,fpo));
 
         // create L[X-1]
         TermList fmo(Term::create2(env.signature->getInterpretingSymbol(Theory::INT_PLUS),x,mone));
-        TermReplacement cr5(term,fmo);
-        Formula* Lxmo = new AtomicFormula(cr5.transform(clit));
+        Formula* Lxmo = new AtomicFormula(placeholder(templ,fmo));
 
         // create X>=0, which is ~X<0
         Formula* Lxgz = new AtomicFormula(Literal::create2(env.signature->getInterpretingSymbol(Theory::INT_LESS),
@@ -267,13 +401,28 @@ void InductionClauseIterator::performMathInductionOne(Clause* premise, Literal*
                           ,0))),
                           Formula::quantify(new BinaryFormula(Connective::IMP,Lylz,Ly)));
   
-        NewCNF cnf(0);
-        cnf.setForInduction();
+        templ->conclusionVar = y.var();
+        clausifyTemplate(templ,hyp1);
+        clausifyTemplate(templ,hyp2);
+        return templ;
+}
+
+void InductionClauseIterator::performMathInductionOne(Clause* premise, Literal* lit, Term* term) 
+{
+  CALL("InductionClauseIterator::performMathInductionOne");
+
+        //cout << "PERFORM INDUCTION on " << env.signature->functionName(c) << endl;
+
+        Literal* clit = Literal::complementaryLiteral(lit);
+
+        InductionTemplate* templ = mathInductionOneTemplate();
+
+        // L[Y], the conclusion of the hypotheses
+        TermReplacement cr(term,TermList(templ->conclusionVar,false));
+        Literal* Ly = cr.transform(clit);
+
         Stack<Clause*> hyp_clauses;
-        FormulaUnit* fu1 = new FormulaUnit(hyp1,new Inference(Inference::INDUCTION),Unit::AXIOM);
-        FormulaUnit* fu2 = new FormulaUnit(hyp2,new Inference(Inference::INDUCTION),Unit::AXIOM);
-        cnf.clausify(NNF::ennf(fu1), hyp_clauses);
-        cnf.clausify(NNF::ennf(fu2), hyp_clauses);
+        instantiate(templ, clit, term, hyp_clauses);
 
         // Now perform resolution between lit and the hyp_clauses on clit, which should be contained in each clause!
         Stack<Clause*>::Iterator cit(hyp_clauses);
@@ -281,9 +430,9 @@ void InductionClauseIterator::performMathInductionOne(Clause* premise, Literal*
           Clause* c = cit.next();
           //TODO destroy this?
           RobSubstitution* subst = new RobSubstitution();
-          subst->unify(TermList(lit),0,TermList(Ly->literal()),1);
+          subst->unify(TermList(lit),0,TermList(Ly),1);
           SLQueryResult qr(lit,premise,ResultSubstitution::fromSubstitution(subst,1,0));
-          Clause* r = BinaryResolution::generateClause(c,Ly->literal(),qr,*env.options);
+          Clause* r = BinaryResolution::generateClause(c,Ly,qr,*env.options);
           _clauses.push(r);
         }
         env.statistics->induction++;
@@ -303,16 +452,22 @@ void InductionClauseIterator::performMathInductionTwo(Clause* premise, Literal*
  * and then force binary resolution on L for each resultant clause
  */
 
-void InductionClauseIterator::performStructInductionOne(Clause* premise, Literal* lit, Term* term) 
+InductionTemplate* InductionClauseIterator::structInductionOneTemplate(TermAlgebra* ta)
 {
-  CALL("InductionClauseIterator::performStructInductionOne"); 
+  CALL("InductionClauseIterator::structInductionOneTemplate"); 
 
-  TermAlgebra* ta = env.signature->getTermAlgebraOfSort(env.signature->getFunction(term->functor())->fnType()->result());
   unsigned ta_sort = ta->sort();
 
+  static DHMap<unsigned,InductionTemplate*> templates;
+  InductionTemplate** templ_ptr;
+  if(!templates.getValuePtr(ta_sort,templ_ptr)){
+    return *templ_ptr;
+  }
+  InductionTemplate* templ = newTemplate(ta_sort);
+  *templ_ptr = templ;
+
   FormulaList* formulas = FormulaList::empty();
 
-  Literal* clit = Literal::complementaryLiteral(lit);
   unsigned var = 0;
 
   // first produce the formula
@@ -324,8 +479,7 @@ void InductionClauseIterator::performStructInductionOne(Clause* premise, Literal
     // non recursive get L[_]
     if(!con->recursive()){
       if(arity==0){
-        TermReplacement cr(term,TermList(Term::createConstant(con->functor())));
-        f = new AtomicFormula(cr.transform(clit)); 
+        f = new AtomicFormula(placeholder(templ,TermList(Term::createConstant(con->functor())))); 
       }
       else{
         Stack<TermList> argTerms;
@@ -333,8 +487,7 @@ void InductionClauseIterator::performStructInductionOne(Clause* premise, Literal
           argTerms.push(TermList(var,false));
           var++;
         }
-        TermReplacement cr(term,TermList(Term::create(con->functor(),(unsigned)argTerms.size(), argTerms.begin())));
-        f = new AtomicFormula(cr.transform(clit));
+        f = new AtomicFormula(placeholder(templ,TermList(Term::create(con->functor(),(unsigned)argTerms.size(), argTerms.begin()))));
       }
     }
     // recursive get (L[x] => L[c(x)])
@@ -350,20 +503,17 @@ void InductionClauseIterator::performStructInductionOne(Clause* premise, Literal
         }
         argTerms.push(x);
       }
-      TermReplacement cr(term,TermList(Term::create(con->functor(),(unsigned)argTerms.size(), argTerms.begin())));
-      Formula* right = new AtomicFormula(cr.transform(clit));
+      Formula* right = new AtomicFormula(placeholder(templ,TermList(Term::create(con->functor(),(unsigned)argTerms.size(), argTerms.begin()))));
       Formula* left = 0;
       ASS(ta_vars.size()>=1);
       if(ta_vars.size()==1){
-        TermReplacement cr(term,ta_vars[0]);
-        left = new AtomicFormula(cr.transform(clit));
+        left = new AtomicFormula(placeholder(templ,ta_vars[0]));
       }
       else{
         FormulaList* args = FormulaList::empty();
         Stack<TermList>::Iterator tvit(ta_vars);
         while(tvit.hasNext()){
-          TermReplacement cr(term,tvit.next());
-          args = new FormulaList(new AtomicFormula(cr.transform(clit)),args);
+          args = new FormulaList(new AtomicFormula(placeholder(templ,tvit.next())),args);
         }
         left = new JunctionFormula(Connective::AND,args);
       }
@@ -373,19 +523,28 @@ void InductionClauseIterator::performStructInductionOne(Clause* premise, Literal
     ASS(f);
     formulas = new FormulaList(f,formulas);
   }
-  TermReplacement cr(term,TermList(var,false));
-  Literal* conclusion = cr.transform(clit);
+  templ->conclusionVar = var;
   Formula* hypothesis = new BinaryFormula(Connective::IMP,
                             Formula::quantify(new JunctionFormula(Connective::AND,formulas)),
-                            Formula::quantify(new AtomicFormula(conclusion)));
+                            Formula::quantify(new AtomicFormula(placeholder(templ,TermList(var,false)))));
 
-  NewCNF cnf(0);
-  cnf.setForInduction();
-  Stack<Clause*> hyp_clauses;
-  FormulaUnit* fu = new FormulaUnit(hypothesis,new Inference(Inference::INDUCTION),Unit::AXIOM);
-  cnf.clausify(NNF::ennf(fu), hyp_clauses);
+  clausifyTemplate(templ,hypothesis);
+  return templ;
+}
+
+void InductionClauseIterator::performStructInductionOne(Clause* premise, Literal* lit, Term* term) 
+{
+  CALL("InductionClauseIterator::performStructInductionOne"); 
+
+  TermAlgebra* ta = env.signature->getTermAlgebraOfSort(env.signature->getFunction(term->functor())->fnType()->result());
+  InductionTemplate* templ = structInductionOneTemplate(ta);
+
+  Literal* clit = Literal::complementaryLiteral(lit);
+  TermReplacement cr(term,TermList(templ->conclusionVar,false));
+  Literal* conclusion = cr.transform(clit);
 
-  //cout << "Clausify " << fu->toString() << endl;
+  Stack<Clause*> hyp_clauses;
+  instantiate(templ, clit, term, hyp_clauses);
 
   // Now perform resolution between lit and the hyp_clauses on clit, which should be contained in each clause!
   Stack<Clause*>::Iterator cit(hyp_clauses);
@@ -404,19 +563,23 @@ void InductionClauseIterator::performStructInductionOne(Clause* premise, Literal
  * We produce the clause ~L[x] \/ ?y : L[y] & !z (z subterm y -> ~L[z])
  * and perform resolution with lit L[c]
  */
-void InductionClauseIterator::performStructInductionTwo(Clause* premise, Literal* lit, Term* term) 
+InductionTemplate* InductionClauseIterator::structInductionTwoTemplate(TermAlgebra* ta)
 {
-  //cout << "TWO " << premise->toString() << endl;
+  CALL("InductionClauseIterator::structInductionTwoTemplate");
 
-  TermAlgebra* ta = env.signature->getTermAlgebraOfSort(env.signature->getFunction(term->functor())->fnType()->result());
   unsigned ta_sort = ta->sort();
 
-  Literal* clit = Literal::complementaryLiteral(lit);
+  static DHMap<unsigned,InductionTemplate*> templates;
+  InductionTemplate** templ_ptr;
+  if(!templates.getValuePtr(ta_sort,templ_ptr)){
+    return *templ_ptr;
+  }
+  InductionTemplate* templ = newTemplate(ta_sort);
+  *templ_ptr = templ;
 
   // make L[y]
   TermList y(0,false); 
-  TermReplacement cr(term,y);
-  Literal* Ly = cr.transform(lit);
+  Literal* Ly = placeholder(templ,y,false);
 
   // for each constructor and destructor make
   // ![Z] : y = cons(Z,dec(y)) -> ( ~L[dec1(y)] & ~L[dec2(y)]
@@ -459,9 +622,7 @@ void InductionClauseIterator::performStructInductionTwo(Clause* premise, Literal
       unsigned and_terms = 0;
       while(tit.hasNext()){
         TermList djy = tit.next();
-        TermReplacement cr(term,djy);
-        Literal* nLdjy = cr.transform(clit);
-        Formula* f = new AtomicFormula(nLdjy); 
+        Formula* f = new AtomicFormula(placeholder(templ,djy)); 
         And = new FormulaList(f,And);
         and_terms++;
       }
@@ -478,18 +639,28 @@ void InductionClauseIterator::performStructInductionTwo(Clause* premise, Literal
   Formula* exists = new QuantifiedFormula(Connective::EXISTS, new Formula::VarList(y.var(),0),0,
                   new JunctionFormula(Connective::AND,new FormulaList(new AtomicFormula(Ly),formulas))); 
   
-  TermReplacement cr2(term,TermList(1,false));
-  Literal* conclusion = cr2.transform(clit);
+  templ->conclusionVar = 1;
+  Literal* conclusion = placeholder(templ,TermList(1,false));
   FormulaList* orf = new FormulaList(exists,new FormulaList(Formula::quantify(new AtomicFormula(conclusion)),FormulaList::empty()));
   Formula* hypothesis = new JunctionFormula(Connective::OR,orf);
 
-  NewCNF cnf(0);
-  cnf.setForInduction();
-  Stack<Clause*> hyp_clauses;
-  FormulaUnit* fu = new FormulaUnit(hypothesis,new Inference(Inference::INDUCTION),Unit::AXIOM);
-  cnf.clausify(NNF::ennf(fu), hyp_clauses);
+  clausifyTemplate(templ,hypothesis);
+  return templ;
+}
 
-  //cout << "Clausify " << fu->toString() << endl;
+void InductionClauseIterator::performStructInductionTwo(Clause* premise, Literal* lit, Term* term) 
+{
+  //cout << "TWO " << premise->toString() << endl;
+
+  TermAlgebra* ta = env.signature->getTermAlgebraOfSort(env.signature->getFunction(term->functor())->fnType()->result());
+  InductionTemplate* templ = structInductionTwoTemplate(ta);
+
+  Literal* clit = Literal::complementaryLiteral(lit);
+  TermReplacement cr2(term,TermList(templ->conclusionVar,false));
+  Literal* conclusion = cr2.transform(clit);
+
+  Stack<Clause*> hyp_clauses;
+  instantiate(templ, clit, term, hyp_clauses);
 
   // Now perform resolution between lit and the hyp_clauses on clit, which should be contained in each clause!
   Stack<Clause*>::Iterator cit(hyp_clauses);
@@ -514,26 +685,30 @@ void InductionClauseIterator::performStructInductionTwo(Clause* premise, Literal
  * i.e. we add a new special predicat that is true when its argument is smaller than Y
  *
  */
-void InductionClauseIterator::performStructInductionThree(Clause* premise, Literal* lit, Term* term) 
+InductionTemplate* InductionClauseIterator::structInductionThreeTemplate(TermAlgebra* ta)
 {
-  CALL("InductionClauseIterator::performStructInductionThree");
-
+  CALL("InductionClauseIterator::structInductionThreeTemplate");
 
-  TermAlgebra* ta = env.signature->getTermAlgebraOfSort(env.signature->getFunction(term->functor())->fnType()->result());
   unsigned ta_sort = ta->sort();
 
-  Literal* clit = Literal::complementaryLiteral(lit);
+  static DHMap<unsigned,InductionTemplate*> templates;
+  InductionTemplate** templ_ptr;
+  if(!templates.getValuePtr(ta_sort,templ_ptr)){
+    return *templ_ptr;
+  }
+  InductionTemplate* templ = newTemplate(ta_sort);
+  *templ_ptr = templ;
 
   // make L[y]
   TermList x(0,false); 
   TermList y(1,false); 
   TermList z(2,false); 
-  TermReplacement cr(term,y);
-  Literal* Ly = cr.transform(lit);
+  Literal* Ly = placeholder(templ,y,false);
 
   // make smallerThanY
   unsigned sty = env.signature->addFreshPredicate(1,"smallerThan");
   env.signature->getPredicate(sty)->setType(OperatorType::getPredicateType({ta_sort}));
+  templ->predicates.push(sty);
 
   // make ( y = con_i(..dec(y)..) -> smaller(dec(y)))  for each constructor 
   FormulaList* conjunction = new FormulaList(new AtomicFormula(Ly),0); 
@@ -611,29 +786,38 @@ void InductionClauseIterator::performStructInductionThree(Clause* premise, Liter
     } 
   }
   // now !z : smallerThanY(z) => ~L[z]
-  TermReplacement cr2(term,z);
   Formula* smallerImpNL = Formula::quantify(new BinaryFormula(Connective::IMP, 
                             new AtomicFormula(Literal::create1(sty,true,z)),
-                            new AtomicFormula(cr2.transform(clit))));
+                            new AtomicFormula(placeholder(templ,z))));
 
   conjunction = new FormulaList(smallerImpNL,conjunction);
   Formula* exists = new QuantifiedFormula(Connective::EXISTS, new Formula::VarList(y.var(),0),0,
                        new JunctionFormula(Connective::AND,conjunction));
 
-  TermReplacement cr3(term,x);
-  Literal* conclusion = cr3.transform(clit);
+  templ->conclusionVar = x.var();
+  Literal* conclusion = placeholder(templ,x);
   FormulaList* orf = new FormulaList(exists,new FormulaList(Formula::quantify(new AtomicFormula(conclusion)),0));
   Formula* hypothesis = new JunctionFormula(Connective::OR,orf);
 
   //cout << hypothesis->toString() << endl;
 
-  NewCNF cnf(0);
-  cnf.setForInduction();
-  Stack<Clause*> hyp_clauses;
-  FormulaUnit* fu = new FormulaUnit(hypothesis,new Inference(Inference::INDUCTION),Unit::AXIOM);
-  cnf.clausify(NNF::ennf(fu), hyp_clauses);
+  clausifyTemplate(templ,hypothesis);
+  return templ;
+}
+
+void InductionClauseIterator::performStructInductionThree(Clause* premise, Literal* lit, Term* term) 
+{
+  CALL("InductionClauseIterator::performStructInductionThree");
 
-  //cout << "Clausify " << fu->toString() << endl;
+  TermAlgebra* ta = env.signature->getTermAlgebraOfSort(env.signature->getFunction(term->functor())->fnType()->result());
+  InductionTemplate* templ = structInductionThreeTemplate(ta);
+
+  Literal* clit = Literal::complementaryLiteral(lit);
+  TermReplacement cr3(term,TermList(templ->conclusionVar,false));
+  Literal* conclusion = cr3.transform(clit);
+
+  Stack<Clause*> hyp_clauses;
+  instantiate(templ, clit, term, hyp_clauses);
 
   // Now perform resolution between lit and the hyp_clauses on clit, which should be contained in each clause!
   Stack<Clause*>::Iterator cit(hyp_clauses);
@@ -647,6 +831,88 @@ void InductionClauseIterator::performStructInductionThree(Clause* premise, Liter
   env.statistics->induction++; 
 }
 
+/**
+ * Instantiate the clauses of @b templ for the literal @b clit, the complement
+ * of the literal being inducted on, and the inducted term @b term, and push
+ * them to @b res.
+ *
+ * A placeholder literal P(t) becomes @b clit with @b term replaced by t and
+ * ~P(t) its complement. The skolem functions and predicates of the template
+ * are replaced by fresh ones, as each instance has its own witnesses.
+ *
+ * The premises of the instances are the template clauses. The instantiated
+ * schemas are only built if the instances are in a proof that is output.
+ */
+void InductionClauseIterator::instantiate(InductionTemplate* templ, Literal* clit, Term* term, Stack<Clause*>& res)
+{
+  CALL("InductionClauseIterator::instantiate");
+
+  static DHMap<unsigned,unsigned> functions;
+  functions.reset();
+  SmartPtr<InductionInstance> instance(new InductionInstance(templ,clit,term));
+  DHMap<unsigned,unsigned>& predicates = instance->predicates;
+
+  Stack<unsigned>::Iterator fit(templ->functions);
+  while(fit.hasNext()){
+    unsigned f = fit.next();
+    Signature::Symbol* sym = env.signature->getFunction(f);
+    unsigned fresh = env.signature->addSkolemFunction(sym->arity());
+    Signature::Symbol* freshSym = env.signature->getFunction(fresh);
+    freshSym->setType(sym->fnType());
+    if(sym->inductionSkolem()){
+      freshSym->markInductionSkolem();
+    }
+    functions.insert(f,fresh);
+  }
+  // the only predicates introduced by schemas are those of performStructInductionThree
+  Stack<unsigned>::Iterator pit(templ->predicates);
+  while(pit.hasNext()){
+    unsigned p = pit.next();
+    Signature::Symbol* sym = env.signature->getPredicate(p);
+    unsigned fresh = env.signature->addFreshPredicate(sym->arity(),"smallerThan");
+    env.signature->getPredicate(fresh)->setType(sym->predType());
+    predicates.insert(p,fresh);
+  }
+
+  SymbolRenaming renaming(functions);
+  static LiteralStack lits;
+  static Stack<TermList> args;
+
+  for(unsigned ci=0;ci<templ->clauses.size();ci++){
+    Clause* c = templ->clauses[ci];
+    lits.reset();
+    bool tautology = false;
+    for(unsigned i=0;i<c->length() && !tautology;i++){
+      Literal* l = renaming.transform((*c)[i]);
+      unsigned pred = l->functor();
+      unsigned freshPred;
+      if(pred==templ->placeholder){
+        TermReplacement cr(term,*l->nthArgument(0));
+        Literal* inst = cr.transform(clit);
+        l = l->isPositive() ? inst : Literal::complementaryLiteral(inst);
+      }
+      else if(predicates.find(pred,freshPred)){
+        args.reset();
+        for(unsigned j=0;j<l->arity();j++){
+          args.push(*l->nthArgument(j));
+        }
+        l = Literal::create(freshPred,l->arity(),l->polarity(),false,args.begin());
+      }
+      // distinct placeholder literals and other literals of the template
+      // can become the same or complementary literals in the instance
+      if(lits.find(l)){
+        continue;
+      }
+      tautology = lits.find(Literal::complementaryLiteral(l));
+      lits.push(l);
+    }
+    if(!tautology){
+      Inference* inf = new InductionInstanceInference(c,instance,templ->clauseHypotheses[ci]);
+      res.push(Clause::fromStack(lits,Unit::AXIOM,inf));
+    }
+  }
+}
+
 bool InductionClauseIterator::notDone(Literal* lit, Term* term)
 {
   CALL("InductionClauseIterator::notDone");
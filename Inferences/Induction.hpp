@@ -26,10 +26,21 @@
 
 #include "Forwards.hpp"
 
+#include "Lib/DHMap.hpp"
+#include "Lib/SmartPtr.hpp"
+#include "Lib/Stack.hpp"
+
+#include "Kernel/FormulaTransformer.hpp"
+#include "Kernel/Inference.hpp"
 #include "Kernel/TermTransformer.hpp"
 
 #include "InferenceEngine.hpp"
 
+namespace Shell
+{
+class TermAlgebra;
+}
+
 namespace Inferences
 {
 
@@ -46,6 +57,115 @@ private:
   TermList _r;
 };
 
+/**
+ * Renames function symbols of a literal according to a map
+ */
+class SymbolRenaming : public TermTransformerTransformTransformed {
+
+public:
+  SymbolRenaming(DHMap<unsigned,unsigned>& functions) : _functions(functions) {}
+  using TermTransformerTransformTransformed::transform;
+protected:
+  virtual TermList transformSubterm(TermList trm);
+private:
+  DHMap<unsigned,unsigned>& _functions;
+};
+
+/**
+ * Replaces the placeholder literals P(t) of an induction template by the
+ * complement of the literal being inducted on with the inducted term
+ * replaced by t, and the predicates of the template by those of the instance
+ */
+class PlaceholderReplacement : public FormulaTransformer {
+
+public:
+  PlaceholderReplacement(unsigned placeholder, Literal* clit, Term* term, DHMap<unsigned,unsigned>& predicates)
+    : _placeholder(placeholder), _clit(clit), _term(term), _predicates(predicates) {}
+protected:
+  virtual Formula* applyLiteral(Formula* f);
+private:
+  unsigned _placeholder;
+  Literal* _clit;
+  Term* _term;
+  DHMap<unsigned,unsigned>& _predicates;
+};
+
+/**
+ * An induction schema for some sort, clausified once with the complement of
+ * the literal being inducted on applied to a term replaced by a placeholder
+ * predicate, see InductionClauseIterator::instantiate()
+ */
+struct InductionTemplate
+{
+  CLASS_NAME(InductionTemplate);
+  USE_ALLOCATOR(InductionTemplate);
+
+  /** the placeholder predicate */
+  unsigned placeholder;
+  /** variable replacing the inducted term in the conclusion of the schema */
+  unsigned conclusionVar;
+  /** the clauses of the schemas, kept alive by the template */
+  Stack<Clause*> clauses;
+  /** the schemas with the placeholder predicate */
+  Stack<Formula*> hypotheses;
+  /** for each clause the index of its schema in hypotheses */
+  Stack<unsigned> clauseHypotheses;
+  /** skolem functions introduced by the clausification of the schema */
+  Stack<unsigned> functions;
+  /** fresh predicates used in the schema */
+  Stack<unsigned> predicates;
+};
+
+/**
+ * An instantiation of an InductionTemplate, shared by the inferences of
+ * its clauses
+ */
+struct InductionInstance
+{
+  CLASS_NAME(InductionInstance);
+  USE_ALLOCATOR(InductionInstance);
+
+  InductionInstance(InductionTemplate* templ, Literal* clit, Term* term)
+    : templ(templ), clit(clit), term(term) {}
+
+  FormulaUnit* hypothesis(unsigned index);
+
+  InductionTemplate* templ;
+  /** the complement of the literal being inducted on */
+  Literal* clit;
+  /** the inducted term */
+  Term* term;
+  /** the fresh predicates of the instance for the predicates of the template */
+  DHMap<unsigned,unsigned> predicates;
+  /** the instantiated schemas, built by hypothesis() when a proof is output */
+  Stack<FormulaUnit*> hypotheses;
+};
+
+/**
+ * The inference of a clause instantiated from a template clause
+ *
+ * The premise is the template clause. When a proof is output,
+ * minimizePremises() replaces it by the instantiated schema, so that
+ * the clause appears as a clausification of its induction hypothesis.
+ */
+class InductionInstanceInference
+: public Inference1
+{
+public:
+  InductionInstanceInference(Clause* templClause, SmartPtr<InductionInstance> instance, unsigned hypothesis);
+
+  virtual void minimizePremises() override;
+
+  CLASS_NAME(InductionInstanceInference);
+  USE_ALLOCATOR(InductionInstanceInference);
+
+private:
+  SmartPtr<InductionInstance> _instance;
+  /** index of the schema of the clause in InductionTemplate::hypotheses */
+  unsigned _hypothesis;
+  bool _materialized;
+};
+
 class Induction
 : public GeneratingInferenceEngine
 {
@@ -85,6 +205,12 @@ private:
   void performStructInductionTwo(Clause* premise, Literal* lit, Term* t);
   void performStructInductionThree(Clause* premise, Literal* lit, Term* t);
 
+  InductionTemplate* mathInductionOneTemplate();
+  InductionTemplate* structInductionOneTemplate(Shell::TermAlgebra* ta);
+  InductionTemplate* structInductionTwoTemplate(Shell::TermAlgebra* ta);
+  InductionTemplate* structInductionThreeTemplate(Shell::TermAlgebra* ta);
+  void instantiate(InductionTemplate* templ, Literal* clit, Term* term, Stack<Clause*>& res);
+
   bool notDone(Literal* lit, Term* t);
 
   Stack<Clause*> _clauses;
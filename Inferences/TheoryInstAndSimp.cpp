@@ -29,6 +29,7 @@
 
 #include "Lib/Environment.hpp"
 #include "Lib/Metaiterators.hpp"
+#include "Lib/Sort.hpp"
 #include "Lib/VirtualIterator.hpp"
 
 #include "Kernel/Clause.hpp"
@@ -66,6 +67,37 @@ using namespace Saturation;
 using namespace SAT;
 
 
+TheoryInstAndSimp::TheoryInstAndSimp()
+  : _splitter(0)
+{
+  CALL("TheoryInstAndSimp::TheoryInstAndSimp");
+
+  BYPASSING_ALLOCATOR;
+  _solver = new Z3Interfacing(*env.options,_naming);
+}
+
+TheoryInstAndSimp::~TheoryInstAndSimp()
+{
+  CALL("TheoryInstAndSimp::~TheoryInstAndSimp");
+
+  clearQueryResults();
+  {
+    BYPASSING_ALLOCATOR;
+    delete _solver;
+  }
+}
+
+void TheoryInstAndSimp::clearQueryResults()
+{
+  CALL("TheoryInstAndSimp::clearQueryResults");
+
+  DHMap<vstring,QueryResult*>::Iterator rit(_queryResults);
+  while(rit.hasNext()){
+    delete rit.next();
+  }
+  _queryResults.reset();
+}
+
 void TheoryInstAndSimp::attach(SaturationAlgorithm* salg)
 {
   CALL("Superposition::attach");
@@ -614,6 +646,62 @@ Term* getFreshConstant(unsigned index, unsigned srt)
   return (*sortedConstants)[index];
 }
 
+/**
+ * Assert the literals of @b query in a scope of its own, solve it and
+ * save the outcome into @b res, including the values of @b constants
+ * in the model if it is satisfiable
+ */
+void TheoryInstAndSimp::runQuery(SATLiteralStack& query, Stack<Term*>& constants, bool guarded, QueryResult& res)
+{
+  CALL("TheoryInstAndSimp::runQuery");
+
+  BYPASSING_ALLOCATOR;
+
+  _solver->push();
+
+  SATLiteralStack::Iterator qit(query);
+  while(qit.hasNext()){
+    static SATLiteralStack satLits;
+    satLits.reset();
+    satLits.push(qit.next());
+    SATClause* sc = SATClause::fromStack(satLits);
+    // guarded is normally true, apart from when we are checking a theory tautology
+    try{
+      _solver->addClause(sc,guarded);
+    }
+    catch(UninterpretedForZ3Exception){
+      _solver->pop();
+      return;
+    }
+  }
+
+  // now we can call the solver
+  SATSolver::Status status = _solver->solve(UINT_MAX);
+
+  if(status == SATSolver::UNSATISFIABLE){
+#if DPRINT
+    cout << "z3 says unsat" << endl;
+#endif
+    res.unsat = true;
+  }
+  else if(status == SATSolver::SATISFIABLE){
+    for(unsigned i=0;i<constants.size();i++){
+      Term* t = _solver->evaluateInModel(constants[i]);
+      // If we could evaluate the term in the model then bind it
+      if(!t){
+        // Failed to obtain a value; could be an algebraic number or some other currently unhandled beast...
+        env.statistics->theoryInstSimpLostSolution++;
+        res.model.reset();
+        break;
+      }
+      res.model.push(t);
+    }
+  }
+  // otherwise SMT solving was incomplete
+
+  _solver->pop();
+}
+
 VirtualIterator<Solution> TheoryInstAndSimp::getSolutions(Stack<Literal*>& theoryLiterals, bool guarded){
   CALL("TheoryInstAndSimp::getSolutions");
 
@@ -621,13 +709,6 @@ VirtualIterator<Solution> TheoryInstAndSimp::getSolutions(Stack<Literal*>& theor
 
   // Currently we just get the single solution from Z3
 
-  // We use a new SMT solver
-  // currently these are not needed outside of this function so we put them here
-  static SAT2FO naming;
-  static Z3Interfacing solver(*env.options,naming);
-  solver.reset(); // the solver will reset naming
-
-
   // Firstly, we need to consistently replace variables by constants (i.e. Skolemize)
   // Secondly, we take the complement of each literal and consider the conjunction
   // This subst is for the consistent replacement
@@ -635,7 +716,10 @@ VirtualIterator<Solution> TheoryInstAndSimp::getSolutions(Stack<Literal*>& theor
 
   Stack<Literal*>::Iterator it(theoryLiterals);
   Stack<unsigned> vars;
-  unsigned used = 0;
+  static SATLiteralStack query;
+  static Stack<Term*> constants;
+  query.reset();
+  constants.reset();
   while(it.hasNext()){
     // get the complementary of the literal
     Literal* lit = Literal::complementaryLiteral(it.next());
@@ -648,12 +732,13 @@ VirtualIterator<Solution> TheoryInstAndSimp::getSolutions(Stack<Literal*>& theor
       unsigned sort = srtMap.get(var);
       TermList fc;
       if(!subst.findBinding(var,fc)){
-        Term* fc = getFreshConstant(used++,sort);
+        Term* fc = getFreshConstant(vars.size(),sort);
 #if DPRINT
     cout << "bind " << var << " to " << fc->toString() << endl;
 #endif
         subst.bind(var,fc);
         vars.push(var);
+        constants.push(fc);
       }
     }
 #if DPRINT
@@ -667,65 +752,56 @@ VirtualIterator<Solution> TheoryInstAndSimp::getSolutions(Stack<Literal*>& theor
 #endif
 
     // register the lit in naming in such a way that the solver will pick it up!
-    SATLiteral slit = naming.toSAT(lit);
+    query.push(_naming.toSAT(lit));
+  }
 
-    // now add the SAT representation
-    static SATLiteralStack satLits;
-    satLits.reset();
-    satLits.push(slit);
-    SATClause* sc = SATClause::fromStack(satLits);
-    //clause->setInference(new FOConversionInference(cl));
-    // guarded is normally true, apart from when we are checking a theory tautology
-    try{
-      solver.addClause(sc,guarded);
+  vstring key = guarded ? "g" : "u";
+  {
+    static Stack<unsigned> contents;
+    contents.reset();
+    SATLiteralStack::Iterator qit(query);
+    while(qit.hasNext()){
+      contents.push(qit.next().content());
     }
-    catch(UninterpretedForZ3Exception){
-      return VirtualIterator<Solution>::getEmpty();
+    sort<DefaultComparator>(contents.begin(),contents.end());
+    Stack<unsigned>::Iterator cit(contents);
+    while(cit.hasNext()){
+      key += "," + Int::toString(cit.next());
     }
   }
 
-  // now we can call the solver
-  SATSolver::Status status = solver.solve(UINT_MAX);
+  if(_queryResults.size()>=QUERY_RESULTS_LIMIT){
+    // the same queries mostly come in close succession, so it is enough to start over
+    clearQueryResults();
+    RSTAT_CTR_INC("theory instantiation query cache flushes");
+  }
+  QueryResult** res;
+  if(_queryResults.getValuePtr(key,res,0)){
+    *res = new QueryResult();
+    runQuery(query,constants,guarded,**res);
+  }
+  else{
+    RSTAT_CTR_INC("theory instantiation queries answered from cache");
+  }
 
-  if(status == SATSolver::UNSATISFIABLE){
-#if DPRINT
-    cout << "z3 says unsat" << endl;
-#endif
+  if((*res)->unsat){
     return pvi(getSingletonIterator(Solution(false)));
   }
-  else if(status == SATSolver::SATISFIABLE){
-    Solution sol = Solution(true);
-    Stack<unsigned>::Iterator vit(vars);
-    while(vit.hasNext()){
-      unsigned v = vit.next();
-      Term* t = subst.apply(v).term();
-      ASS(t);
-      //cout << v << ": " << t->toString() << endl;
-      t = solver.evaluateInModel(t);
-      // If we could evaluate the term in the model then bind it
-      if(t){
-        //cout << "evaluate to " << t->toString() << endl;
-        sol.subst.bind(v,t);
-      } else {
-        // Failed to obtain a value; could be an algebraic number or some other currently unhandled beast...
-        env.statistics->theoryInstSimpLostSolution++;
-        goto fail;
-      }
-    }
+  if((*res)->model.isEmpty() || (*res)->model.size()!=vars.size()){
 #if DPRINT
-    cout << "solution with " << sol.subst.toString() << endl;
+    cout << "no solution" << endl;
 #endif
-    return pvi(getSingletonIterator(sol));
+    return VirtualIterator<Solution>::getEmpty();
   }
 
-  fail:
-#if DRPINT
-    cout << "no solution" << endl;
+  Solution sol = Solution(true);
+  for(unsigned i=0;i<vars.size();i++){
+    sol.subst.bind(vars[i],(*res)->model[i]);
+  }
+#if DPRINT
+  cout << "solution with " << sol.subst.toString() << endl;
 #endif
-
-  // SMT solving was incomplete
-  return VirtualIterator<Solution>::getEmpty();
-
+  return pvi(getSingletonIterator(sol));
 }
 
 
@@ -30,6 +30,12 @@
 #include "Forwards.hpp"
 #include "InferenceEngine.hpp"
 #include "Kernel/Substitution.hpp"
+#include "Lib/DHMap.hpp"
+#include "SAT/SAT2FO.hpp"
+
+namespace SAT {
+class Z3Interfacing;
+}
 
 namespace Inferences
 {
@@ -51,7 +57,9 @@ public:
   CLASS_NAME(TheoryInstAndSimp);
   USE_ALLOCATOR(TheoryInstAndSimp);
 
-  TheoryInstAndSimp() : _splitter(0) {}
+  TheoryInstAndSimp();
+  ~TheoryInstAndSimp();
+
   void attach(SaturationAlgorithm* salg);
 
   ClauseIterator generateClauses(Clause* premise, bool& premiseRedundant);
@@ -63,6 +71,24 @@ public:
   VirtualIterator<Solution> getSolutions(Stack<Literal*>& theoryLiterals,bool guarded=true);
 
 private:
+  /** Outcome of an SMT query, see getSolutions() */
+  struct QueryResult
+  {
+    CLASS_NAME(TheoryInstAndSimp::QueryResult);
+    USE_ALLOCATOR(QueryResult);
+
+    QueryResult() : unsat(false) {}
+
+    bool unsat;
+    /** values of the fresh constants in the model, empty if there is no usable model */
+    Stack<Term*> model;
+  };
+
+  void runQuery(SAT::SATLiteralStack& query, Stack<Term*>& constants, bool guarded, QueryResult& res);
+  void clearQueryResults();
+
+  /** number of query results kept before the cache is cleared */
+  static const unsigned QUERY_RESULTS_LIMIT = 10000;
 
   void selectTheoryLiterals(Clause* cl, Stack<Literal*>& theoryLits);
 
@@ -101,8 +127,25 @@ private:
   bool literalContainsVar(const Literal* lit, unsigned v);
 
   Splitter* _splitter;
-  //SAT2F0 _naming;
-  //Z3Interfacing* _solver;
+
+  /**
+   * The SMT solver is kept for the whole run and each query is
+   * asserted in a scope of its own, so the declarations and the
+   * lemmas learned at the base level are reused by the later queries.
+   * The naming is never reset either, which makes the SAT literals of
+   * the queries stable.
+   */
+  SAT::SAT2FO _naming;
+  SAT::Z3Interfacing* _solver;
+
+  /**
+   * Results of the queries so far. A query is identified by its SAT
+   * literals and by whether it was guarded, and the fresh constants
+   * substituted for the variables are allocated in a fixed order, so
+   * clauses whose theory literals are the same up to variable renaming
+   * share the query. Cleared when it reaches QUERY_RESULTS_LIMIT entries.
+   */
+  DHMap<vstring,QueryResult*> _queryResults;
 
 };
 
@@ -35,6 +35,7 @@
 
 #include "Kernel/Clause.hpp"
 #include "Kernel/Inference.hpp"
+#include "Kernel/Matcher.hpp"
 #include "Kernel/Problem.hpp"
 #include "Kernel/RCClauseStack.hpp"
 #include "Kernel/SortHelper.hpp"
@@ -89,7 +90,7 @@ IGAlgorithm::IGAlgorithm(Problem& prb,const Options& opt)
     _selector = LiteralSelector::getSelector(*_ordering, opt, opt.instGenSelection());
   }
 
-  // _use_dm = opt.useDM();
+  _incremental = opt.instGenIncremental();
   _use_niceness = (opt.satVarSelector() == Options::SatVarSelector::NICENESS);
 
   _passive.setAgeWeightRatio(_opt.ageRatio(), _opt.weightRatio());
@@ -128,6 +129,7 @@ IGAlgorithm::IGAlgorithm(Problem& prb,const Options& opt)
     _variantIdx = new SubstitutionTreeClauseVariantIndex();
   }
   _selected = new LiteralSubstitutionTree();
+  _dismatchIndex = _incremental ? new LiteralSubstitutionTree() : 0;
 
   _doingSatisfiabilityCheck = false;
 }
@@ -136,6 +138,11 @@ IGAlgorithm::~IGAlgorithm()
 {
   CALL("IGAlgorithm::~IGAlgorithm");
 
+  clearDismatchingConstraints();
+  if (_dismatchIndex) {
+    delete _dismatchIndex;
+  }
+
   delete _selected;
   delete _variantIdx;
   delete _satSolver;
@@ -306,7 +313,7 @@ void IGAlgorithm::processUnprocessed()
 
     // sc could have been a tautology, in which case sc == 0 after the removeDuplicateLiterals call
     if (sc) {
-      _satSolver->addClause(sc);
+      _satSolver->addDisposableClause(sc);
     }
   }
 
@@ -323,13 +330,82 @@ bool IGAlgorithm::isSelected(Literal* lit)
   return _satSolver->trueInAssignment(_gnd->groundLiteral(lit,_use_niceness));
 }
 
+IGAlgorithm::DismatchingConstraints::DismatchingConstraints(Clause* cl)
+: cl(cl)
+{
+  CALL("IGAlgorithm::DismatchingConstraints::DismatchingConstraints");
+
+  lits.loadFromIterator(Clause::Iterator(*cl));
+}
+
+/**
+ * Record the instance @c inst, whose literals follow the order of @b lits,
+ * and put its first literal into @b index unless it is there already
+ */
+void IGAlgorithm::DismatchingConstraints::add(const LiteralStack& inst, LiteralIndexingStructure& index)
+{
+  CALL("IGAlgorithm::DismatchingConstraints::add");
+  ASS_EQ(inst.size(),lits.size());
+
+  unsigned* last;
+  if(lastWithFirst.getValuePtr(inst[0],last)) {
+    index.insert(inst[0],cl);
+    prevWithFirst.push(-1);
+  }
+  else {
+    prevWithFirst.push(*last);
+  }
+  *last = instances.size();
+  instances.push(inst);
+}
+
+/**
+ * Return true if @c inst (with literals following the order of @b lits)
+ * is an instance of some of the recorded instances.
+ */
+bool IGAlgorithm::DismatchingConstraints::shouldBlock(const LiteralStack& inst, LiteralIndexingStructure& index)
+{
+  CALL("IGAlgorithm::DismatchingConstraints::shouldBlock");
+  ASS_EQ(inst.size(),lits.size());
+
+  typedef DHMap<unsigned,TermList,IdentityHash> BindingMap;
+  static BindingMap bindings;
+  static MatchingUtils::MapRefBinder<BindingMap> binder(bindings);
+
+  unsigned len = inst.size();
+  SLQueryResultIterator git = index.getGeneralizations(inst[0],false,false);
+  while(git.hasNext()) {
+    SLQueryResult gen = git.next();
+    if(gen.clause!=cl) {
+      continue;
+    }
+    for(int idx = lastWithFirst.get(gen.literal); idx!=-1; idx = prevWithFirst[idx]) {
+      const LiteralStack& base = instances[idx];
+      binder.reset();
+      unsigned i = 0;
+      for(; i<len; i++) {
+        // all the literals must be matched by a single substitution
+        if(!Literal::headersMatch(base[i],inst[i],false) ||
+            (base[i]->arity() && !MatchingUtils::matchArgs(base[i],inst[i],binder))) {
+          break;
+        }
+      }
+      if(i==len) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 /**
  * Instantiate literals of @c orig using substitution @c subst,
  * and store the instance literals in genLits.
  * Either query or result part of the substitution @c subst is used, based on the
  * value of @c isQuery.
  *
- * Returns false if the generation of the clause was blocked due to dismatching constraints.
+ * Returns false if the generation of the clause was blocked due to dismatching constraints
+ * (these are only used in the incremental mode).
  * Even if true is returned, @c properInstance can still be set to false,
  * if the subst is not a proper instantiator of orig,
  * in which case the clause generation should be abandoned.
@@ -344,42 +420,36 @@ bool IGAlgorithm::startGeneratingClause(Clause* orig, ResultSubstitution& subst,
 
   genLits.reset();
 
-  /*
-  // We check and update the dismatching constraints associated
+  // We check the dismatching constraints associated
   // with the clause being instantiated
-  DismatchingContraints* dmatch = 0;
-  if(_use_dm){
-    TimeCounter tc(TC_DISMATCHING);
+  DismatchingConstraints* dmatch = 0;
+  if(_incremental) {
     _dismatchMap.find(orig,dmatch);
   }
-  */
 
+  // with dismatching constraints, genLits follow the literal order stored in them
   unsigned clen = orig->length();
   Literal* origLitGnd = 0;
   for(unsigned i=0; i<clen; i++) {
-    Literal* olit = (*orig)[i];
+    Literal* olit = dmatch ? dmatch->lits[i] : (*orig)[i];
     Literal* glit = isQuery ? subst.applyToQuery(olit) : subst.applyToResult(olit);
 
     if (olit == origLit) {
       origLitGnd = glit;
     }
 
-    /*
-    {
-      TimeCounter tc(TC_DISMATCHING);
-      // check dismatching constraint here
-      if (dmatch && dmatch->shouldBlock(olit,glit)) {
-        RSTAT_CTR_INC("dismatch blocked");
+    genLits.push(glit);
+  }
+
+  if(dmatch) {
+    TimeCounter tc(TC_DISMATCHING);
+    if(dmatch->shouldBlock(genLits,*_dismatchIndex)) {
+      RSTAT_CTR_INC("dismatch blocked");
 #if VTRACE_DM
-        cout << "[" << dmatch << "] " << "blocking for " << orig->number() << " and " << glit->toString() << endl;
-        cout << "block with origLit : " << (olit==origLit) << endl;
+      cout << "blocking for " << orig->number() << " and " << origLitGnd->toString() << endl;
 #endif
-        return false;
-      }
+      return false;
     }
-    */
-
-    genLits.push(glit);
   }
 
   ASS_NEQ(origLitGnd,0);
@@ -405,34 +475,26 @@ void IGAlgorithm::finishGeneratingClause(Clause* orig, ResultSubstitution& subst
   res->setAge(newAge);
 
   env.statistics->instGenGeneratedClauses++;
-  bool added = addClause(res);
-  (void)added;
+  addClause(res);
 
-  /*
-  //Update dismatch constraints
-  if(added && _use_dm) {
+  // Further instances of orig which are instances of res are now redundant.
+  // (We record the constraint even if res was not kept, since then
+  // res was either a tautology or a variant of a clause we already have.)
+  if(_incremental) {
     TimeCounter tc(TC_DISMATCHING);
 
-    DismatchingContraints* dmatch = 0;
+    DismatchingConstraints* dmatch = 0;
 
-    // if dmatch does not exist create it 
+    // if dmatch does not exist create it
     if(!_dismatchMap.find(orig,dmatch)) {
       RSTAT_CTR_INC("dismatch created");
 
-      dmatch = new DismatchingContraints();
+      dmatch = new DismatchingConstraints(orig);
       ALWAYS(_dismatchMap.insert(orig,dmatch));
-#if VTRACE_DM
-      cout << "[" << dmatch << "] "<< "creating for " << orig->toString() << endl;
-#endif
+      orig->incRefCnt();
     }
-
-    Literal* dm_with = isQuery ? subst.applyToQuery(origLit) : subst.applyToResult(origLit);
-#if VTRACE_DM
-      cout << "[" << dmatch << "] "<< "dismatch " << orig->number() << " add " << dm_with->toString() << endl;
-#endif
-    dmatch->add(origLit,dm_with);
+    dmatch->add(genLits,*_dismatchIndex);
   }
-  */
 }
 
 /**
@@ -460,27 +522,29 @@ void IGAlgorithm::tryGeneratingInstances(Clause* cl, unsigned litIdx)
     bool properInstance1;
     bool properInstance2;
 
-    if (startGeneratingClause(cl, *unif.substitution, true, unif.clause,lit,genLits1,properInstance1) &&
-        startGeneratingClause(unif.clause, *unif.substitution, false, cl,unif.literal,genLits2,properInstance2)) {
-
-      // dismatching test passed for both
+    // an instance blocked by dismatching constraints is treated as improper
+    if (!startGeneratingClause(cl, *unif.substitution, true, unif.clause,lit,genLits1,properInstance1)) {
+      properInstance1 = false;
+    }
+    if (!startGeneratingClause(unif.clause, *unif.substitution, false, cl,unif.literal,genLits2,properInstance2)) {
+      properInstance2 = false;
+    }
 
-      if(unif.clause->length()==1) {
-        //we make sure the unit is added first, so that it can be used to shorten the
-        //second clause by global subsumption
-        if (properInstance2) {
-          finishGeneratingClause(unif.clause, *unif.substitution, false, cl,unif.literal,genLits2);
-        }
-        if (properInstance1) {
-          finishGeneratingClause(cl, *unif.substitution, true, unif.clause,lit,genLits1);
-        }
-      } else {
-        if (properInstance1) {
-          finishGeneratingClause(cl, *unif.substitution, true, unif.clause,lit,genLits1);
-        }
-        if (properInstance2) {
-          finishGeneratingClause(unif.clause, *unif.substitution, false, cl,unif.literal,genLits2);
-        }
+    if(unif.clause->length()==1) {
+      //we make sure the unit is added first, so that it can be used to shorten the
+      //second clause by global subsumption
+      if (properInstance2) {
+        finishGeneratingClause(unif.clause, *unif.substitution, false, cl,unif.literal,genLits2);
+      }
+      if (properInstance1) {
+        finishGeneratingClause(cl, *unif.substitution, true, unif.clause,lit,genLits1);
+      }
+    } else {
+      if (properInstance1) {
+        finishGeneratingClause(cl, *unif.substitution, true, unif.clause,lit,genLits1);
+      }
+      if (properInstance2) {
+        finishGeneratingClause(unif.clause, *unif.substitution, false, cl,unif.literal,genLits2);
       }
     }
   }
@@ -626,7 +690,7 @@ void IGAlgorithm::onResolutionClauseDerived(Clause* cl)
 
   // sc could have been a tautology, in which case sc == 0 after the removeDuplicateLiterals call
   if (sc) {
-    _satSolver->addClause(sc);
+    _satSolver->addDisposableClause(sc);
   }
 
   if(_satSolver->solve(true)==SATSolver::UNSATISFIABLE) {
@@ -764,6 +828,32 @@ void IGAlgorithm::wipeIndexes()
     _variantIdx = new SubstitutionTreeClauseVariantIndex();
   }
   _selected = new LiteralSubstitutionTree();
+
+  // the dismatching constraints are indexed in _dismatchIndex,
+  // so they go together with it
+  clearDismatchingConstraints();
+  if (_dismatchIndex) {
+    delete _dismatchIndex;
+  }
+  _dismatchIndex = _incremental ? new LiteralSubstitutionTree() : 0;
+}
+
+/**
+ * Delete the dismatching constraints and release their clauses
+ */
+void IGAlgorithm::clearDismatchingConstraints()
+{
+  CALL("IGAlgorithm::clearDismatchingConstraints");
+
+  DismatchMap::Iterator dmit(_dismatchMap);
+  while(dmit.hasNext()) {
+    Clause* cl;
+    DismatchingConstraints* dmatch;
+    dmit.next(cl,dmatch);
+    delete dmatch;
+    cl->decRefCnt();
+  }
+  _dismatchMap.reset();
 }
 
 
@@ -823,6 +913,34 @@ void IGAlgorithm::restartFromBeginning()
   }
 }
 
+/**
+ * Used in the incremental mode instead of restarts: activate again
+ * all the active clauses whose selected literals are no longer
+ * true in the current model (deselection is otherwise discovered
+ * only lazily, when generating instances with them).
+ *
+ * Return true if this lead to new clauses being generated.
+ */
+bool IGAlgorithm::reconsiderActiveSelection()
+{
+  CALL("IGAlgorithm::reconsiderActiveSelection");
+
+  RCClauseStack::Iterator ait(_active);
+  while(ait.hasNext()) {
+    Clause* cl = ait.next();
+    unsigned selCnt = cl->numSelected();
+    for(unsigned i=0; i<selCnt; i++) {
+      if(!isSelected((*cl)[i])) {
+        RSTAT_CTR_INC("inst_gen reselected clauses");
+        deactivate(cl);
+        break;
+      }
+    }
+  }
+
+  doImmediateReactivation();
+  return _unprocessed.isNonEmpty();
+}
 
 MainLoopResult IGAlgorithm::runImpl()
 {
@@ -843,7 +961,8 @@ MainLoopResult IGAlgorithm::runImpl()
 
   int restartKindRatio = 0;
 
-  unsigned loopIterBeforeRestart = _opt.instGenRestartPeriod();
+  // in the incremental mode we never restart
+  unsigned loopIterBeforeRestart = _incremental ? 0 : _opt.instGenRestartPeriod();
 
   for(;;) {
     bool restarting = false;
@@ -897,6 +1016,14 @@ MainLoopResult IGAlgorithm::runImpl()
 	  loopIterBeforeRestart*_opt.instGenRestartPeriodQuotient()));
 
     }
+    else if(_incremental) {
+      //we're here because there were no more clauses to activate,
+      //all we need to check is that the selection agrees with the current model
+      ASS(_unprocessed.isEmpty());
+      if(!reconsiderActiveSelection()) {
+        return onModelFound();
+      }
+    }
     else {
       //we're here because there were no more clauses to activate
       restartWithCurrentClauses();
@@ -90,9 +90,11 @@ private:
 
   void restartWithCurrentClauses();
   void restartFromBeginning();
+  bool reconsiderActiveSelection();
 
 
   void wipeIndexes();
+  void clearDismatchingConstraints();
 
   void processUnprocessed();
   void activate(Clause* cl, bool wasDeactivated=false);
@@ -177,47 +179,54 @@ private:
   DistinctEqualitySimplifier _distinctEqualitySimplifier;
 
   bool _use_niceness;
-  /*
-  bool _use_dm;
-
-  // A struct for holding clause's dms, on per literal basis.
-  struct DismatchingContraints {
-    CLASS_NAME(IGAlgorithm::DismatchingContraints);
-    USE_ALLOCATOR(DismatchingContraints);
-
-    typedef DHMap<Literal*,DismatchingLiteralIndex*> Lit2Index;
-
-    Lit2Index lit2index;
-
-    void add(Literal* orig, Literal* inst) {
-      DismatchingLiteralIndex* index;
-      if (!lit2index.find(orig,index)) {
-        LiteralIndexingStructure * is = new LiteralSubstitutionTreeWithoutTop();
-        index = new DismatchingLiteralIndex(is); // takes care of deleting is
-        ALWAYS(lit2index.insert(orig,index));
-      }
-      index->addLiteral(inst);
-    }
-
-    bool shouldBlock(Literal* orig, Literal* inst) {
-      DismatchingLiteralIndex* index;
-      // if we store for orig a generalization of its instance inst, we block:
-      return lit2index.find(orig,index) && index->getGeneralizations(inst,false,false).hasNext();
-    }
-
-    ~DismatchingContraints() {
-      Lit2Index::Iterator iit(lit2index);
-      while(iit.hasNext()){
-        DismatchingLiteralIndex* index = iit.next();
-        delete index;
-      }
-    }
+
+  /**
+   * True if we keep all the generated clauses and the SAT solver
+   * state for the whole run instead of restarting
+   * (the inst_gen_incremental option)
+   */
+  bool _incremental;
+
+  /**
+   * Dismatching constraints of a clause C (used in the incremental mode).
+   *
+   * For every instance C\sigma generated so far we store the images of
+   * the literals of C under \sigma. A further instance C\theta is blocked
+   * if it is an instance of some stored C\sigma w.r.t. the same literal
+   * correspondence, as it can then be obtained by instantiating C\sigma.
+   *
+   * Literals of C get reordered by selection, so the order of C's literals
+   * at the time the constraints were created is kept in @b lits and the
+   * stored instances follow this order.
+   *
+   * The first literals of the stored instances are indexed together with C
+   * in _dismatchIndex, so that only the instances whose first literal
+   * generalizes that of C\theta need to be matched.
+   */
+  struct DismatchingConstraints {
+    CLASS_NAME(IGAlgorithm::DismatchingConstraints);
+    USE_ALLOCATOR(DismatchingConstraints);
+
+    DismatchingConstraints(Clause* cl);
+
+    void add(const LiteralStack& inst, LiteralIndexingStructure& index);
+    bool shouldBlock(const LiteralStack& inst, LiteralIndexingStructure& index);
+
+    Clause* cl;
+    LiteralStack lits;
+    Stack<LiteralStack> instances;
+    /** for each first literal of the instances, the index of the last instance with it */
+    DHMap<Literal*,unsigned> lastWithFirst;
+    /** for each instance, the index of the previous one with the same first literal, or -1 */
+    Stack<int> prevWithFirst;
   };
 
-  typedef DHMap<Clause*,DismatchingContraints*> DismatchMap;
+  /** The keys are clauses we hold a reference to */
+  typedef DHMap<Clause*,DismatchingConstraints*> DismatchMap;
 
   DismatchMap _dismatchMap;
-  */
+  /** First literals of the instances in the dismatching constraints, with their clauses */
+  LiteralSubstitutionTree* _dismatchIndex;
 
   /**
    * The internal representation of all the clauses inside IG
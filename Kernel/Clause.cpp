@@ -77,14 +77,14 @@ Clause::Clause(unsigned length,InputType it,Inference* inf)
     _theoryDescendant(false),
     _inductionDepth(0),
     _numSelected(0),
+    _store(NONE),
     _age(0),
     _weight(0),
-    _store(NONE),
     _refCnt(0),
     _reductionTimestamp(0),
-    _literalPositions(0),
-    _splits(0),
     _numActiveSplits(0),
+    _splits(0),
+    _literalPositions(0),
     _auxTimestamp(0)
 {
 
@@ -584,7 +584,7 @@ unsigned Clause::getNumeralWeight()
       }
       IntegerConstantType intVal;
       if (theory->tryInterpretConstant(t,intVal)) {
-	int w = BitUtils::log2(abs(intVal.toInner()))-1;
+	int w = static_cast<int>(intVal.log2())-1;
 	if (w > 0) {
 	  res += w;
 	}
@@ -603,8 +603,8 @@ unsigned Clause::getNumeralWeight()
       if (!haveRat) {
 	continue;
       }
-      int wN = BitUtils::log2(abs(ratVal.numerator().toInner()))-1;
-      int wD = BitUtils::log2(abs(ratVal.denominator().toInner()))-1;
+      int wN = static_cast<int>(ratVal.numerator().log2())-1;
+      int wD = static_cast<int>(ratVal.denominator().log2())-1;
       int v = wN + wD;
       if (v > 0) {
 	res += v;
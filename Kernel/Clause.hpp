@@ -141,7 +141,7 @@ public:
   vstring toNiceString() const;
 
   /** Return the clause store */
-  Store store() const { return _store; }
+  Store store() const { return static_cast<Store>(_store); }
 
   void setStore(Store s);
 
@@ -288,7 +288,7 @@ public:
   bool tryGetAux(T*& ptr)
   {
     ASS(_auxInUse);
-    if(_auxTimestamp==_auxCurrTimestamp) {
+    if(hasAux()) {
       ptr=static_cast<T*>(_auxData);
       return true;
     }
@@ -299,7 +299,7 @@ public:
   T* getAux()
   {
     ASS(_auxInUse);
-    ASS(_auxTimestamp==_auxCurrTimestamp);
+    ASS(hasAux());
     return static_cast<T*>(_auxData);
   }
   bool hasAux()
@@ -344,6 +344,9 @@ public:
   unsigned maxVar(); // useful to create fresh variables w.r.t. the clause
 
 protected:
+  // The fields are ordered so that they fill the tail padding of Unit
+  // and leave no holes. Keep it this way when adding new ones.
+
   /** number of literals */
   unsigned _length : 20;
   /** clause color, or COLOR_INVALID if not determined yet */
@@ -364,22 +367,22 @@ protected:
   unsigned _inductionDepth : 5;
 
   /** number of selected literals */
-  unsigned _numSelected;
+  unsigned _numSelected : 20;
+  /** storage class, a value of Store */
+  unsigned _store : 3;
   /** age */
   unsigned _age;
   /** weight */
   mutable unsigned _weight;
-  /** storage class */
-  Store _store;
   /** number of references to this clause */
   unsigned _refCnt;
   /** for splitting: timestamp marking when has the clause been reduced or restored by splitting */
   unsigned _reductionTimestamp;
-  /** a map that translates Literal* to its index in the clause */
-  InverseLookup<Literal>* _literalPositions;
+  int _numActiveSplits;
 
   SplitSet* _splits;
-  int _numActiveSplits;
+  /** a map that translates Literal* to its index in the clause */
+  InverseLookup<Literal>* _literalPositions;
 
   size_t _auxTimestamp;
   void* _auxData;
@@ -342,7 +342,9 @@ public:
    * minimizing call to after
    * a complete refutation has been found.
    *
-   * This is meant to be a no-op for all inferences except those related to SAT.
+   * This is meant to be a no-op for all inferences except those related to SAT
+   * and those of instantiated induction templates, which build their premise
+   * here (see Inferences::InductionInstanceInference).
    */
   virtual void minimizePremises() {}
 
@@ -382,6 +384,7 @@ public:
   vstring extra() { return _extra; }
 
   unsigned maxDepth(){ return _maxDepth; }
+  void setMaxDepth(unsigned d){ _maxDepth=d; }
 
 protected:
   /** The rule used */
@@ -25,6 +25,7 @@
 #include "Lib/Int.hpp"
 
 #include "Signature.hpp"
+#include "SortHelper.hpp"
 #include "Sorts.hpp"
 #include "TermIterators.hpp"
 #include "Term.hpp"
@@ -171,6 +172,45 @@ public:
 };
 
 
+/**
+ * Evaluates sums up to AC, cancellation of summands and evaluation of
+ * numeric coefficients, e.g. (a+1)+(2-a) -> 3 or (2*a+b)+a -> 3*a+b.
+ *
+ * The sum is replaced by the term of its polynomial, see Kernel::Polynomial,
+ * only if that has fewer atom and numeral occurrences, so a sum that is
+ * already in its normal form up to the order of summands is kept as it is.
+ */
+class InterpretedLiteralEvaluator::PolynomialEvaluator
+   : public Evaluator
+{
+public:
+  CLASS_NAME(InterpretedLiteralEvaluator::PolynomialEvaluator);
+  USE_ALLOCATOR(InterpretedLiteralEvaluator::PolynomialEvaluator);
+
+  PolynomialEvaluator(unsigned plus, PolynomialCache& polynomials) : _plus(plus), _polynomials(polynomials) {}
+
+  virtual bool canEvaluateFunc(unsigned func) { return func == _plus; }
+
+  virtual bool tryEvaluateFunc(Term* trm, TermList& res) {
+    CALL("InterpretedLiteralEvaluator::PolynomialEvaluator::tryEvaluateFunc");
+    ASS_EQ(trm->functor(),_plus);
+
+    if (!trm->shared()) {
+      return false;
+    }
+    const Polynomial* p = _polynomials.get(trm);
+    if (p->canonicalLeaves() >= p->leaves()) {
+      return false;
+    }
+    res = p->toTerm();
+    return true;
+  }
+
+private:
+  unsigned _plus;
+  PolynomialCache& _polynomials;
+};
+
 /**
  * Interpreted equality has to be treated specially. We do not have separate
  * predicate symbols for different kinds of equality so the sorts must be 
@@ -566,10 +606,10 @@ class InterpretedLiteralEvaluator::IntEvaluator : public TypedEvaluator<IntegerC
 {
 protected:
 
-  virtual bool isZero(IntegerConstantType arg){ return arg.toInner()==0;}
+  virtual bool isZero(IntegerConstantType arg){ return arg.isZero();}
   virtual TermList getZero(){ return TermList(theory->representConstant(IntegerConstantType(0))); }
-  virtual bool isOne(IntegerConstantType arg){ return arg.toInner()==1;}
-  virtual bool isMinusOne(IntegerConstantType arg){ return arg.toInner()==-1;}
+  virtual bool isOne(IntegerConstantType arg){ return arg==1;}
+  virtual bool isMinusOne(IntegerConstantType arg){ return arg==-1;}
 
   virtual TermList invert(TermList t){ 
     unsigned um = env.signature->getInterpretingSymbol(Theory::INT_UNARY_MINUS);
@@ -936,6 +976,171 @@ protected:
 
 };
 
+////////////////////////////////
+// Ground evaluation
+//
+// Ground terms built from numerals and interpreted functions are evaluated
+// in one pass by InterpretedLiteralEvaluator::evaluateGround(), without
+// creating the intermediate terms.
+
+namespace {
+
+/**
+ * The value of a ground interpreted term. Rational and real values
+ * are both kept in @b rat, as the operations on reals are those on
+ * rationals.
+ */
+struct GroundValue
+{
+  GroundValue() : sort(Sorts::SRT_INTEGER) {}
+  explicit GroundValue(const IntegerConstantType& val) : sort(Sorts::SRT_INTEGER), integer(val) {}
+  GroundValue(unsigned srt, const RationalConstantType& val) : sort(srt), rat(val) {}
+
+  unsigned sort;
+  IntegerConstantType integer;
+  RationalConstantType rat;
+};
+
+/**
+ * Apply the interpreted function @b itp to @b args and save the value
+ * into @b res. Return false if the function cannot be evaluated.
+ *
+ * The semantics is the one of the evaluators above, an ArithmeticException
+ * is thrown for a division by zero.
+ */
+bool applyGroundOperation(Interpretation itp, const GroundValue* args, GroundValue& res)
+{
+  CALL("applyGroundOperation");
+
+  const IntegerConstantType& i1 = args[0].integer;
+  const RationalConstantType& r1 = args[0].rat;
+
+  switch(itp) {
+  case Theory::INT_UNARY_MINUS:
+    res = GroundValue(-i1);
+    return true;
+  case Theory::INT_ABS:
+    res = GroundValue(i1<0 ? -i1 : i1);
+    return true;
+  case Theory::INT_SUCCESSOR:
+    res = GroundValue(i1+1);
+    return true;
+  case Theory::INT_FLOOR:
+  case Theory::INT_CEILING:
+  case Theory::INT_TRUNCATE:
+  case Theory::INT_ROUND:
+    res = args[0];
+    return true;
+  case Theory::INT_PLUS:
+    res = GroundValue(i1+args[1].integer);
+    return true;
+  case Theory::INT_MINUS:
+    res = GroundValue(i1-args[1].integer);
+    return true;
+  case Theory::INT_MULTIPLY:
+    res = GroundValue(i1*args[1].integer);
+    return true;
+  case Theory::INT_QUOTIENT_E:
+    res = GroundValue(i1.quotientE(args[1].integer));
+    return true;
+  case Theory::INT_QUOTIENT_T:
+    res = GroundValue(i1.quotientT(args[1].integer));
+    return true;
+  case Theory::INT_QUOTIENT_F:
+    res = GroundValue(i1.quotientF(args[1].integer));
+    return true;
+  case Theory::INT_REMAINDER_E:
+    res = GroundValue(i1-(i1.quotientE(args[1].integer)*args[1].integer));
+    return true;
+  case Theory::INT_REMAINDER_T:
+    res = GroundValue(i1-(i1.quotientT(args[1].integer)*args[1].integer));
+    return true;
+  case Theory::INT_REMAINDER_F:
+    res = GroundValue(i1-(i1.quotientF(args[1].integer)*args[1].integer));
+    return true;
+
+  case Theory::RAT_UNARY_MINUS:
+  case Theory::REAL_UNARY_MINUS:
+    res = GroundValue(args[0].sort, -r1);
+    return true;
+  case Theory::RAT_FLOOR:
+  case Theory::REAL_FLOOR:
+    res = GroundValue(args[0].sort, r1.floor());
+    return true;
+  case Theory::RAT_CEILING:
+  case Theory::REAL_CEILING:
+    res = GroundValue(args[0].sort, r1.ceiling());
+    return true;
+  case Theory::RAT_TRUNCATE:
+  case Theory::REAL_TRUNCATE:
+    res = GroundValue(args[0].sort, r1.truncate());
+    return true;
+  case Theory::RAT_PLUS:
+  case Theory::REAL_PLUS:
+    res = GroundValue(args[0].sort, r1+args[1].rat);
+    return true;
+  case Theory::RAT_MINUS:
+  case Theory::REAL_MINUS:
+    res = GroundValue(args[0].sort, r1-args[1].rat);
+    return true;
+  case Theory::RAT_MULTIPLY:
+  case Theory::REAL_MULTIPLY:
+    res = GroundValue(args[0].sort, r1*args[1].rat);
+    return true;
+  case Theory::RAT_QUOTIENT:
+  case Theory::REAL_QUOTIENT:
+    res = GroundValue(args[0].sort, r1/args[1].rat);
+    return true;
+  case Theory::RAT_QUOTIENT_E:
+  case Theory::REAL_QUOTIENT_E:
+    res = GroundValue(args[0].sort, r1.quotientE(args[1].rat));
+    return true;
+  case Theory::RAT_QUOTIENT_T:
+  case Theory::REAL_QUOTIENT_T:
+    res = GroundValue(args[0].sort, r1.quotientT(args[1].rat));
+    return true;
+  case Theory::RAT_QUOTIENT_F:
+  case Theory::REAL_QUOTIENT_F:
+    res = GroundValue(args[0].sort, r1.quotientF(args[1].rat));
+    return true;
+  case Theory::RAT_REMAINDER_E:
+  case Theory::REAL_REMAINDER_E:
+    res = GroundValue(args[0].sort, r1-(r1.quotientE(args[1].rat)*args[1].rat));
+    return true;
+  case Theory::RAT_REMAINDER_T:
+  case Theory::REAL_REMAINDER_T:
+    res = GroundValue(args[0].sort, r1-(r1.quotientT(args[1].rat)*args[1].rat));
+    return true;
+  case Theory::RAT_REMAINDER_F:
+  case Theory::REAL_REMAINDER_F:
+    res = GroundValue(args[0].sort, r1-(r1.quotientF(args[1].rat)*args[1].rat));
+    return true;
+
+  case Theory::INT_TO_RAT:
+    res = GroundValue(Sorts::SRT_RATIONAL, RationalConstantType(i1,1));
+    return true;
+  case Theory::INT_TO_REAL:
+    res = GroundValue(Sorts::SRT_REAL, RationalConstantType(i1,1));
+    return true;
+  case Theory::RAT_TO_INT:
+  case Theory::REAL_TO_INT:
+    res = GroundValue(IntegerConstantType::floor(r1));
+    return true;
+  case Theory::RAT_TO_REAL:
+    res = GroundValue(Sorts::SRT_REAL, r1);
+    return true;
+  case Theory::REAL_TO_RAT:
+    //this is correct only as long as we only represent rational real numbers
+    res = GroundValue(Sorts::SRT_RATIONAL, r1);
+    return true;
+
+  default:
+    return false;
+  }
+}
+
+} // anonymous namespace
+
 ////////////////////////////////
 // InterpretedLiteralEvaluator
 //
@@ -958,28 +1163,22 @@ InterpretedLiteralEvaluator::InterpretedLiteralEvaluator()
   if(env.options->useACeval()){
 
   // Special AC evaluators are added to be tried first for Plus and Multiply
-  _evals.push(new ACFunEvaluator<IntegerConstantType>(
-		env.signature->getInterpretingSymbol(Theory::INT_PLUS),
-		new IntEvaluator(),
-		theory->representConstant(IntegerConstantType(0)))); 
+  _evals.push(new PolynomialEvaluator(
+		env.signature->getInterpretingSymbol(Theory::INT_PLUS), _polynomials));
   _evals.push(new ACFunEvaluator<IntegerConstantType>(
                 env.signature->getInterpretingSymbol(Theory::INT_MULTIPLY),
                 new IntEvaluator(),
                 theory->representConstant(IntegerConstantType(1))));
 
-  _evals.push(new ACFunEvaluator<RationalConstantType>(
-                env.signature->getInterpretingSymbol(Theory::RAT_PLUS),
-                new RatEvaluator(),
-                theory->representConstant(RationalConstantType(0))));
+  _evals.push(new PolynomialEvaluator(
+                env.signature->getInterpretingSymbol(Theory::RAT_PLUS), _polynomials));
   _evals.push(new ACFunEvaluator<RationalConstantType>(
                 env.signature->getInterpretingSymbol(Theory::RAT_MULTIPLY),
                 new RatEvaluator(),
                 theory->representConstant(RationalConstantType(1))));
 
-  _evals.push(new ACFunEvaluator<RealConstantType>(
-                env.signature->getInterpretingSymbol(Theory::REAL_PLUS),
-                new RealEvaluator(),
-                theory->representConstant(RealConstantType(RationalConstantType(0)))));
+  _evals.push(new PolynomialEvaluator(
+                env.signature->getInterpretingSymbol(Theory::REAL_PLUS), _polynomials));
   _evals.push(new ACFunEvaluator<RealConstantType>(
                 env.signature->getInterpretingSymbol(Theory::REAL_MULTIPLY),
                 new RealEvaluator(),
@@ -1049,6 +1248,147 @@ bool InterpretedLiteralEvaluator::balancable(Literal* lit)
   return true;
 }
 
+/**
+ * Compare the sides s and t of the arithmetic equality or inequality @b lit
+ * through the polynomial of s-t.
+ *
+ * If the polynomial is constant, the literal is decided, @b isConstant is
+ * set and the value is saved into @b resConst (non-ground literals are only
+ * decided when they are false). Otherwise the summands that
+ * cancel out are removed: the summands with positive coefficients go to the
+ * left and the negated ones with negative coefficients to the right, e.g.
+ * a+b+1 < b+3 becomes a < 2. The result is used only if it is smaller than
+ * @b lit. Return true if the literal was decided or changed.
+ */
+bool InterpretedLiteralEvaluator::cancelSummands(Literal* lit, Literal*& res, bool& isConstant, bool& resConst)
+{
+  CALL("InterpretedLiteralEvaluator::cancelSummands");
+
+  isConstant = false;
+  if (!lit->shared()) {
+    return false;
+  }
+
+  unsigned sort;
+  Interpretation itp = Theory::EQUAL;
+  if (lit->isEquality()) {
+    sort = SortHelper::getEqualityArgumentSort(lit);
+  }
+  else {
+    if (!theory->isInterpretedPredicate(lit->functor())) {
+      return false;
+    }
+    itp = theory->interpretPredicate(lit);
+    switch(itp) {
+    case Theory::INT_LESS:
+    case Theory::INT_LESS_EQUAL:
+    case Theory::INT_GREATER:
+    case Theory::INT_GREATER_EQUAL:
+    case Theory::RAT_LESS:
+    case Theory::RAT_LESS_EQUAL:
+    case Theory::RAT_GREATER:
+    case Theory::RAT_GREATER_EQUAL:
+    case Theory::REAL_LESS:
+    case Theory::REAL_LESS_EQUAL:
+    case Theory::REAL_GREATER:
+    case Theory::REAL_GREATER_EQUAL:
+      sort = theory->getOperationSort(itp);
+      break;
+    default:
+      return false;
+    }
+  }
+  if (!Polynomial::isPolynomialSort(sort)) {
+    return false;
+  }
+
+  TermList s = *lit->nthArgument(0);
+  TermList t = *lit->nthArgument(1);
+  if ((!s.isTerm() || !Polynomial::isLinearOperation(s.term(), sort)) &&
+      (!t.isTerm() || !Polynomial::isLinearOperation(t.term(), sort))) {
+    return false;
+  }
+
+  RationalConstantType one(IntegerConstantType(1));
+  RationalConstantType zero(IntegerConstantType(0));
+
+  Polynomial diff(sort);
+  unsigned leaves = _polynomials.add(s, one, diff);
+  leaves += _polynomials.add(t, -one, diff);
+  diff.normalize();
+
+  const RationalConstantType& c = diff.constant();
+  if (diff.isConstant()) {
+    switch(itp) {
+    case Theory::EQUAL:
+      resConst = c==zero;
+      break;
+    case Theory::INT_LESS:
+    case Theory::RAT_LESS:
+    case Theory::REAL_LESS:
+      resConst = c<zero;
+      break;
+    case Theory::INT_LESS_EQUAL:
+    case Theory::RAT_LESS_EQUAL:
+    case Theory::REAL_LESS_EQUAL:
+      resConst = c<=zero;
+      break;
+    case Theory::INT_GREATER:
+    case Theory::RAT_GREATER:
+    case Theory::REAL_GREATER:
+      resConst = c>zero;
+      break;
+    case Theory::INT_GREATER_EQUAL:
+    case Theory::RAT_GREATER_EQUAL:
+    case Theory::REAL_GREATER_EQUAL:
+      resConst = c>=zero;
+      break;
+    default:
+      ASSERTION_VIOLATION;
+    }
+    if (lit->isNegative()) {
+      resConst = !resConst;
+    }
+    if (resConst && !lit->ground()) {
+      // such as X<X+1, these are instances of theory axioms and deleting
+      // the clauses containing them makes the search lose useful lemmas
+      return false;
+    }
+    isConstant = true;
+    return true;
+  }
+
+  static Polynomial::MonomialStack left;
+  static Polynomial::MonomialStack right;
+  left.reset();
+  right.reset();
+  Polynomial::MonomialStack::BottomFirstIterator mit(diff.monomials());
+  while (mit.hasNext()) {
+    const Polynomial::Monomial& m = mit.next();
+    if (m.coeff>zero) {
+      left.push(m);
+    }
+    else {
+      right.push(Polynomial::Monomial(-m.coeff, m.atom));
+    }
+  }
+  RationalConstantType leftConst = c>zero ? c : zero;
+  RationalConstantType rightConst = c<zero ? -c : zero;
+  if (Polynomial::sumLeaves(left, leftConst)+Polynomial::sumLeaves(right, rightConst) >= leaves) {
+    return false;
+  }
+
+  TermList newS = Polynomial::sum(sort, left, leftConst);
+  TermList newT = Polynomial::sum(sort, right, rightConst);
+  if (lit->isEquality()) {
+    res = Literal::createEquality(lit->polarity(), newS, newT, sort);
+  }
+  else {
+    res = Literal::create2(lit->functor(), lit->polarity(), newS, newT);
+  }
+  return true;
+}
+
 /**
  * This attempts to 'balance' a literal i.e. put it into the form term=constant
  *
@@ -1340,6 +1680,15 @@ bool InterpretedLiteralEvaluator::evaluate(Literal* lit, bool& isConstant, Liter
   cout << "transformed " << resLit->toString() << endl;
 #endif
 
+  // Sums on both sides of an arithmetic comparison are compared as polynomials
+  if(env.options->useACeval()){
+    bool cancelledConst;
+    if(cancelSummands(resLit,resLit,cancelledConst,resConst) && cancelledConst){
+      isConstant = true;
+      return true;
+    }
+  }
+
   // If it can be balanced we balance it
   // A predicate on constants will not be balancable
   if(balancable(resLit)){
@@ -1422,6 +1771,119 @@ TermList InterpretedLiteralEvaluator::transformSubterm(TermList trm)
   return trm;
 }
 
+/**
+ * Evaluate the ground subterms built from numerals and interpreted
+ * functions in one go, see evaluateGround()
+ */
+bool InterpretedLiteralEvaluator::transformWholeSubterm(Term* trm, TermList& res)
+{
+  CALL("InterpretedLiteralEvaluator::transformWholeSubterm");
+
+  if (trm->arity()==0 || trm->isSpecial() || !trm->ground() || !theory->isInterpretedFunction(trm->functor())) {
+    return false;
+  }
+  return evaluateGround(trm, res);
+}
+
+/**
+ * Evaluate the shared ground term @b trm and save the numeral it is
+ * equal to into @b res. Return false if @b trm contains an uninterpreted
+ * symbol, an operation that cannot be evaluated, or a division by zero.
+ *
+ * The term is traversed once in post-order and the values of its subterms
+ * are kept on a stack, so the only term created is the resulting numeral.
+ * The results are memoised per term.
+ */
+bool InterpretedLiteralEvaluator::evaluateGround(Term* trm, TermList& res)
+{
+  CALL("InterpretedLiteralEvaluator::evaluateGround");
+  ASS(trm->shared());
+  ASS(trm->ground());
+
+  TermList* cached;
+  if (!_groundResults.getValuePtr(trm, cached)) {
+    res = *cached;
+    return res.term()!=trm;
+  }
+  // until we succeed
+  *cached = TermList(trm);
+
+  // a zero on todo marks that the arguments of the top of ops were evaluated
+  static Stack<Term*> todo;
+  static Stack<Term*> ops;
+  static Stack<GroundValue> values;
+  todo.reset();
+  ops.reset();
+  values.reset();
+
+  todo.push(trm);
+  try {
+    while (todo.isNonEmpty()) {
+      Term* t = todo.pop();
+      if (!t) {
+        Term* op = ops.pop();
+        unsigned arity = op->arity();
+        const GroundValue* args = values.end()-arity;
+        GroundValue val;
+        if (!applyGroundOperation(theory->interpretFunction(op), args, val)) {
+          return false;
+        }
+        values.truncate(values.size()-arity);
+        values.push(val);
+        continue;
+      }
+      if (t->isSpecial()) {
+        return false;
+      }
+      Signature::Symbol* sym = env.signature->getFunction(t->functor());
+      if (sym->integerConstant()) {
+        values.push(GroundValue(sym->integerValue()));
+        continue;
+      }
+      if (sym->rationalConstant()) {
+        values.push(GroundValue(Sorts::SRT_RATIONAL, sym->rationalValue()));
+        continue;
+      }
+      if (sym->realConstant()) {
+        values.push(GroundValue(Sorts::SRT_REAL, sym->realValue()));
+        continue;
+      }
+      if (t->arity()==0 || !theory->isInterpretedFunction(t->functor())) {
+        return false;
+      }
+      ops.push(t);
+      todo.push(0);
+      // the arguments are pushed last first, so that their values end up in order
+      for (unsigned i = t->arity(); i>0; i--) {
+        TermList* arg = t->nthArgument(i-1);
+        ASS(arg->isTerm());
+        todo.push(arg->term());
+      }
+    }
+  }
+  catch(ArithmeticException&) {
+    return false;
+  }
+
+  ASS_EQ(values.size(),1);
+  const GroundValue& val = values.top();
+  switch (val.sort) {
+  case Sorts::SRT_INTEGER:
+    res = TermList(theory->representConstant(val.integer));
+    break;
+  case Sorts::SRT_RATIONAL:
+    res = TermList(theory->representConstant(val.rat));
+    break;
+  case Sorts::SRT_REAL:
+    res = TermList(theory->representConstant(RealConstantType(val.rat)));
+    break;
+  default:
+    ASSERTION_VIOLATION;
+  }
+  *cached = res;
+  return true;
+}
+
 /**
  * This searches for an Evaluator for a function
  */
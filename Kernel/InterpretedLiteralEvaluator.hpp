@@ -27,8 +27,10 @@
 #include "Forwards.hpp"
 
 #include "Lib/DArray.hpp"
+#include "Lib/DHMap.hpp"
 #include "Lib/Stack.hpp"
 
+#include "Polynomial.hpp"
 #include "TermTransformer.hpp"
 #include "Theory.hpp"
 
@@ -50,6 +52,7 @@ protected:
   class EqualityEvaluator;
   class ConversionEvaluator;
   template<class T> class ACFunEvaluator;
+  class PolynomialEvaluator;
   template<class T> class TypedEvaluator;
   class IntEvaluator;
   class RatEvaluator;
@@ -57,12 +60,25 @@ protected:
 
   typedef Stack<Evaluator*> EvalStack;
   virtual TermList transformSubterm(TermList trm);
+  virtual bool transformWholeSubterm(Term* trm, TermList& res);
+  bool evaluateGround(Term* trm, TermList& res);
   Evaluator* getFuncEvaluator(unsigned func);
   Evaluator* getPredEvaluator(unsigned pred);
   EvalStack _evals;
   DArray<Evaluator*> _funEvaluators;
   DArray<Evaluator*> _predEvaluators;
 
+  /**
+   * Results of evaluateGround() for the shared terms it was called on,
+   * a term that could not be evaluated is mapped to itself
+   */
+  DHMap<Term*,TermList> _groundResults;
+
+  /** Polynomials of the arithmetic terms seen by the AC evaluation */
+  PolynomialCache _polynomials;
+
+  bool cancelSummands(Literal* lit, Literal*& res, bool& isConstant, bool& resConst);
+
   bool balancable(Literal* lit);
   bool balance(Literal* lit,Literal*& res,Stack<Literal*>& sideConditions);
   
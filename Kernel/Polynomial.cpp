@@ -0,0 +1,454 @@
+
+/*
+ * File Polynomial.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file Polynomial.cpp
+ * Implements classes Polynomial and PolynomialCache.
+ */
+
+#include "Lib/Environment.hpp"
+#include "Lib/Int.hpp"
+#include "Lib/Sort.hpp"
+
+#include "Signature.hpp"
+#include "Sorts.hpp"
+
+#include "Polynomial.hpp"
+
+namespace Kernel
+{
+
+namespace
+{
+
+/**
+ * Save the addition, unary minus and multiplication of @b sort
+ * into @b plus, @b uminus and @b multiply
+ */
+void getOperations(unsigned sort, Interpretation& plus, Interpretation& uminus, Interpretation& multiply)
+{
+  CALL("getOperations");
+
+  switch(sort) {
+  case Sorts::SRT_INTEGER:
+    plus = Theory::INT_PLUS;
+    uminus = Theory::INT_UNARY_MINUS;
+    multiply = Theory::INT_MULTIPLY;
+    return;
+  case Sorts::SRT_RATIONAL:
+    plus = Theory::RAT_PLUS;
+    uminus = Theory::RAT_UNARY_MINUS;
+    multiply = Theory::RAT_MULTIPLY;
+    return;
+  case Sorts::SRT_REAL:
+    plus = Theory::REAL_PLUS;
+    uminus = Theory::REAL_UNARY_MINUS;
+    multiply = Theory::REAL_MULTIPLY;
+    return;
+  default:
+    ASSERTION_VIOLATION;
+  }
+}
+
+bool tryInterpretNumeral(TermList t, unsigned sort, RationalConstantType& res)
+{
+  CALL("tryInterpretNumeral");
+
+  if (!t.isTerm()) {
+    return false;
+  }
+  switch(sort) {
+  case Sorts::SRT_INTEGER: {
+    IntegerConstantType val;
+    if (!theory->tryInterpretConstant(t.term(), val)) {
+      return false;
+    }
+    res = RationalConstantType(val);
+    return true;
+  }
+  case Sorts::SRT_RATIONAL:
+    return theory->tryInterpretConstant(t.term(), res);
+  case Sorts::SRT_REAL: {
+    RealConstantType val;
+    if (!theory->tryInterpretConstant(t.term(), val)) {
+      return false;
+    }
+    res = val;
+    return true;
+  }
+  default:
+    ASSERTION_VIOLATION;
+  }
+}
+
+TermList representNumeral(unsigned sort, const RationalConstantType& val)
+{
+  CALL("representNumeral");
+
+  switch(sort) {
+  case Sorts::SRT_INTEGER:
+    ASS(val.isInt());
+    return TermList(theory->representConstant(val.numerator()));
+  case Sorts::SRT_RATIONAL:
+    return TermList(theory->representConstant(val));
+  case Sorts::SRT_REAL:
+    return TermList(theory->representConstant(RealConstantType(val)));
+  default:
+    ASSERTION_VIOLATION;
+  }
+}
+
+}
+
+/**
+ * Orders variables by their numbers before terms ordered by their ids
+ */
+struct Polynomial::AtomComparator
+{
+  static Comparison compare(const Monomial& m1, const Monomial& m2)
+  {
+    TermList a1 = m1.atom;
+    TermList a2 = m2.atom;
+    if (a1.isVar()) {
+      if (!a2.isVar()) {
+        return LESS;
+      }
+      return Int::compare(a1.var(), a2.var());
+    }
+    if (a2.isVar()) {
+      return GREATER;
+    }
+    return Int::compare(a1.term()->getId(), a2.term()->getId());
+  }
+};
+
+Polynomial::Polynomial(unsigned sort)
+: _sort(sort), _constant(IntegerConstantType(0)), _leaves(0)
+{
+  CALL("Polynomial::Polynomial");
+  ASS(isPolynomialSort(sort));
+}
+
+bool Polynomial::isPolynomialSort(unsigned sort)
+{
+  return sort==Sorts::SRT_INTEGER || sort==Sorts::SRT_RATIONAL || sort==Sorts::SRT_REAL;
+}
+
+/**
+ * True if @b t is an addition, subtraction, unary minus, multiplication
+ * or (for integers) successor of sort @b sort
+ */
+bool Polynomial::isLinearOperation(Term* t, unsigned sort)
+{
+  CALL("Polynomial::isLinearOperation");
+
+  if (t->isSpecial() || !theory->isInterpretedFunction(t)) {
+    return false;
+  }
+  Interpretation itp = theory->interpretFunction(t);
+  switch(itp) {
+  case Theory::INT_SUCCESSOR:
+  case Theory::INT_PLUS:
+  case Theory::INT_MINUS:
+  case Theory::INT_UNARY_MINUS:
+  case Theory::INT_MULTIPLY:
+    return sort==Sorts::SRT_INTEGER;
+  case Theory::RAT_PLUS:
+  case Theory::RAT_MINUS:
+  case Theory::RAT_UNARY_MINUS:
+  case Theory::RAT_MULTIPLY:
+    return sort==Sorts::SRT_RATIONAL;
+  case Theory::REAL_PLUS:
+  case Theory::REAL_MINUS:
+  case Theory::REAL_UNARY_MINUS:
+  case Theory::REAL_MULTIPLY:
+    return sort==Sorts::SRT_REAL;
+  default:
+    return false;
+  }
+}
+
+/**
+ * Build the term sum of @b monomials and @b constant, in this order
+ *
+ * Monomials with coefficient 1 and -1 become their atom and its unary
+ * minus, the other ones the product of the coefficient and the atom.
+ * The constant is left out if it is zero and there are some monomials.
+ */
+TermList Polynomial::sum(unsigned sort, const MonomialStack& monomials, const RationalConstantType& constant)
+{
+  CALL("Polynomial::sum");
+
+  Interpretation plusItp, uminusItp, multiplyItp;
+  getOperations(sort, plusItp, uminusItp, multiplyItp);
+
+  RationalConstantType one(IntegerConstantType(1));
+  RationalConstantType zero(IntegerConstantType(0));
+
+  TermList res;
+  bool empty = true;
+  MonomialStack::BottomFirstIterator mit(monomials);
+  while (mit.hasNext()) {
+    const Monomial& m = mit.next();
+    TermList summand;
+    if (m.coeff==one) {
+      summand = m.atom;
+    }
+    else if (m.coeff==-one) {
+      unsigned uminus = env.signature->getInterpretingSymbol(uminusItp);
+      summand = TermList(Term::create1(uminus, m.atom));
+    }
+    else {
+      unsigned multiply = env.signature->getInterpretingSymbol(multiplyItp);
+      summand = TermList(Term::create2(multiply, representNumeral(sort, m.coeff), m.atom));
+    }
+    if (empty) {
+      res = summand;
+      empty = false;
+    }
+    else {
+      unsigned plus = env.signature->getInterpretingSymbol(plusItp);
+      res = TermList(Term::create2(plus, res, summand));
+    }
+  }
+  if (empty) {
+    return representNumeral(sort, constant);
+  }
+  if (constant!=zero) {
+    unsigned plus = env.signature->getInterpretingSymbol(plusItp);
+    res = TermList(Term::create2(plus, res, representNumeral(sort, constant)));
+  }
+  return res;
+}
+
+/**
+ * Number of leaves of the term sum(sort, monomials, constant)
+ */
+unsigned Polynomial::sumLeaves(const MonomialStack& monomials, const RationalConstantType& constant)
+{
+  CALL("Polynomial::sumLeaves");
+
+  RationalConstantType one(IntegerConstantType(1));
+
+  unsigned res = 0;
+  MonomialStack::ConstIterator mit(monomials);
+  while (mit.hasNext()) {
+    const Monomial& m = mit.next();
+    res += (m.coeff==one || m.coeff==-one) ? 1 : 2;
+  }
+  if (res==0 || constant!=RationalConstantType(IntegerConstantType(0))) {
+    res++;
+  }
+  return res;
+}
+
+void Polynomial::add(const Polynomial& p, const RationalConstantType& factor)
+{
+  CALL("Polynomial::add");
+  ASS_EQ(p._sort, _sort);
+
+  _constant = _constant + factor*p._constant;
+  MonomialStack::BottomFirstIterator mit(p._monomials);
+  while (mit.hasNext()) {
+    const Monomial& m = mit.next();
+    _monomials.push(Monomial(factor*m.coeff, m.atom));
+  }
+}
+
+/**
+ * Sort the monomials by their atoms, merge the ones with the same atom
+ * and remove the ones with zero coefficient
+ */
+void Polynomial::normalize()
+{
+  CALL("Polynomial::normalize");
+
+  Lib::sort<AtomComparator>(_monomials.begin(), _monomials.end());
+
+  RationalConstantType zero(IntegerConstantType(0));
+  unsigned len = _monomials.size();
+  unsigned res = 0;
+  for (unsigned i=0; i<len; ) {
+    TermList atom = _monomials[i].atom;
+    RationalConstantType coeff = _monomials[i].coeff;
+    for (i++; i<len && _monomials[i].atom==atom; i++) {
+      coeff = coeff + _monomials[i].coeff;
+    }
+    if (coeff!=zero) {
+      _monomials[res++] = Monomial(coeff, atom);
+    }
+  }
+  _monomials.truncate(res);
+}
+
+PolynomialCache::~PolynomialCache()
+{
+  CALL("PolynomialCache::~PolynomialCache");
+
+  DHMap<Term*,Polynomial*>::Iterator pit(_polynomials);
+  while (pit.hasNext()) {
+    delete pit.next();
+  }
+}
+
+/**
+ * Return the polynomial of the shared term @b t, which must be a linear
+ * operation of its sort
+ *
+ * The linear subterms of @b t whose polynomials are not known yet are
+ * processed bottom-up using an explicit stack.
+ */
+const Polynomial* PolynomialCache::get(Term* t)
+{
+  CALL("PolynomialCache::get");
+  ASS(t->shared());
+
+  Polynomial* res;
+  if (_polynomials.find(t, res)) {
+    return res;
+  }
+
+  static Stack<Term*> todo;
+  ASS(todo.isEmpty());
+  todo.push(t);
+  while (todo.isNonEmpty()) {
+    Term* trm = todo.top();
+    if (_polynomials.find(trm)) {
+      todo.pop();
+      continue;
+    }
+    unsigned sort = theory->getOperationSort(theory->interpretFunction(trm));
+    bool ready = true;
+    for (TermList* arg = trm->args(); arg->isNonEmpty(); arg = arg->next()) {
+      if (arg->isTerm() && Polynomial::isLinearOperation(arg->term(), sort) && !_polynomials.find(arg->term())) {
+        todo.push(arg->term());
+        ready = false;
+      }
+    }
+    if (ready) {
+      todo.pop();
+      _polynomials.insert(trm, compute(trm));
+    }
+  }
+  return _polynomials.get(t);
+}
+
+unsigned PolynomialCache::add(TermList t, const RationalConstantType& factor, Polynomial& res)
+{
+  CALL("PolynomialCache::add");
+
+  if (t.isTerm() && Polynomial::isLinearOperation(t.term(), res.sort())) {
+    const Polynomial* p = get(t.term());
+    res.add(*p, factor);
+    return p->leaves();
+  }
+  RationalConstantType val;
+  if (tryInterpretNumeral(t, res.sort(), val)) {
+    res._constant = res._constant + factor*val;
+  }
+  else {
+    res._monomials.push(Polynomial::Monomial(factor, t));
+  }
+  return 1;
+}
+
+/**
+ * If @b t is a numeral or a linear term with constant polynomial, save
+ * its value into @b res and its number of leaves into @b leaves
+ */
+bool PolynomialCache::tryGetConstant(TermList t, unsigned sort, RationalConstantType& res, unsigned& leaves)
+{
+  CALL("PolynomialCache::tryGetConstant");
+
+  if (t.isTerm() && Polynomial::isLinearOperation(t.term(), sort)) {
+    const Polynomial* p = get(t.term());
+    if (!p->isConstant()) {
+      return false;
+    }
+    res = p->constant();
+    leaves = p->leaves();
+    return true;
+  }
+  leaves = 1;
+  return tryInterpretNumeral(t, sort, res);
+}
+
+/**
+ * Compute the polynomial of the linear term @b t, the polynomials
+ * of whose linear arguments are already known
+ */
+Polynomial* PolynomialCache::compute(Term* t)
+{
+  CALL("PolynomialCache::compute");
+
+  Interpretation itp = theory->interpretFunction(t);
+  unsigned sort = theory->getOperationSort(itp);
+  Polynomial* res = new Polynomial(sort);
+
+  RationalConstantType one(IntegerConstantType(1));
+  TermList arg1 = *t->nthArgument(0);
+
+  switch(itp) {
+  case Theory::INT_SUCCESSOR:
+    res->_leaves = add(arg1, one, *res) + 1;
+    res->_constant = res->_constant + one;
+    break;
+  case Theory::INT_UNARY_MINUS:
+  case Theory::RAT_UNARY_MINUS:
+  case Theory::REAL_UNARY_MINUS:
+    res->_leaves = add(arg1, -one, *res);
+    break;
+  case Theory::INT_PLUS:
+  case Theory::RAT_PLUS:
+  case Theory::REAL_PLUS:
+    res->_leaves = add(arg1, one, *res);
+    res->_leaves += add(*t->nthArgument(1), one, *res);
+    break;
+  case Theory::INT_MINUS:
+  case Theory::RAT_MINUS:
+  case Theory::REAL_MINUS:
+    res->_leaves = add(arg1, one, *res);
+    res->_leaves += add(*t->nthArgument(1), -one, *res);
+    break;
+  case Theory::INT_MULTIPLY:
+  case Theory::RAT_MULTIPLY:
+  case Theory::REAL_MULTIPLY: {
+    TermList arg2 = *t->nthArgument(1);
+    RationalConstantType factor;
+    unsigned factorLeaves;
+    if (tryGetConstant(arg1, sort, factor, factorLeaves)) {
+      res->_leaves = factorLeaves + add(arg2, factor, *res);
+    }
+    else if (tryGetConstant(arg2, sort, factor, factorLeaves)) {
+      res->_leaves = add(arg1, factor, *res) + factorLeaves;
+    }
+    else {
+      // a non-linear product is an atom
+      res->_monomials.push(Polynomial::Monomial(one, TermList(t)));
+      res->_leaves = 1;
+    }
+    break;
+  }
+  default:
+    ASSERTION_VIOLATION;
+  }
+  res->normalize();
+  return res;
+}
+
+}
@@ -0,0 +1,135 @@
+
+/*
+ * File Polynomial.hpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file Polynomial.hpp
+ * Defines classes Polynomial and PolynomialCache.
+ */
+
+#ifndef __Polynomial__
+#define __Polynomial__
+
+#include "Forwards.hpp"
+
+#include "Lib/Allocator.hpp"
+#include "Lib/DHMap.hpp"
+#include "Lib/Stack.hpp"
+
+#include "Term.hpp"
+#include "Theory.hpp"
+
+namespace Kernel {
+
+using namespace Lib;
+
+/**
+ * Linear polynomial over integers, rationals or reals
+ *
+ * The polynomial is a numeric constant plus a sum of monomials c*t with
+ * a non-zero coefficient c, where the atom t is a variable or a term that
+ * is not a linear operation of the polynomial's sort. Product of two
+ * non-numeric terms is an atom. Monomials are sorted by their atoms
+ * (variables by their numbers first, then terms by their sharing ids), so
+ * terms that are equal up to AC of addition, cancellation of summands and
+ * evaluation of numeric coefficients have the same polynomial.
+ *
+ * Coefficients of all sorts are kept as rationals, integer polynomials
+ * only ever have integer coefficients.
+ */
+class Polynomial
+{
+public:
+  CLASS_NAME(Polynomial);
+  USE_ALLOCATOR(Polynomial);
+
+  struct Monomial
+  {
+    Monomial() {}
+    Monomial(const RationalConstantType& coeff, TermList atom) : coeff(coeff), atom(atom) {}
+
+    RationalConstantType coeff;
+    TermList atom;
+  };
+  typedef Stack<Monomial> MonomialStack;
+
+  explicit Polynomial(unsigned sort);
+
+  unsigned sort() const { return _sort; }
+  const RationalConstantType& constant() const { return _constant; }
+  const MonomialStack& monomials() const { return _monomials; }
+  bool isConstant() const { return _monomials.isEmpty(); }
+
+  /**
+   * Number of atom and numeral occurrences in the term the polynomial
+   * was computed from, in its linear part
+   */
+  unsigned leaves() const { return _leaves; }
+  unsigned canonicalLeaves() const { return sumLeaves(_monomials, _constant); }
+  TermList toTerm() const { return sum(_sort, _monomials, _constant); }
+
+  static bool isPolynomialSort(unsigned sort);
+  static bool isLinearOperation(Term* t, unsigned sort);
+
+  static TermList sum(unsigned sort, const MonomialStack& monomials, const RationalConstantType& constant);
+  static unsigned sumLeaves(const MonomialStack& monomials, const RationalConstantType& constant);
+
+  void normalize();
+
+private:
+  friend class PolynomialCache;
+
+  struct AtomComparator;
+
+  void add(const Polynomial& p, const RationalConstantType& factor);
+
+  unsigned _sort;
+  RationalConstantType _constant;
+  MonomialStack _monomials;
+  unsigned _leaves;
+};
+
+/**
+ * Polynomials of shared terms headed by a linear operation, each
+ * computed once and kept for as long as the cache exists
+ */
+class PolynomialCache
+{
+public:
+  CLASS_NAME(PolynomialCache);
+  USE_ALLOCATOR(PolynomialCache);
+
+  ~PolynomialCache();
+
+  const Polynomial* get(Term* t);
+
+  /**
+   * Add @b factor times the polynomial of @b t to @b res, which is of the
+   * same sort, and return the number of leaves of @b t
+   */
+  unsigned add(TermList t, const RationalConstantType& factor, Polynomial& res);
+
+private:
+  Polynomial* compute(Term* t);
+  bool tryGetConstant(TermList t, unsigned sort, RationalConstantType& res, unsigned& leaves);
+
+  DHMap<Term*,Polynomial*> _polynomials;
+};
+
+}
+
+#endif // __Polynomial__
@@ -301,6 +301,11 @@ Term* TermTransformerTransformTransformed::transform(Term* term)
     }
     ASS(tl.isTerm());
     Term* t=tl.term();
+    TermList whole;
+    if(transformWholeSubterm(t,whole)) {
+      args.push(whole);
+      continue;
+    }
     terms.push(t);
     toDo.push(t->args());
   }
@@ -62,6 +62,12 @@ public:
   Literal* transform(Literal* lit);
 protected:
   virtual TermList transformSubterm(TermList trm) = 0;
+  /**
+   * Called on a non-variable subterm before its arguments are visited.
+   * If true is returned, @b res is taken as the transformed subterm and
+   * neither the arguments nor the subterm are passed to transformSubterm().
+   */
+  virtual bool transformWholeSubterm(Term* trm, TermList& res) { return false; }
   /**
    * TODO: these functions are exactly the same as in TermTransformer, code duplication must be removed!
    */
@@ -26,8 +26,10 @@
 #include "Debug/Assertion.hpp"
 #include "Debug/Tracer.hpp"
 
+#include "Lib/BitUtils.hpp"
 #include "Lib/Environment.hpp"
 #include "Lib/Int.hpp"
+#include "Lib/Stack.hpp"
 
 #include "Shell/Skolem.hpp"
 
@@ -47,14 +49,382 @@ using namespace Lib;
 // IntegerConstantType
 //
 
+namespace {
+
+/**
+ * Absolute values of integers that do not fit into a machine word,
+ * as 32-bit limbs with the least significant first and without leading
+ * zero limbs (zero is the empty stack).
+ */
+typedef Stack<unsigned> Limbs;
+
+const uint64_t LIMB_BASE = 1ull<<32;
+
+void trimLimbs(Limbs& a)
+{
+  while (a.isNonEmpty() && a.top()==0) {
+    a.pop();
+  }
+}
+
+int compareLimbs(const Limbs& a, const Limbs& b)
+{
+  if (a.size()!=b.size()) {
+    return a.size()<b.size() ? -1 : 1;
+  }
+  for (size_t i = a.size(); i>0; i--) {
+    if (a[i-1]!=b[i-1]) {
+      return a[i-1]<b[i-1] ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+void addLimbs(const Limbs& a, const Limbs& b, Limbs& res)
+{
+  res.reset();
+  size_t len = max(a.size(), b.size());
+  uint64_t carry = 0;
+  for (size_t i = 0; i<len; i++) {
+    uint64_t sum = carry;
+    if (i<a.size()) { sum += a[i]; }
+    if (i<b.size()) { sum += b[i]; }
+    res.push(static_cast<unsigned>(sum));
+    carry = sum>>32;
+  }
+  if (carry) {
+    res.push(static_cast<unsigned>(carry));
+  }
+}
+
+/** @b a must not be smaller than @b b */
+void subtractLimbs(const Limbs& a, const Limbs& b, Limbs& res)
+{
+  ASS_GE(compareLimbs(a,b),0);
+
+  res.reset();
+  int64_t borrow = 0;
+  for (size_t i = 0; i<a.size(); i++) {
+    int64_t diff = static_cast<int64_t>(a[i]) - borrow;
+    if (i<b.size()) { diff -= b[i]; }
+    borrow = diff<0;
+    if (borrow) { diff += LIMB_BASE; }
+    res.push(static_cast<unsigned>(diff));
+  }
+  ASS_EQ(borrow,0);
+  trimLimbs(res);
+}
+
+void multiplyLimbs(const Limbs& a, const Limbs& b, Limbs& res)
+{
+  res.reset();
+  if (a.isEmpty() || b.isEmpty()) {
+    return;
+  }
+  for (size_t i = 0; i<a.size()+b.size(); i++) {
+    res.push(0);
+  }
+  for (size_t i = 0; i<a.size(); i++) {
+    uint64_t carry = 0;
+    for (size_t j = 0; j<b.size(); j++) {
+      uint64_t t = static_cast<uint64_t>(a[i])*b[j] + res[i+j] + carry;
+      res[i+j] = static_cast<unsigned>(t);
+      carry = t>>32;
+    }
+    res[i+b.size()] = static_cast<unsigned>(carry);
+  }
+  trimLimbs(res);
+}
+
+/** Multiply @b a by @b factor and add @b summand to it */
+void multiplyAddLimbs(Limbs& a, unsigned factor, unsigned summand)
+{
+  uint64_t carry = summand;
+  for (size_t i = 0; i<a.size(); i++) {
+    uint64_t t = static_cast<uint64_t>(a[i])*factor + carry;
+    a[i] = static_cast<unsigned>(t);
+    carry = t>>32;
+  }
+  if (carry) {
+    a.push(static_cast<unsigned>(carry));
+  }
+}
+
+/** Divide @b a by @b divisor in place and return the remainder */
+unsigned shortDivideLimbs(Limbs& a, unsigned divisor)
+{
+  ASS_NEQ(divisor,0);
+
+  uint64_t rem = 0;
+  for (size_t i = a.size(); i>0; i--) {
+    uint64_t cur = (rem<<32) | a[i-1];
+    a[i-1] = static_cast<unsigned>(cur/divisor);
+    rem = cur%divisor;
+  }
+  trimLimbs(a);
+  return static_cast<unsigned>(rem);
+}
+
+/**
+ * Divide @b u by the non-zero @b v, rounding towards zero
+ *
+ * This is the algorithm D of Knuth (TAOCP, vol. 2, 4.3.1) as presented
+ * in Hacker's Delight, with 32-bit digits.
+ */
+void divideLimbs(const Limbs& u, const Limbs& v, Limbs& q, Limbs& r)
+{
+  ASS(v.isNonEmpty());
+
+  if (compareLimbs(u,v)<0) {
+    q.reset();
+    r = u;
+    return;
+  }
+  if (v.size()==1) {
+    q = u;
+    unsigned rem = shortDivideLimbs(q, v[0]);
+    r.reset();
+    if (rem) {
+      r.push(rem);
+    }
+    return;
+  }
+
+  size_t m = u.size();
+  size_t n = v.size();
+  // normalise, so that the most significant limb of the divisor has its top bit set
+  unsigned s = __builtin_clz(v[n-1]);
+  static Limbs vn;
+  static Limbs un;
+  vn.reset();
+  un.reset();
+  for (size_t i = 0; i<n; i++) {
+    unsigned lower = (i>0 && s) ? v[i-1]>>(32-s) : 0;
+    vn.push((v[i]<<s) | lower);
+  }
+  for (size_t i = 0; i<m; i++) {
+    unsigned lower = (i>0 && s) ? u[i-1]>>(32-s) : 0;
+    un.push((u[i]<<s) | lower);
+  }
+  un.push(s ? u[m-1]>>(32-s) : 0);
+
+  q.reset();
+  for (size_t i = 0; i<=m-n; i++) {
+    q.push(0);
+  }
+  for (size_t j = m-n+1; j>0; ) {
+    j--;
+    uint64_t num = (static_cast<uint64_t>(un[j+n])<<32) | un[j+n-1];
+    uint64_t qhat = num/vn[n-1];
+    uint64_t rhat = num%vn[n-1];
+    while (qhat>=LIMB_BASE || qhat*vn[n-2] > ((rhat<<32) | un[j+n-2])) {
+      qhat--;
+      rhat += vn[n-1];
+      if (rhat>=LIMB_BASE) {
+        break;
+      }
+    }
+
+    // multiply and subtract
+    int64_t k = 0;
+    int64_t t;
+    for (size_t i = 0; i<n; i++) {
+      uint64_t p = qhat*vn[i];
+      t = static_cast<int64_t>(un[i+j]) - k - static_cast<int64_t>(p & 0xFFFFFFFFull);
+      un[i+j] = static_cast<unsigned>(t);
+      k = static_cast<int64_t>(p>>32) - (t>>32);
+    }
+    t = static_cast<int64_t>(un[j+n]) - k;
+    un[j+n] = static_cast<unsigned>(t);
+
+    q[j] = static_cast<unsigned>(qhat);
+    if (t<0) {
+      // subtracted too much, add back
+      q[j]--;
+      uint64_t carry = 0;
+      for (size_t i = 0; i<n; i++) {
+        uint64_t sum = static_cast<uint64_t>(un[i+j]) + vn[i] + carry;
+        un[i+j] = static_cast<unsigned>(sum);
+        carry = sum>>32;
+      }
+      un[j+n] += static_cast<unsigned>(carry);
+    }
+  }
+  trimLimbs(q);
+
+  // unnormalise the remainder
+  r.reset();
+  for (size_t i = 0; i<n; i++) {
+    unsigned upper = s ? un[i+1]<<(32-s) : 0;
+    r.push((un[i]>>s) | upper);
+  }
+  trimLimbs(r);
+}
+
+} // anonymous namespace
+
 IntegerConstantType::IntegerConstantType(const vstring& str)
+  : _val(0), _big(0)
 {
   CALL("IntegerConstantType::IntegerConstantType(vstring)");
 
-  if (!Int::stringToInt(str, _val)) {
-    //TODO: raise exception only on overflow, the proper syntax should be guarded by assertion
+  if (Int::stringToInt(str, _val)) {
+    return;
+  }
+
+  size_t i = 0;
+  bool negative = false;
+  if (i<str.size() && (str[i]=='-' || str[i]=='+')) {
+    negative = str[i]=='-';
+    i++;
+  }
+  if (i==str.size()) {
     throw ArithmeticException();
   }
+  static Limbs mag;
+  mag.reset();
+  for (; i<str.size(); i++) {
+    if (str[i]<'0' || str[i]>'9') {
+      //TODO: the proper syntax should be guarded by assertion
+      throw ArithmeticException();
+    }
+    multiplyAddLimbs(mag, 10, str[i]-'0');
+  }
+  *this = fromMagnitude(negative, mag);
+}
+
+IntegerConstantType& IntegerConstantType::operator=(const IntegerConstantType& o)
+{
+  if (o._big) {
+    o._big->refCnt++;
+  }
+  if (_big) {
+    release();
+  }
+  _val = o._val;
+  _big = o._big;
+  return *this;
+}
+
+/**
+ * Drop the reference to the limbs of a value that does not fit into InnerType
+ */
+void IntegerConstantType::release()
+{
+  ASS(_big);
+  ASS_G(_big->refCnt,0);
+
+  if (--_big->refCnt==0) {
+    DEALLOC_KNOWN(_big, sizeof(Big)+(_big->length-1)*sizeof(unsigned), "IntegerConstantType::Big");
+  }
+  _big = 0;
+}
+
+/**
+ * Save the absolute value of the number into @c mag
+ */
+void IntegerConstantType::getMagnitude(Stack<unsigned>& mag) const
+{
+  mag.reset();
+  if (_big) {
+    for (unsigned i = 0; i<_big->length; i++) {
+      mag.push(_big->limbs[i]);
+    }
+  }
+  else if (_val) {
+    mag.push(_val<0 ? 0u-static_cast<unsigned>(_val) : static_cast<unsigned>(_val));
+  }
+}
+
+/**
+ * Return the number with absolute value @c mag, negated if @c negative
+ */
+IntegerConstantType IntegerConstantType::fromMagnitude(bool negative, Stack<unsigned>& mag)
+{
+  CALL("IntegerConstantType::fromMagnitude");
+
+  trimLimbs(mag);
+  if (mag.isEmpty()) {
+    return IntegerConstantType(0);
+  }
+  if (mag.size()==1) {
+    unsigned m = mag[0];
+    if (m<=static_cast<unsigned>(numeric_limits<InnerType>::max())) {
+      InnerType val = m;
+      return IntegerConstantType(negative ? -val : val);
+    }
+    if (negative && m==static_cast<unsigned>(numeric_limits<InnerType>::max())+1) {
+      return IntegerConstantType(numeric_limits<InnerType>::min());
+    }
+  }
+
+  unsigned length = mag.size();
+  void* mem = ALLOC_KNOWN(sizeof(Big)+(length-1)*sizeof(unsigned), "IntegerConstantType::Big");
+  Big* big = static_cast<Big*>(mem);
+  big->refCnt = 1;
+  big->negative = negative;
+  big->length = length;
+  for (unsigned i = 0; i<length; i++) {
+    big->limbs[i] = mag[i];
+  }
+  IntegerConstantType res;
+  res._big = big;
+  return res;
+}
+
+/**
+ * Return @c n1+n2, or @c n1-n2 if @c subtract is true
+ */
+IntegerConstantType IntegerConstantType::add(const IntegerConstantType& n1, const IntegerConstantType& n2, bool subtract)
+{
+  CALL("IntegerConstantType::add");
+
+  static Limbs mag1;
+  static Limbs mag2;
+  static Limbs res;
+  n1.getMagnitude(mag1);
+  n2.getMagnitude(mag2);
+  bool negative1 = n1.isNegative();
+  bool negative2 = n2.isNegative()!=subtract;
+
+  if (negative1==negative2) {
+    addLimbs(mag1, mag2, res);
+    return fromMagnitude(negative1, res);
+  }
+  if (compareLimbs(mag1, mag2)>=0) {
+    subtractLimbs(mag1, mag2, res);
+    return fromMagnitude(negative1, res);
+  }
+  subtractLimbs(mag2, mag1, res);
+  return fromMagnitude(negative2, res);
+}
+
+/**
+ * Divide @c n1 by @c n2, rounding towards zero, and save the quotient
+ * and the remainder into those of @c quotient and @c remainder that are non-zero
+ */
+void IntegerConstantType::divide(const IntegerConstantType& n1, const IntegerConstantType& n2,
+    IntegerConstantType* quotient, IntegerConstantType* remainder)
+{
+  CALL("IntegerConstantType::divide");
+
+  if (n2.isZero()) {
+    throw ArithmeticException();
+  }
+
+  static Limbs mag1;
+  static Limbs mag2;
+  static Limbs quot;
+  static Limbs rem;
+  n1.getMagnitude(mag1);
+  n2.getMagnitude(mag2);
+  divideLimbs(mag1, mag2, quot, rem);
+  if (quotient) {
+    *quotient = fromMagnitude(n1.isNegative()!=n2.isNegative(), quot);
+  }
+  if (remainder) {
+    *remainder = fromMagnitude(n1.isNegative(), rem);
+  }
 }
 
 IntegerConstantType IntegerConstantType::operator+(const IntegerConstantType& num) const
@@ -62,10 +432,10 @@ IntegerConstantType IntegerConstantType::operator+(const IntegerConstantType& nu
   CALL("IntegerConstantType::operator+");
 
   InnerType res;
-  if (!Int::safePlus(_val, num._val, res)) {
-    throw ArithmeticException();
+  if (!_big && !num._big && Int::safePlus(_val, num._val, res)) {
+    return IntegerConstantType(res);
   }
-  return IntegerConstantType(res);
+  return add(*this, num, false);
 }
 
 IntegerConstantType IntegerConstantType::operator-(const IntegerConstantType& num) const
@@ -73,10 +443,10 @@ IntegerConstantType IntegerConstantType::operator-(const IntegerConstantType& nu
   CALL("IntegerConstantType::operator-/1");
 
   InnerType res;
-  if (!Int::safeMinus(_val, num._val, res)) {
-    throw ArithmeticException();
+  if (!_big && !num._big && Int::safeMinus(_val, num._val, res)) {
+    return IntegerConstantType(res);
   }
-  return IntegerConstantType(res);
+  return add(*this, num, true);
 }
 
 IntegerConstantType IntegerConstantType::operator-() const
@@ -84,10 +454,12 @@ IntegerConstantType IntegerConstantType::operator-() const
   CALL("IntegerConstantType::operator-/0");
 
   InnerType res;
-  if (!Int::safeUnaryMinus(_val, res)) {
-    throw ArithmeticException();
+  if (!_big && Int::safeUnaryMinus(_val, res)) {
+    return IntegerConstantType(res);
   }
-  return IntegerConstantType(res);
+  static Limbs mag;
+  getMagnitude(mag);
+  return fromMagnitude(!isNegative(), mag);
 }
 
 IntegerConstantType IntegerConstantType::operator*(const IntegerConstantType& num) const
@@ -95,10 +467,16 @@ IntegerConstantType IntegerConstantType::operator*(const IntegerConstantType& nu
   CALL("IntegerConstantType::operator*");
 
   InnerType res;
-  if (!Int::safeMultiply(_val, num._val, res)) {
-    throw ArithmeticException();
+  if (!_big && !num._big && Int::safeMultiply(_val, num._val, res)) {
+    return IntegerConstantType(res);
   }
-  return IntegerConstantType(res);
+  static Limbs mag1;
+  static Limbs mag2;
+  static Limbs prod;
+  getMagnitude(mag1);
+  num.getMagnitude(mag2);
+  multiplyLimbs(mag1, mag2, prod);
+  return fromMagnitude(isNegative()!=num.isNegative(), prod);
 }
 
 IntegerConstantType IntegerConstantType::operator/(const IntegerConstantType& num) const
@@ -106,13 +484,13 @@ IntegerConstantType IntegerConstantType::operator/(const IntegerConstantType& nu
   CALL("IntegerConstantType::operator/");
 
   //TODO: check if division corresponds to the TPTP semantic
-  if (num._val==0) {
-    throw ArithmeticException();
+  if (!_big && !num._big && num._val!=0 &&
+      (_val!=numeric_limits<InnerType>::min() || num._val!=-1)) {
+    return IntegerConstantType(_val/num._val);
   }
-  if(_val == numeric_limits<InnerType>::min() && num._val == -1){
-    throw ArithmeticException();
-  }
-  return IntegerConstantType(_val/num._val);
+  IntegerConstantType res;
+  divide(*this, num, &res, 0);
+  return res;
 }
 
 IntegerConstantType IntegerConstantType::operator%(const IntegerConstantType& num) const
@@ -120,24 +498,147 @@ IntegerConstantType IntegerConstantType::operator%(const IntegerConstantType& nu
   CALL("IntegerConstantType::operator%");
 
   //TODO: check if modulo corresponds to the TPTP semantic
-  if (num._val==0) {
+  if (!_big && !num._big && num._val!=0 &&
+      (_val!=numeric_limits<InnerType>::min() || num._val!=-1)) {
+    return IntegerConstantType(_val%num._val);
+  }
+  IntegerConstantType res;
+  divide(*this, num, 0, &res);
+  return res;
+}
+
+bool IntegerConstantType::divides(const IntegerConstantType& num) const
+{
+  CALL("IntegerConstantType:divides");
+
+  // if this is zero it shouldn't divide anything, if num is zero dividing it doesn't make sense
+  if (isZero() || num.isZero()) { return false; }
+  // if this is bigger than num then the result cannot be an integer
+  if ((*this)>num) { return false; }
+  return (num%(*this)).isZero();
+}
+
+float IntegerConstantType::realDivide(const IntegerConstantType& num) const
+{
+  CALL("IntegerConstantType::realDivide");
+
+  if (num.isZero()) {
     throw ArithmeticException();
   }
-  return IntegerConstantType(_val%num._val);
+  if (!_big && !num._big) {
+    return ((float)_val)/num._val;
+  }
+  return static_cast<float>(toDouble()/num.toDouble());
+}
+
+/**
+ * Euclidean quotient, i.e. the one with a non-negative remainder
+ */
+IntegerConstantType IntegerConstantType::quotientE(const IntegerConstantType& num) const
+{
+  CALL("IntegerConstantType::quotientE");
+
+  IntegerConstantType quot;
+  IntegerConstantType rem;
+  divide(*this, num, &quot, &rem);
+  if (rem.isNegative()) {
+    return num.isNegative() ? quot+1 : quot-1;
+  }
+  return quot;
+}
+
+/**
+ * Quotient rounded towards zero
+ */
+IntegerConstantType IntegerConstantType::quotientT(const IntegerConstantType& num) const
+{
+  CALL("IntegerConstantType::quotientT");
+
+  return (*this)/num;
+}
+
+/**
+ * Quotient rounded towards minus infinity
+ */
+IntegerConstantType IntegerConstantType::quotientF(const IntegerConstantType& num) const
+{
+  CALL("IntegerConstantType::quotientF");
+
+  IntegerConstantType quot;
+  IntegerConstantType rem;
+  divide(*this, num, &quot, &rem);
+  if (!rem.isZero() && rem.isNegative()!=num.isNegative()) {
+    return quot-1;
+  }
+  return quot;
 }
 
 bool IntegerConstantType::operator==(const IntegerConstantType& num) const
 {
   CALL("IntegerConstantType::operator==");
 
-  return _val==num._val;
+  if (!_big && !num._big) {
+    return _val==num._val;
+  }
+  // values that fit into InnerType are never stored as big
+  if (!_big || !num._big) {
+    return false;
+  }
+  if (_big==num._big) {
+    return true;
+  }
+  if (_big->negative!=num._big->negative || _big->length!=num._big->length) {
+    return false;
+  }
+  for (unsigned i = 0; i<_big->length; i++) {
+    if (_big->limbs[i]!=num._big->limbs[i]) {
+      return false;
+    }
+  }
+  return true;
 }
 
 bool IntegerConstantType::operator>(const IntegerConstantType& num) const
 {
   CALL("IntegerConstantType::operator>");
 
-  return _val>num._val;
+  if (!_big && !num._big) {
+    return _val>num._val;
+  }
+  bool negative1 = isNegative();
+  bool negative2 = num.isNegative();
+  if (negative1!=negative2) {
+    return negative2;
+  }
+  static Limbs mag1;
+  static Limbs mag2;
+  getMagnitude(mag1);
+  num.getMagnitude(mag2);
+  int cmp = compareLimbs(mag1, mag2);
+  return negative1 ? cmp<0 : cmp>0;
+}
+
+/**
+ * Return the binary logarithm of the absolute value, rounded down (0 for 0)
+ */
+unsigned IntegerConstantType::log2() const
+{
+  if (!_big) {
+    return BitUtils::log2(_val<0 ? 0u-static_cast<unsigned>(_val) : static_cast<unsigned>(_val));
+  }
+  return (_big->length-1)*32 + BitUtils::log2(_big->limbs[_big->length-1]);
+}
+
+double IntegerConstantType::toDouble() const
+{
+  if (!_big) {
+    return _val;
+  }
+  double res = 0;
+  for (unsigned i = _big->length; i>0; i--) {
+    res = res*LIMB_BASE + _big->limbs[i-1];
+  }
+  return _big->negative ? -res : res;
 }
 
 IntegerConstantType IntegerConstantType::floor(RationalConstantType rat)
@@ -180,43 +681,91 @@ IntegerConstantType IntegerConstantType::ceiling(RationalConstantType rat)
   return res;
 }
 
+/**
+ * Return the greatest common divisor of the absolute values of @c n1 and @c n2,
+ * or 1 if one of them is zero
+ */
+IntegerConstantType IntegerConstantType::gcd(const IntegerConstantType& n1, const IntegerConstantType& n2)
+{
+  CALL("IntegerConstantType::gcd");
+
+  if (!n1._big && !n2._big &&
+      n1._val!=numeric_limits<InnerType>::min() && n2._val!=numeric_limits<InnerType>::min()) {
+    return IntegerConstantType(Int::gcd(n1._val, n2._val));
+  }
+  if (n1.isZero() || n2.isZero()) {
+    return IntegerConstantType(1);
+  }
+  IntegerConstantType i = n1.isNegative() ? -n1 : n1;
+  IntegerConstantType j = n2.isNegative() ? -n2 : n2;
+  for (;;) {
+    i = i % j;
+    if (i.isZero()) {
+      return j;
+    }
+    j = j % i;
+    if (j.isZero()) {
+      return i;
+    }
+  }
+}
+
 Comparison IntegerConstantType::comparePrecedence(IntegerConstantType n1, IntegerConstantType n2)
 {
   CALL("IntegerConstantType::comparePrecedence");
-  try {
-    if (n1 == numeric_limits<InnerType>::min()) {
-      if (n2 == numeric_limits<InnerType>::min()) {
-        return EQUAL;
-      } else {
-        return GREATER;
-      }
-    } else {
-      if (n2 == numeric_limits<InnerType>::min()) {
-        return LESS;
-      } else {
-        InnerType an1 = abs(n1.toInner());
-        InnerType an2 = abs(n2.toInner());
-
-        ASS_GE(an1,0);
-        ASS_GE(an2,0);
-
-        return an1 < an2 ? LESS : (an1 == an2 ? // compare the signed ones, making negative greater than positive
-            static_cast<Comparison>(-Int::compare(n1.toInner(), n2.toInner()))
-                              : GREATER);
-      }
-    }
+
+  if (!n1._big && !n2._big &&
+      n1._val!=numeric_limits<InnerType>::min() && n2._val!=numeric_limits<InnerType>::min()) {
+    InnerType an1 = abs(n1._val);
+    InnerType an2 = abs(n2._val);
+
+    ASS_GE(an1,0);
+    ASS_GE(an2,0);
+
+    return an1 < an2 ? LESS : (an1 == an2 ? // compare the signed ones, making negative greater than positive
+        static_cast<Comparison>(-Int::compare(n1._val, n2._val))
+                          : GREATER);
   }
-  catch(ArithmeticException) {
-    ASSERTION_VIOLATION;
-    throw;
+
+  // the same order for values that do not fit into InnerType: smaller
+  // absolute values first and negative after positive ones
+  static Limbs mag1;
+  static Limbs mag2;
+  n1.getMagnitude(mag1);
+  n2.getMagnitude(mag2);
+  int cmp = compareLimbs(mag1, mag2);
+  if (cmp) {
+    return cmp<0 ? LESS : GREATER;
   }
+  if (n1.isNegative()==n2.isNegative()) {
+    return EQUAL;
+  }
+  return n1.isNegative() ? GREATER : LESS;
 }
 
 vstring IntegerConstantType::toString() const
 {
   CALL("IntegerConstantType::toString");
 
-  return Int::toString(_val);
+  if (!_big) {
+    return Int::toString(_val);
+  }
+
+  // collect the decimal digits in chunks of nine
+  static Limbs mag;
+  static Stack<unsigned> chunks;
+  getMagnitude(mag);
+  chunks.reset();
+  while (mag.isNonEmpty()) {
+    chunks.push(shortDivideLimbs(mag, 1000000000u));
+  }
+  vstring res = _big->negative ? "-" : "";
+  res += Int::toString(chunks.pop());
+  while (chunks.isNonEmpty()) {
+    vstring chunk = Int::toString(chunks.pop());
+    res += vstring(9-chunk.size(), '0') + chunk;
+  }
+  return res;
 }
 
 ///////////////////////
@@ -253,7 +802,7 @@ void RationalConstantType::init(InnerType num, InnerType den)
   cannonize();
 
   // Dividing by zero is bad!
-  if(_den.toInner()==0) throw ArithmeticException();
+  if(_den.isZero()) throw ArithmeticException();
 }
 
 RationalConstantType RationalConstantType::operator+(const RationalConstantType& o) const
@@ -335,7 +884,7 @@ void RationalConstantType::cannonize()
 {
   CALL("RationalConstantType::cannonize");
 
-  InnerType gcd = Int::gcd(_num.toInner(), _den.toInner());
+  InnerType gcd = IntegerConstantType::gcd(_num, _den);
   if (gcd!=1) {
     _num = _num/gcd;
     _den = _den/gcd;
@@ -496,10 +1045,10 @@ vstring RealConstantType::toNiceString() const
 {
   CALL("RealConstantType::toNiceString");
 
-  if (denominator().toInner()==1) {
+  if (denominator()==1) {
     return numerator().toString()+".0";
   }
-  float frep = (float) numerator().toInner() /(float) denominator().toInner();
+  float frep = numerator().realDivide(denominator());
   return Int::toString(frep);
   //return toString();
 }
@@ -44,6 +44,15 @@ namespace Kernel {
  */
 class ArithmeticException : public ThrowableBase {};
 
+/**
+ * Values of integer constants
+ *
+ * A value that fits into InnerType is stored inline and the operations
+ * on such values are performed natively. A value that does not fit is
+ * stored in a heap allocated, reference counted array of 32-bit limbs,
+ * so the arithmetic does not overflow. ArithmeticException is only raised
+ * for a division by zero and by toInner() on a value that does not fit.
+ */
 class IntegerConstantType
 {
 public:
@@ -51,9 +60,23 @@ public:
 
   typedef int InnerType;
 
-  IntegerConstantType() {}
-  IntegerConstantType(InnerType v) : _val(v) {}
+  IntegerConstantType() : _val(0), _big(0) {}
+  IntegerConstantType(InnerType v) : _val(v), _big(0) {}
+  IntegerConstantType(const IntegerConstantType& o) : _val(o._val), _big(o._big)
+  {
+    if (_big) {
+      _big->refCnt++;
+    }
+  }
   explicit IntegerConstantType(const vstring& str);
+  ~IntegerConstantType()
+  {
+    if (_big) {
+      release();
+    }
+  }
+
+  IntegerConstantType& operator=(const IntegerConstantType& o);
 
   IntegerConstantType operator+(const IntegerConstantType& num) const;
   IntegerConstantType operator-(const IntegerConstantType& num) const;
@@ -63,52 +86,13 @@ public:
   IntegerConstantType operator%(const IntegerConstantType& num) const;
 
   // true if this divides num
-  bool divides(const IntegerConstantType& num) const {
-    CALL("IntegerConstantType:divides");
-    // if this is zero it shouldn't divide anything, if num is zero dividing it doesn't make sense
-    if(_val==0 || num._val==0){ return false; }
-    // if this is bigger than num then the result cannot be an integer
-    if(_val > num._val){ return false; }
-    // now we only need to check the absolute value
-    int safeVal=_val;
-    if (_val < 0 && ! Lib::Int::safeUnaryMinus<int>(_val,safeVal)) {
-      return false;
-    }
-    return (num._val % safeVal ==0);
-  }
+  bool divides(const IntegerConstantType& num) const;
 
-  float realDivide(const IntegerConstantType& num) const { 
-    if(num._val==0) throw ArithmeticException();
-    return ((float)_val)/num._val; 
-  }
-  int intDivide(const IntegerConstantType& num) const {
-      CALL("IntegerConstantType::intDivide");
-      ASS(num.divides(*this));
-      if(num._val==0){ throw ArithmeticException(); }
-      return _val/num._val;
-  }
-  // TODO: shouldn't we always be using intDivide for quotientE - when are they different (apart from real rounding)?
-  IntegerConstantType quotientE(const IntegerConstantType& num) const { 
-    CALL("IntegerConstantType::quotientE");
-    //cout << "quotientE " << _val << " and " << num._val << endl;
-    if(num.divides(*this)){
-      return IntegerConstantType(intDivide(num));
-    }
-    if(num._val>0) return IntegerConstantType(::floor(realDivide(num)));
-    else return IntegerConstantType(::ceil(realDivide(num)));
-  }
-  IntegerConstantType quotientT(const IntegerConstantType& num) const { 
-    if(num.divides(*this)){
-      return IntegerConstantType(intDivide(num));
-    }
-    return IntegerConstantType(::trunc(realDivide(num)));
-  }
-  IntegerConstantType quotientF(const IntegerConstantType& num) const { 
-    if(num.divides(*this)){
-      return IntegerConstantType(intDivide(num));
-    }
-    return IntegerConstantType(::floor(realDivide(num)));
-  }
+  float realDivide(const IntegerConstantType& num) const;
+
+  IntegerConstantType quotientE(const IntegerConstantType& num) const;
+  IntegerConstantType quotientT(const IntegerConstantType& num) const;
+  IntegerConstantType quotientF(const IntegerConstantType& num) const;
 
   bool operator==(const IntegerConstantType& num) const;
   bool operator>(const IntegerConstantType& num) const;
@@ -118,24 +102,56 @@ public:
   bool operator>=(const IntegerConstantType& o) const { return !(o>(*this)); }
   bool operator<=(const IntegerConstantType& o) const { return !((*this)>o); }
 
-  InnerType toInner() const { return _val; }
+  /** True if the value does not fit into InnerType */
+  bool isBig() const { return _big; }
+  /** Return the value, which must fit into InnerType */
+  InnerType toInner() const
+  {
+    if (_big) {
+      throw ArithmeticException();
+    }
+    return _val;
+  }
 
-  bool isZero(){ return _val==0; }
-  bool isNegative(){ return _val<0; }
+  bool isZero() const { return !_big && _val==0; }
+  bool isNegative() const { return _big ? _big->negative : _val<0; }
+
+  unsigned log2() const;
+  double toDouble() const;
 
   static IntegerConstantType floor(RationalConstantType rat);
   static IntegerConstantType ceiling(RationalConstantType rat);
+  static IntegerConstantType gcd(const IntegerConstantType& n1, const IntegerConstantType& n2);
 
   static Comparison comparePrecedence(IntegerConstantType n1, IntegerConstantType n2);
 
   vstring toString() const;
 private:
+  /** Absolute value of a number that does not fit into InnerType */
+  struct Big {
+    unsigned refCnt;
+    bool negative;
+    /** number of limbs, the most significant one is non-zero */
+    unsigned length;
+    /** the limbs, the least significant first */
+    unsigned limbs[1];
+  };
+
+  void release();
+  void getMagnitude(Stack<unsigned>& mag) const;
+  static IntegerConstantType fromMagnitude(bool negative, Stack<unsigned>& mag);
+  static IntegerConstantType add(const IntegerConstantType& n1, const IntegerConstantType& n2, bool subtract);
+  static void divide(const IntegerConstantType& n1, const IntegerConstantType& n2,
+      IntegerConstantType* quotient, IntegerConstantType* remainder);
+
+  /** the value, if @b _big is zero */
   InnerType _val;
+  Big* _big;
 };
 
 inline
 std::ostream& operator<< (ostream& out, const IntegerConstantType& val) {
-  return out << val.toInner();
+  return out << val.toString();
 }
 
 /**
@@ -182,12 +198,12 @@ struct RationalConstantType {
   bool operator>=(const RationalConstantType& o) const { return !(o>(*this)); }
   bool operator<=(const RationalConstantType& o) const { return !((*this)>o); }
 
-  bool isZero(){ return _num.toInner()==0; } 
+  bool isZero(){ return _num.isZero(); } 
   // relies on the fact that cannonize ensures that _den>=0
-  bool isNegative(){ ASS(_den>=0); return _num.toInner() < 0; }
+  bool isNegative(){ ASS(_den>=0); return _num.isNegative(); }
 
   RationalConstantType quotientE(const RationalConstantType& num) const {
-    if(_num.toInner()>0 && _den.toInner()>0){
+    if(_num>0 && _den>0){
        return ((*this)/num).floor(); 
     }
     else return ((*this)/num).ceiling();
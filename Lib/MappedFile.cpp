@@ -0,0 +1,99 @@
+
+/*
+ * File MappedFile.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions. 
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide. 
+ */
+/**
+ * @file MappedFile.cpp
+ * Implements class MappedFile.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Debug/Tracer.hpp"
+
+#include "MappedFile.hpp"
+
+namespace Lib
+{
+
+/**
+ * Map the file @c fileName to memory. Return false if it is not
+ * a regular file or cannot be mapped, so that the caller can
+ * read it in the usual way instead.
+ */
+bool MappedFile::open(const vstring& fileName)
+{
+  CALL("MappedFile::open");
+
+  close();
+
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if(fd==-1) {
+    return false;
+  }
+  struct stat st;
+  if(fstat(fd, &st)==-1 || !S_ISREG(st.st_mode)) {
+    ::close(fd);
+    return false;
+  }
+  _size = st.st_size;
+  if(_size==0) {
+    // there is nothing to map
+    ::close(fd);
+    return true;
+  }
+  void* data = mmap(0, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping stays valid after the descriptor is closed
+  ::close(fd);
+  if(data==MAP_FAILED) {
+    _size = 0;
+    return false;
+  }
+  // we read the file from the beginning to the end
+  madvise(data, _size, MADV_SEQUENTIAL);
+  _data = static_cast<const char*>(data);
+  return true;
+}
+
+/**
+ * Tell the operating system that the file is going to be accessed
+ * in random order (rather than read sequentially, which is the default).
+ */
+void MappedFile::adviseRandomAccess()
+{
+  CALL("MappedFile::adviseRandomAccess");
+
+  if(_data) {
+    madvise(const_cast<char*>(_data), _size, MADV_RANDOM);
+  }
+}
+
+void MappedFile::close()
+{
+  CALL("MappedFile::close");
+
+  if(_data) {
+    munmap(const_cast<char*>(_data), _size);
+  }
+  _data = 0;
+  _size = 0;
+}
+
+}
@@ -0,0 +1,64 @@
+
+/*
+ * File MappedFile.hpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions. 
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide. 
+ */
+/**
+ * @file MappedFile.hpp
+ * Defines class MappedFile.
+ */
+
+#ifndef __MappedFile__
+#define __MappedFile__
+
+#include <cstddef>
+
+#include "Forwards.hpp"
+
+#include "Allocator.hpp"
+#include "VString.hpp"
+
+namespace Lib {
+
+/**
+ * A regular file memory mapped for reading.
+ */
+class MappedFile
+{
+public:
+  CLASS_NAME(MappedFile);
+  USE_ALLOCATOR(MappedFile);
+
+  MappedFile() : _data(0), _size(0) {}
+  ~MappedFile() { close(); }
+
+  bool open(const vstring& fileName);
+  void close();
+
+  void adviseRandomAccess();
+
+  /** The content of the file (not null-terminated) */
+  const char* data() const { return _data; }
+  /** Size of the file in bytes */
+  size_t size() const { return _size; }
+private:
+  const char* _data;
+  size_t _size;
+};
+
+}
+
+#endif // __MappedFile__
@@ -45,8 +45,9 @@ using namespace Shell;
 class SMTLIB2 {
 public:
   SMTLIB2(const Options& opts);
+  ~SMTLIB2();
 
-  /** Parse from an open stream */
+  /** Parse from an open stream, one command at a time */
   void parse(istream& str);
   /** Parse a ready lisp expression */
   void parse(LExpr* bench);
@@ -454,6 +455,31 @@ private:
    * Toplevel parsing dispatch for a benchmark.
    */
   void readBenchmark(LExprList* bench);
+
+  /** What is to happen after a toplevel command has been read */
+  enum CommandResult {
+    /** continue, the expression of the command is no longer needed */
+    CR_DONE,
+    /** continue, but parts of the command's expression were stored (by define-sort) */
+    CR_RETAIN,
+    /** check-sat, the rest is skipped */
+    CR_CHECK_SAT,
+    /** exit, nothing else may follow */
+    CR_EXIT
+  };
+
+  /**
+   * Read a single toplevel command.
+   */
+  CommandResult readCommand(LExpr* lexp);
+
+  void checkSatFollowedBy(LExpr* lexp);
+
+  /**
+   * Commands whose expressions are still referred to,
+   * kept (and owned) by the parser when reading from a stream.
+   */
+  Stack<LExpr*> _retainedCommands;
 };
 
 }
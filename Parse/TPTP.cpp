@@ -23,6 +23,7 @@
  * @since 08/04/2011 Manchester
  */
 
+#include <cstring>
 #include <fstream>
 
 #include "Debug/Assertion.hpp"
@@ -76,30 +77,132 @@ UnitList* TPTP::parse(istream& input)
 
 /**
  * Initialise a lexer.
+ *
+ * If @c fileName is given and it can be memory mapped, the parser
+ * reads it directly from memory and @c in is not used.
  * @since 27/07/2004 Torrevieja
  */
-TPTP::TPTP(istream& in)
+TPTP::TPTP(istream& in, const vstring& fileName)
   : _containsConjecture(false),
     _allowedNames(0),
-    _in(&in),
+    _input(0),
     _includeDirectory(""),
     _currentColor(COLOR_TRANSPARENT),
     _modelDefinition(false),
     _insideEqualityArgument(0),
     _unitSources(0),
     _filterReserved(false),
-    _seenConjecture(false)
+    _seenConjecture(false),
+    _unitHandler(0)
 {
+  if (fileName != "") {
+    MappedFile* file = new MappedFile();
+    if (file->open(fileName)) {
+      _input = new Input(file);
+    }
+    else {
+      delete file;
+    }
+  }
+  if (!_input) {
+    _input = new Input(&in,false);
+  }
 } // TPTP::TPTP
 
 /**
- * The destructor, does nothing.
+ * The destructor, releases the inputs.
  * @since 09/07/2012 Manchester
  */
 TPTP::~TPTP()
 {
+  delete _input;
+  while (_inputs.isNonEmpty()) {
+    delete _inputs.pop();
+  }
 } // TPTP::~TPTP
 
+/** Size of blocks in which streams are read */
+static const size_t INPUT_BLOCK_SIZE = 1 << 16;
+
+TPTP::Input::Input(istream* in, bool ownsStream)
+  : cur(0),
+    end(0),
+    _stream(in),
+    _ownsStream(ownsStream)
+{
+} // TPTP::Input::Input
+
+TPTP::Input::Input(MappedFile* file)
+  : cur(file->data()),
+    end(file->data()+file->size()),
+    _stream(0),
+    _ownsStream(false)
+{
+  _file = file;
+} // TPTP::Input::Input
+
+TPTP::Input::~Input()
+{
+  if (_ownsStream) {
+    BYPASSING_ALLOCATOR; // ifstream was allocated by "system new"
+    delete _stream;
+  }
+} // TPTP::Input::~Input
+
+/**
+ * Open file @c fileName, memory mapping it if possible.
+ * Return 0 if the file cannot be opened.
+ */
+TPTP::Input* TPTP::Input::open(const vstring& fileName)
+{
+  CALL("TPTP::Input::open");
+
+  MappedFile* file = new MappedFile();
+  if (file->open(fileName)) {
+    return new Input(file);
+  }
+  delete file;
+
+  istream* in;
+  {
+    BYPASSING_ALLOCATOR; // we cannot make ifstream allocated via Allocator
+    in = new ifstream(fileName.c_str());
+  }
+  if (!*in) {
+    BYPASSING_ALLOCATOR;
+    delete in;
+    return 0;
+  }
+  return new Input(in,true);
+} // TPTP::Input::open
+
+/**
+ * Make more characters available, keeping the unconsumed ones.
+ * Return false if there are no more characters in the input.
+ */
+bool TPTP::Input::refill()
+{
+  CALL("TPTP::Input::refill");
+
+  if (!_stream || !*_stream) {
+    return false;
+  }
+  size_t left = end-cur;
+  size_t offset = left ? cur-_buffer.array() : 0;
+  if (_buffer.size() < left+INPUT_BLOCK_SIZE) {
+    _buffer.expand(left+INPUT_BLOCK_SIZE);
+  }
+  char* data = _buffer.array();
+  if (left) {
+    memmove(data, data+offset, left);
+  }
+  _stream->read(data+left, INPUT_BLOCK_SIZE);
+  size_t cnt = _stream->gcount();
+  cur = data;
+  end = data+left+cnt;
+  return cnt > 0;
+} // TPTP::Input::refill
+
 /**
  * Read all tokens one by one 
  * @since 08/04/2011 Manchester
@@ -685,16 +788,8 @@ void TPTP::skipWhiteSpacesAndComments()
 
     case '%': // end-of-line comment
     resetChars();
-    for (;;) {
-      int c = getChar(0);
-      if (c == 0) {
-	return;
-      }
-      resetChars();
-      if (c == '\n') {
-        _lineNumber++;
-	break;
-      }
+    if (!skipLine()) {
+      return;
     }
     break;
 
@@ -731,6 +826,80 @@ void TPTP::skipWhiteSpacesAndComments()
   }
 } // TPTP::skipWhiteSpacesAndComments
 
+/**
+ * Skip the rest of the current line including the end-of-line character.
+ * Return false if the input ended before.
+ */
+bool TPTP::skipLine()
+{
+  CALL("TPTP::skipLine");
+  ASS_EQ(_cend,0);
+
+  for (;;) {
+    size_t avail = _input->end - _input->cur;
+    const void* eol = memchr(_input->cur,'\n',avail);
+    if (eol) {
+      consumeChars(static_cast<const char*>(eol) - _input->cur + 1);
+      _lineNumber++;
+      return true;
+    }
+    consumeChars(avail);
+    if (!_input->refill()) {
+      return false;
+    }
+  }
+} // TPTP::skipLine
+
+/**
+ * Characters that can occur in a name after its first character
+ */
+static bool s_nameChars[256];
+
+static bool initNameChars()
+{
+  for (int c = 'a'; c <= 'z'; c++) {
+    s_nameChars[c] = true;
+  }
+  for (int c = 'A'; c <= 'Z'; c++) {
+    s_nameChars[c] = true;
+  }
+  for (int c = '0'; c <= '9'; c++) {
+    s_nameChars[c] = true;
+  }
+  s_nameChars[(unsigned char)'_'] = true;
+  s_nameChars[(unsigned char)'$'] = true;
+  return true;
+}
+
+static bool s_nameCharsInitialized = initNameChars();
+
+/**
+ * Return the length of the name starting at the first unconsumed character.
+ * The first character is not checked.
+ */
+int TPTP::nameLength()
+{
+  CALL("TPTP::nameLength");
+
+  int n = 1;
+  for (;;) {
+    // scan what is available without calling getChar() for each character
+    const char* end = _input->end;
+    const char* p = _input->cur+n;
+    while (p < end && s_nameChars[static_cast<unsigned char>(*p)]) {
+      p++;
+    }
+    n = p - _input->cur;
+    if (p < end || !getChar(n)) {
+      break;
+    }
+    // getChar(n) has made more characters available, but it could have
+    // also been the end of input (that is 0, which is not a name character)
+  }
+  getChar(n);
+  return n;
+} // TPTP::nameLength
+
 /**
  * Read the name
  * @since 08/04/2011 Manchester
@@ -738,80 +907,10 @@ void TPTP::skipWhiteSpacesAndComments()
 void TPTP::readName(Token& tok)
 {
   CALL("TPTP::readName");
-  for (int n = 1;;n++) {
-    switch (getChar(n)) {
-    case 'A':
-    case 'B':
-    case 'C':
-    case 'D':
-    case 'E':
-    case 'F':
-    case 'G':
-    case 'H':
-    case 'I':
-    case 'J':
-    case 'K':
-    case 'L':
-    case 'M':
-    case 'N':
-    case 'O':
-    case 'P':
-    case 'Q':
-    case 'R':
-    case 'S':
-    case 'T':
-    case 'U':
-    case 'V':
-    case 'W':
-    case 'X':
-    case 'Y':
-    case 'Z':
-    case '_':
-    case 'a':
-    case 'b':
-    case 'c':
-    case 'd':
-    case 'e':
-    case 'f':
-    case 'g':
-    case 'h':
-    case 'i':
-    case 'j':
-    case 'k':
-    case 'l':
-    case 'm':
-    case 'n':
-    case 'o':
-    case 'p':
-    case 'q':
-    case 'r':
-    case 's':
-    case 't':
-    case 'u':
-    case 'v':
-    case 'w':
-    case 'x':
-    case 'y':
-    case 'z':
-    case '$':
-    case '0':
-    case '1':
-    case '2':
-    case '3':
-    case '4':
-    case '5':
-    case '6':
-    case '7':
-    case '8':
-    case '9':
-      break;
-    default:
-      ASS(_chars.content()[0] != '$');
-      tok.content.assign(_chars.content(),n);
-      shiftChars(n);
-      return;
-    }
-  }
+  int n = nameLength();
+  ASS(_input->cur[0] != '$');
+  tok.content.assign(_input->cur,n);
+  shiftChars(n);
 } // readName
 
 /**
@@ -822,81 +921,8 @@ void TPTP::readReserved(Token& tok)
 {
   CALL("TPTP::readReserved");
 
-  int n = 1;
-  for (;;n++) {
-    switch (getChar(n)) {
-    case 'A':
-    case 'B':
-    case 'C':
-    case 'D':
-    case 'E':
-    case 'F':
-    case 'G':
-    case 'H':
-    case 'I':
-    case 'J':
-    case 'K':
-    case 'L':
-    case 'M':
-    case 'N':
-    case 'O':
-    case 'P':
-    case 'Q':
-    case 'R':
-    case 'S':
-    case 'T':
-    case 'U':
-    case 'V':
-    case 'W':
-    case 'X':
-    case 'Y':
-    case 'Z':
-    case '_':
-    case 'a':
-    case 'b':
-    case 'c':
-    case 'd':
-    case 'e':
-    case 'f':
-    case 'g':
-    case 'h':
-    case 'i':
-    case 'j':
-    case 'k':
-    case 'l':
-    case 'm':
-    case 'n':
-    case 'o':
-    case 'p':
-    case 'q':
-    case 'r':
-    case 's':
-    case 't':
-    case 'u':
-    case 'v':
-    case 'w':
-    case 'x':
-    case 'y':
-    case 'z':
-    case '$':
-    case '0':
-    case '1':
-    case '2':
-    case '3':
-    case '4':
-    case '5':
-    case '6':
-    case '7':
-    case '8':
-    case '9':
-      break;
-    default:
-      tok.content.assign(_chars.content(),n);
-      //shiftChars(n);
-      goto out;
-    }
-  }
- out:
+  int n = nameLength();
+  tok.content.assign(_input->cur,n);
   if (tok.content == "$true") {
     tok.tag = T_TRUE;
   }
@@ -963,7 +989,7 @@ void TPTP::readReserved(Token& tok)
           for(;;c++){ if(getChar(c)!='$') break;}
           shiftChars(c);
           n=n-c;
-          tok.content.assign(_chars.content(),n);
+          tok.content.assign(_input->cur,n);
       }
       
       tok.tag = T_NAME;
@@ -992,7 +1018,7 @@ void TPTP::readString(Token& tok)
       continue;
     }
     if (c == '"') {
-      tok.content.assign(_chars.content()+1,n-1);
+      tok.content.assign(_input->cur+1,n-1);
       resetChars();
       return;
     }
@@ -1020,7 +1046,7 @@ void TPTP::readAtom(Token& tok)
       continue;
     }
     if (c == '\'') {
-      tok.content.assign(_chars.content()+1,n-1);
+      tok.content.assign(_input->cur+1,n-1);
       resetChars();
       return;
     }
@@ -1062,7 +1088,7 @@ TPTP::Tag TPTP::readNumber(Token& tok)
   switch (getChar(pos)) {
   case '/':
     pos = positiveDecimal(pos+1);
-    tok.content.assign(_chars.content(),pos);
+    tok.content.assign(_input->cur,pos);
     shiftChars(pos);
     return T_RAT;
   case 'E':
@@ -1070,7 +1096,7 @@ TPTP::Tag TPTP::readNumber(Token& tok)
     {
       char c = getChar(pos+1);
       pos = decimal((c == '+' || c == '-') ? pos+2 : pos+1);
-      tok.content.assign(_chars.content(),pos);
+      tok.content.assign(_input->cur,pos);
       shiftChars(pos);
     }
     return T_REAL;
@@ -1090,12 +1116,12 @@ TPTP::Tag TPTP::readNumber(Token& tok)
 	c = getChar(pos+1);
 	pos = decimal((c == '+' || c == '-') ? pos+2 : pos+1);
       }
-      tok.content.assign(_chars.content(),pos);
+      tok.content.assign(_input->cur,pos);
       shiftChars(pos);
     }
     return T_REAL;
   default:
-    tok.content.assign(_chars.content(),pos);
+    tok.content.assign(_input->cur,pos);
     shiftChars(pos);
     return T_INT;
   }
@@ -1191,11 +1217,8 @@ void TPTP::unitList()
       return;
     }
     resetChars();
-    {
-      BYPASSING_ALLOCATOR; // ifstream was allocated by "system new"
-      delete _in;
-    }
-    _in = _inputs.pop();
+    delete _input;
+    _input = _inputs.pop();
     _includeDirectory = _includeDirectories.pop();
     delete _allowedNames;
     _allowedNames = _allowedNamesStack.pop();
@@ -1578,7 +1601,6 @@ void TPTP::include()
   if (!ignore) {
     _allowedNamesStack.push(_allowedNames);
     _allowedNames = 0;
-    _inputs.push(_in);
     _includeDirectories.push(_includeDirectory);
   }
 
@@ -1617,13 +1639,12 @@ void TPTP::include()
   // the TPTP standard, so far we just set it to ""
   _includeDirectory = "";
   vstring fileName(env.options->includeFileName(relativeName));
-  {
-    BYPASSING_ALLOCATOR; // we cannot make ifstream allocated via Allocator
-    _in = new ifstream(fileName.c_str());
-  }
-  if (!*_in) {
+  Input* input = Input::open(fileName);
+  if (!input) {
     USER_ERROR((vstring)"cannot open file " + fileName);
   }
+  _inputs.push(_input);
+  _input = input;
 } // include
 
 /** add a file name to the list of forbidden includes */
@@ -3164,7 +3185,12 @@ void TPTP::endFof()
   default:
     break;
   }
-  _units.push(unit);
+  if (_unitHandler) {
+    _unitHandler->handleUnit(unit);
+  }
+  else {
+    _units.push(unit);
+  }
 } // tag
 
 /**
@@ -29,6 +29,9 @@
 #include <iostream>
 
 #include "Lib/Array.hpp"
+#include "Lib/DArray.hpp"
+#include "Lib/MappedFile.hpp"
+#include "Lib/ScopedPtr.hpp"
 #include "Lib/Set.hpp"
 #include "Lib/Stack.hpp"
 #include "Lib/Exception.hpp"
@@ -298,12 +301,27 @@ public:
 #define PARSE_ERROR(msg,tok) \
   throw ParseErrorException(msg,tok,_lineNumber)
 
-  TPTP(istream& in);
+  /**
+   * Receives the units one by one as they are parsed, see setUnitHandler()
+   */
+  class UnitHandler
+  {
+  public:
+    virtual ~UnitHandler() {}
+    virtual void handleUnit(Unit* unit) = 0;
+  };
+
+  TPTP(istream& in, const vstring& fileName="");
   ~TPTP();
   void parse();
   static UnitList* parse(istream& str);
   /** Return the list of parsed units */
   inline UnitList* units() { return _units.list(); }
+  /**
+   * Pass each parsed unit to @c handler as soon as it is read instead of
+   * collecting it, units() then remains empty
+   */
+  void setUnitHandler(UnitHandler* handler) { _unitHandler = handler; }
   /**
    * Return true if there was a conjecture formula among the parsed units
    *
@@ -319,7 +337,39 @@ public:
   unsigned lineNumber(){ return _lineNumber; }
 private:
   /** Return the input string of characters */
-  const char* input() { return _chars.content(); }
+  const char* input() { return _input->cur; }
+
+  /**
+   * A source of characters for the lexer: a memory mapped file or,
+   * if the input cannot be mapped, a stream read in large blocks.
+   *
+   * The characters from @b cur to @b end are available to the lexer,
+   * with @b cur being the first one not consumed yet.
+   */
+  class Input {
+  public:
+    CLASS_NAME(TPTP::Input);
+    USE_ALLOCATOR(Input);
+
+    Input(istream* in, bool ownsStream);
+    Input(MappedFile* file);
+    ~Input();
+
+    static Input* open(const vstring& fileName);
+
+    bool refill();
+
+    const char* cur;
+    const char* end;
+  private:
+    /** the stream read, 0 for a mapped file */
+    istream* _stream;
+    /** true if the stream was opened by us and is to be deleted */
+    bool _ownsStream;
+    ScopedPtr<MappedFile> _file;
+    /** characters read from the stream */
+    DArray<char> _buffer;
+  };
 
   enum TypeTag {
     TT_ATOMIC,
@@ -509,10 +559,10 @@ private:
   Stack<Set<vstring>*> _allowedNamesStack;
   /** set of files whose inclusion should be ignored */
   Set<vstring> _forbiddenIncludes;
-  /** the input stream */
-  istream* _in;
-  /** in the case include() is used, previous streams will be saved here */
-  Stack<istream*> _inputs;
+  /** the input */
+  Input* _input;
+  /** in the case include() is used, previous inputs will be saved here */
+  Stack<Input*> _inputs;
   /** the current include directory */
   vstring _includeDirectory;
   /** in the case include() is used, previous sequence of directories will be
@@ -520,11 +570,9 @@ private:
    * relative to the "current directory, that is, the directory used by the last include()
    */
   Stack<vstring> _includeDirectories;
-  /** input characters */
-  Array<char> _chars;
-  /** position in the input stream of the 0th character in _chars[] */
+  /** position in the input stream of the first unconsumed character */
   int _gpos;
-  /** the position beyond the last read characters */
+  /** the position (relative to the first unconsumed character) beyond the last read characters */
   int _cend;
   /** tokens currently at work */
   Array<Token> _tokens;
@@ -620,14 +668,33 @@ private:
   {
     CALL("TPTP::getChar");
 
-    while (_cend <= pos) {
-      int c = _in->get();
-      //      if (c == -1) { cout << "<EOF>"; } else {cout << char(c);}
-      _chars[_cend++] = c == -1 ? 0 : c;
+    if (_cend <= pos) {
+      _cend = pos+1;
+    }
+    while (_input->end - _input->cur <= pos) {
+      if (!_input->refill()) {
+        // end-of-file
+        return 0;
+      }
     }
-    return _chars[pos];
+    return _input->cur[pos];
   } // getChar
 
+  /**
+   * Consume the first @c n read characters (not going past the end of the input).
+   */
+  inline void consumeChars(int n)
+  {
+    if (_input->end - _input->cur < n) {
+      // some end-of-file characters were read
+      _input->cur = _input->end;
+    }
+    else {
+      _input->cur += n;
+    }
+    _gpos += n;
+  } // consumeChars
+
   /**
    * Shift characters in the buffer by n positions left.
    */
@@ -637,11 +704,8 @@ private:
     ASS(n > 0);
     ASS(n <= _cend);
 
-    for (int i = 0;i < _cend-n;i++) {
-      _chars[i] = _chars[n+i];
-    }
+    consumeChars(n);
     _cend -= n;
-    _gpos += n;
   } // shiftChars
 
   /**
@@ -650,10 +714,13 @@ private:
    */
   inline void resetChars()
   {
-    _gpos += _cend;
+    consumeChars(_cend);
     _cend = 0;
   } // resetChars
 
+  bool skipLine();
+  int nameLength();
+
   /**
    * Get the token at the position pos.
    */
@@ -816,6 +883,8 @@ private:
 
   bool _filterReserved;
   bool _seenConjecture;
+  /** if non-zero, receives the units read instead of _units */
+  UnitHandler* _unitHandler;
 
 
 #if VDEBUG
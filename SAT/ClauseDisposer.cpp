@@ -67,6 +67,13 @@ DArray<WatchStack>& ClauseDisposer::getWatchedStackArray()
   return _solver._windex;
 }
 
+DArray<BinaryWatchStack>& ClauseDisposer::getBinaryWatchedStackArray()
+{
+  CALL("ClauseDisposer::getBinaryWatchedStackArray");
+
+  return _solver._bindex;
+}
+
 SATClause* ClauseDisposer::getAssignmentPremise(unsigned var)
 {
   CALL("ClauseDisposer::getAssignmentPremise");
@@ -107,6 +114,7 @@ void ClauseDisposer::removeUnkept()
 
   unsigned watchCnt = (varCnt()+1)*2;
   DArray<WatchStack>& watches = getWatchedStackArray();
+  DArray<BinaryWatchStack>& binWatches = getBinaryWatchedStackArray();
 
   for(unsigned i=2; i<watchCnt; i++) {
     WatchStack::Iterator wit(watches[i]);
@@ -116,6 +124,13 @@ void ClauseDisposer::removeUnkept()
 	wit.del();
       }
     }
+    BinaryWatchStack::Iterator bwit(binWatches[i]);
+    while(bwit.hasNext()) {
+      SATClause* cl = bwit.next().cl;
+      if(!cl->kept()) {
+	bwit.del();
+      }
+    }
   }
 
   SATClauseStack::StableDelIterator lrnIt(getLearntStack());
@@ -63,6 +63,7 @@ protected:
   unsigned varCnt() const;
   SATClauseStack& getLearntStack();
   DArray<WatchStack>& getWatchedStackArray();
+  DArray<BinaryWatchStack>& getBinaryWatchedStackArray();
   SATClause* getAssignmentPremise(unsigned var);
 
   void markAllRemovableUnkept();
@@ -27,6 +27,8 @@
 
 #include "Lib/DArray.hpp"
 
+#include "Shell/Options.hpp"
+
 namespace SAT
 {
 
@@ -35,7 +37,8 @@ using namespace Lib;
   
 using namespace Minisat;
   
-MinisatInterfacing::MinisatInterfacing(const Shell::Options& opts, bool generateProofs):
+MinisatInterfacing::MinisatInterfacing(const Shell::Options& opts, bool generateProofs, bool refutesRepeatedly):
+  PrimitiveProofRecordingSATSolver(generateProofs && !refutesRepeatedly && opts.streamSatProofs()),
   _status(SATISFIABLE)
 {
   CALL("MinisatInterfacing::MinisatInterfacing");
@@ -104,6 +107,8 @@ void MinisatInterfacing::solveModuloAssumptionsAndSetStatus(unsigned conflictCou
     
   _solver.setConfBudget(conflictCountLimit); // treating UINT_MAX as \infty
   lbool res = _solver.solveLimited(_assumptions);
+
+  resetRefutation(res == l_False, _assumptions.size()>0);
   
   if (res == l_True) {
     _status = SATISFIABLE;
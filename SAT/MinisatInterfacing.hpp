@@ -37,7 +37,12 @@ public:
   CLASS_NAME(MinisatInterfacing);
   USE_ALLOCATOR(MinisatInterfacing);
   
-	MinisatInterfacing(const Shell::Options& opts, bool generateProofs=false);
+  /**
+   * With @b refutesRepeatedly, the added clauses are never streamed to
+   * a premise log (see option stream_sat_proofs), as the solver is going
+   * to compute a refutation after many of its solving calls.
+   */
+	MinisatInterfacing(const Shell::Options& opts, bool generateProofs=false, bool refutesRepeatedly=false);
 
   /**
    * Can be called only when all assumptions are retracted
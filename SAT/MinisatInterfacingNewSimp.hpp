@@ -36,6 +36,11 @@
 
 namespace SAT{
 
+/**
+ * Interface to minisat's SimpSolver. It does not record proofs
+ * (getRefutation must not be called), so unlike MinisatInterfacing
+ * it is not affected by the option stream_sat_proofs.
+ */
 class MinisatInterfacingNewSimp : public SATSolverWithAssumptions
 {
 public:
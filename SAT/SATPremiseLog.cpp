@@ -0,0 +1,324 @@
+
+/*
+ * File SATPremiseLog.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file SATPremiseLog.cpp
+ * Implements class SATPremiseLog.
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "Debug/RuntimeStatistics.hpp"
+
+#include "Lib/Exception.hpp"
+#include "Lib/TimeCounter.hpp"
+
+#include "Kernel/Unit.hpp"
+
+#include "Minisat/core/Solver.h"
+
+#include "SATInference.hpp"
+
+#include "SATPremiseLog.hpp"
+
+namespace SAT
+{
+
+using namespace Minisat;
+
+SATPremiseLog::SATPremiseLog()
+: _fd(-1), _data(0), _capacity(0), _used(0), _cnt(0), _coreSolver(0), _coreLoaded(0)
+{
+  CALL("SATPremiseLog::SATPremiseLog");
+
+  const char* dir = getenv("TMPDIR");
+  vstring path = vstring(dir ? dir : "/tmp")+"/vampire_sat_premises_XXXXXX";
+  char* pathBuf = const_cast<char*>(path.c_str());
+  _fd = mkstemp(pathBuf);
+  if(_fd==-1) {
+    SYSTEM_FAIL("Cannot create the SAT premise log "+path, errno);
+  }
+  // the file lives only as long as we keep it open
+  unlink(pathBuf);
+
+  map(1<<16);
+}
+
+SATPremiseLog::~SATPremiseLog()
+{
+  CALL("SATPremiseLog::~SATPremiseLog");
+
+  for(size_t ofs = 0; ofs<_used; ) {
+    Record* rec = recordAt(ofs);
+    if(!(rec->source & 1)) {
+      reinterpret_cast<Unit*>(rec->source)->decRefCnt();
+    }
+    ofs += recordSize(rec->length);
+  }
+
+  if(_coreSolver) {
+    BYPASSING_ALLOCATOR;
+    delete _coreSolver;
+  }
+  munmap(_data, _capacity);
+  close(_fd);
+}
+
+size_t SATPremiseLog::recordSize(unsigned length)
+{
+  size_t sz = sizeof(Record)+(length ? length-1 : 0)*sizeof(unsigned);
+  // keep the records aligned
+  return (sz+sizeof(size_t)-1) & ~(sizeof(size_t)-1);
+}
+
+/**
+ * Map the log file, extended to @c capacity bytes, to memory.
+ */
+void SATPremiseLog::map(size_t capacity)
+{
+  CALL("SATPremiseLog::map");
+
+  if(_data) {
+    munmap(_data, _capacity);
+    _data = 0;
+  }
+  if(ftruncate(_fd, capacity)==-1) {
+    SYSTEM_FAIL("Cannot extend the SAT premise log", errno);
+  }
+  void* data = mmap(0, capacity, PROT_READ|PROT_WRITE, MAP_SHARED, _fd, 0);
+  if(data==MAP_FAILED) {
+    SYSTEM_FAIL("Cannot map the SAT premise log", errno);
+  }
+  _data = static_cast<char*>(data);
+  _capacity = capacity;
+}
+
+void SATPremiseLog::ensureCapacity(size_t needed)
+{
+  CALL("SATPremiseLog::ensureCapacity");
+
+  if(needed<=_capacity) {
+    return;
+  }
+  size_t newCapacity = _capacity;
+  while(newCapacity<needed) {
+    newCapacity *= 2;
+  }
+  map(newCapacity);
+}
+
+/**
+ * Return the first-order unit @c cl was obtained from, if @c cl can
+ * be reconstructed from its literals and this unit. Otherwise return 0.
+ */
+Unit* SATPremiseLog::getOrigin(SATClause* cl)
+{
+  CALL("SATPremiseLog::getOrigin");
+
+  SATInference* inf = cl->inference();
+  // clauses which only lost some duplicate literals are fine as well
+  while(inf && inf->getType()==SATInference::PROP_INF) {
+    SATClauseList* prems = static_cast<PropInference*>(inf)->getPremises();
+    if(!prems || prems->tail()) {
+      return 0;
+    }
+    inf = prems->head()->inference();
+  }
+  if(!inf || inf->getType()!=SATInference::FO_CONVERSION) {
+    return 0;
+  }
+  return static_cast<FOConversionInference*>(inf)->getOrigin();
+}
+
+/**
+ * Append @c cl to the log.
+ *
+ * Return true if the clause object is not needed by the log
+ * (and so the caller may destroy it).
+ */
+bool SATPremiseLog::add(SATClause* cl)
+{
+  CALL("SATPremiseLog::add");
+
+  unsigned clen = cl->length();
+  size_t sz = recordSize(clen);
+  ensureCapacity(_used+sz);
+
+  Record* rec = recordAt(_used);
+  Unit* origin = getOrigin(cl);
+  if(origin) {
+    origin->incRefCnt();
+    rec->source = reinterpret_cast<size_t>(origin);
+  }
+  else {
+    rec->source = reinterpret_cast<size_t>(cl) | 1;
+  }
+  rec->length = clen;
+  for(unsigned i=0; i<clen; i++) {
+    rec->lits[i] = (*cl)[i].content();
+  }
+
+  _used += sz;
+  _cnt++;
+  RSTAT_CTR_INC(origin ? "sat premises logged" : "sat premises retained");
+  return origin!=0;
+}
+
+/**
+ * Return the clause of the record at @c offset, creating it
+ * if it is not retained and was not materialized before.
+ */
+SATClause* SATPremiseLog::materialize(size_t offset)
+{
+  CALL("SATPremiseLog::materialize");
+
+  Record* rec = recordAt(offset);
+  if(rec->source & 1) {
+    return reinterpret_cast<SATClause*>(rec->source & ~static_cast<size_t>(1));
+  }
+
+  SATClause** pcl;
+  if(!_materialized.getValuePtr(offset, pcl)) {
+    return *pcl;
+  }
+  unsigned clen = rec->length;
+  SATClause* cl = new(clen) SATClause(clen, true);
+  for(unsigned i=0; i<clen; i++) {
+    (*cl)[i] = SATLiteral(rec->lits[i]);
+  }
+  cl->setInference(new FOConversionInference(reinterpret_cast<Unit*>(rec->source)));
+  RSTAT_CTR_INC("sat premises materialized");
+  *pcl = cl;
+  return cl;
+}
+
+SATClauseList* SATPremiseLog::materializeAll()
+{
+  CALL("SATPremiseLog::materializeAll");
+
+  SATClauseList* res = SATClauseList::empty();
+  for(size_t ofs = 0; ofs<_used; ) {
+    SATClauseList::push(materialize(ofs), res);
+    ofs += recordSize(recordAt(ofs)->length);
+  }
+  return res;
+}
+
+/**
+ * Return the variable of the core solver for the SAT variable @c satVar
+ */
+int SATPremiseLog::coreVar(unsigned satVar)
+{
+  CALL("SATPremiseLog::coreVar");
+
+  while(_coreVars.size()<=satVar) {
+    _coreVars.push(-1);
+  }
+  if(_coreVars[satVar]==-1) {
+    _coreVars[satVar] = _coreSolver->newVar();
+  }
+  return _coreVars[satVar];
+}
+
+/**
+ * Add the records logged since the last call to the core solver,
+ * each guarded by its own selector variable (as in
+ * MinisatInterfacing::minimizePremiseList).
+ */
+void SATPremiseLog::loadCoreSolver()
+{
+  CALL("SATPremiseLog::loadCoreSolver");
+
+  if(!_coreSolver) {
+    BYPASSING_ALLOCATOR;
+    _coreSolver = new Solver();
+  }
+
+  while(_coreLoaded<_used) {
+    Record* rec = recordAt(_coreLoaded);
+    int sel = _coreSolver->newVar();
+    _coreSelectors.push(sel);
+    ALWAYS(_selectedRecords.insert(sel, _coreLoaded));
+
+    static vec<Lit> mcl;
+    mcl.clear();
+    for(unsigned i=0; i<rec->length; i++) {
+      SATLiteral l(rec->lits[i]);
+      mcl.push(mkLit(coreVar(l.var()),l.isNegative()));
+    }
+    mcl.push(mkLit(sel,true));
+    _coreSolver->addClause(mcl);
+
+    _coreLoaded += recordSize(rec->length);
+  }
+}
+
+/**
+ * Return the clauses of an unsat core of the logged clauses
+ * together with the unit clauses @c assumps.
+ *
+ * The core is obtained from a solver where each logged clause is
+ * guarded by its own selector, all of them assumed to be true.
+ * Should the logged clauses with @c assumps turn out satisfiable,
+ * all the logged clauses are returned.
+ */
+SATClauseList* SATPremiseLog::getCore(const SATLiteralStack& assumps)
+{
+  CALL("SATPremiseLog::getCore");
+
+  TimeCounter tc(TC_SAT_PROOF_MINIMIZATION);
+
+  loadCoreSolver();
+
+  static vec<Lit> ass;
+  ass.clear();
+  Stack<int>::BottomFirstIterator sit(_coreSelectors);
+  while(sit.hasNext()) {
+    ass.push(mkLit(sit.next()));
+  }
+  SATLiteralStack::ConstIterator ait(assumps);
+  while(ait.hasNext()) {
+    SATLiteral l = ait.next();
+    ass.push(mkLit(coreVar(l.var()),l.isNegative()));
+  }
+
+  if(_coreSolver->solve(ass)) {
+    // should not happen unless the caller got the assumptions wrong,
+    // but all the logged clauses are a correct (if large) answer
+    RSTAT_CTR_INC("sat premise log full reconstructions");
+    return materializeAll();
+  }
+
+  SATClauseList* res = SATClauseList::empty();
+  LSet& conflict = _coreSolver->conflict;
+  for(int i=0; i<conflict.size(); i++) {
+    size_t ofs;
+    if(_selectedRecords.find(var(conflict[i]), ofs)) {
+      SATClauseList::push(materialize(ofs), res);
+    } // otherwise it is one of the assumps
+  }
+  RSTAT_CTR_INC("sat premise log cores");
+  return res;
+}
+
+}
@@ -0,0 +1,133 @@
+
+/*
+ * File SATPremiseLog.hpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file SATPremiseLog.hpp
+ * Defines class SATPremiseLog.
+ */
+
+#ifndef __SATPremiseLog__
+#define __SATPremiseLog__
+
+#include "Forwards.hpp"
+
+#include "Lib/Allocator.hpp"
+#include "Lib/DHMap.hpp"
+#include "Lib/Stack.hpp"
+
+#include "SATClause.hpp"
+#include "SATLiteral.hpp"
+
+namespace Minisat {
+class Solver;
+}
+
+namespace SAT {
+
+using namespace Lib;
+using namespace Kernel;
+
+/**
+ * An append-only log of the clauses added to a proof recording SAT solver,
+ * kept in a memory mapped (and already unlinked) temporary file.
+ *
+ * A clause whose inference is a conversion of a first-order unit
+ * (possibly followed by removal of duplicate literals) is stored just
+ * as its literals and the first-order origin, so the SATClause object
+ * need not be kept alive. Other clauses are logged as a pointer and
+ * remain owned by the caller.
+ *
+ * After a refutation, an unsat core of the logged clauses is computed
+ * and only the clauses of the core are materialized again. The core
+ * solver is kept between refutations and only gets the clauses logged
+ * since the previous one, and each logged clause is materialized at
+ * most once. The materialized clauses are not deleted with the log,
+ * as the proof may still refer to them.
+ */
+class SATPremiseLog
+{
+public:
+  CLASS_NAME(SATPremiseLog);
+  USE_ALLOCATOR(SATPremiseLog);
+
+  SATPremiseLog();
+  ~SATPremiseLog();
+
+  bool add(SATClause* cl);
+
+  /** Number of clauses in the log */
+  unsigned size() const { return _cnt; }
+
+  SATClauseList* getCore(const SATLiteralStack& assumps);
+
+  static Unit* getOrigin(SATClause* cl);
+
+private:
+  /**
+   * Header of a record in the log, followed by @b length SATLiteral
+   * contents. Records are aligned to the size of a pointer.
+   */
+  struct Record {
+    /**
+     * Either the first-order origin of the clause,
+     * or the retained SATClause object with the lowest bit set.
+     */
+    size_t source;
+    unsigned length;
+    unsigned lits[1];
+  };
+
+  static size_t recordSize(unsigned length);
+
+  Record* recordAt(size_t offset) const
+  { return reinterpret_cast<Record*>(_data+offset); }
+
+  void ensureCapacity(size_t needed);
+  void map(size_t capacity);
+
+  SATClause* materialize(size_t offset);
+  SATClauseList* materializeAll();
+
+  void loadCoreSolver();
+  int coreVar(unsigned satVar);
+
+  int _fd;
+  char* _data;
+  /** Size of the mapped file */
+  size_t _capacity;
+  /** Used part of the mapped file */
+  size_t _used;
+  unsigned _cnt;
+
+  /** Solver used by getCore, created on the first call */
+  Minisat::Solver* _coreSolver;
+  /** Part of the log already added to _coreSolver */
+  size_t _coreLoaded;
+  /** Variables of _coreSolver for the SAT variables, -1 if not created yet */
+  Stack<int> _coreVars;
+  /** Selector variables of _coreSolver, one for each loaded record */
+  Stack<int> _coreSelectors;
+  /** Offsets of the loaded records by their selector variables */
+  DHMap<int,size_t> _selectedRecords;
+  /** Clauses materialized from the log, by the offsets of their records */
+  DHMap<size_t,SATClause*> _materialized;
+};
+
+}
+
+#endif // __SATPremiseLog__
@@ -24,8 +24,11 @@
 #ifndef __SATSolver__
 #define __SATSolver__
 
+#include "Lib/ScopedPtr.hpp"
+
 #include "SATLiteral.hpp"
 #include "SATInference.hpp"
+#include "SATPremiseLog.hpp"
 
 namespace SAT {
 
@@ -58,6 +61,14 @@ public:
    */
   virtual void addClause(SATClause* cl) = 0;
 
+  /**
+   * Add a clause the caller is not going to refer to any more.
+   *
+   * Solvers which do not need the clause object after it has been
+   * added (such as when streaming proof premises to a log) may destroy it.
+   */
+  virtual void addDisposableClause(SATClause* cl) { addClause(cl); }
+
   void addClausesIter(SATClauseIterator cit) {
     CALL("SATSolver::addClauses");
     while (cit.hasNext()) {
@@ -363,15 +374,25 @@ protected:
  * This need not necessarily inherit from SATSolverWithAssumptions,
  * but why bother with multiple inheritance if we know the only 
  * two descendants of this class will need it...
+ *
+ * With @b streamPremises, the added clauses are not kept in memory but
+ * written to a SATPremiseLog and a refutation only gets the clauses
+ * of an unsat core reconstructed from the log. The descendant then must
+ * call resetRefutation after each solving.
  */
 class PrimitiveProofRecordingSATSolver : public SATSolverWithAssumptions {
 public:
-  PrimitiveProofRecordingSATSolver() :  
-    _addedClauses(0), _refutation(new(0) SATClause(0)), _refutationInference(new PropInference(SATClauseList::empty()))
+  PrimitiveProofRecordingSATSolver(bool streamPremises=false) :
+    _addedClauses(0), _refutation(new(0) SATClause(0)), _refutationInference(new PropInference(SATClauseList::empty())),
+    _refutationCore(0), _refutedUnderAssumptions(false)
     {
       CALL("PrimitiveProofRecordingSATSolver::PrimitiveProofRecordingSATSolver");
       
       _refutation->setInference(_refutationInference);    
+
+      if (streamPremises) {
+        _premiseLog = new SATPremiseLog();
+      }
     }
   
   virtual ~PrimitiveProofRecordingSATSolver() {
@@ -385,13 +406,38 @@ public:
   {
     CALL("PrimitiveProofRecordingSATSolver::addClause");
     
+    if (_premiseLog) {
+      _premiseLog->add(cl);
+      return;
+    }
     SATClauseList::push(cl,_addedClauses);
   }
+
+  virtual void addDisposableClause(SATClause* cl) override
+  {
+    CALL("PrimitiveProofRecordingSATSolver::addDisposableClause");
+
+    // the descendant's addClause calls ours
+    addClause(cl);
+    if (_premiseLog && SATPremiseLog::getOrigin(cl)) {
+      // the log can reconstruct it
+      cl->destroy();
+    }
+  }
   
   virtual SATClause* getRefutation() override
   {
     CALL("PrimitiveProofRecordingSATSolver::getRefutation");
 
+    if (_premiseLog) {
+      if (!_refutationCore) {
+        static SATLiteralStack noAssumptions;
+        _refutationCore = _premiseLog->getCore(_refutedUnderAssumptions ? _failedAssumptionBuffer : noAssumptions);
+      }
+      _refutationInference->setPremises(_refutationCore);
+      return _refutation;
+    }
+
     // connect the added clauses ... 
     SATClauseList* prems = _addedClauses;  
 
@@ -418,9 +464,30 @@ public:
   }
   
   virtual SATClauseList* getRefutationPremiseList() override {
+    if (_premiseLog) {
+      getRefutation();
+      return _refutationCore;
+    }
     return _addedClauses;
   }
 
+protected:
+  /**
+   * To be called after each solving. If the solver @c refuted the clauses,
+   * @c underAssumptions tells whether the failed assumptions are to be taken
+   * into account when reconstructing the refutation from the premise log.
+   *
+   * (A satisfiable call keeps the previous setting, since the failed assumptions
+   * of the last refutation stay valid, e.g. during explicit minimization.)
+   */
+  void resetRefutation(bool refuted, bool underAssumptions)
+  {
+    _refutationCore = 0;
+    if (refuted) {
+      _refutedUnderAssumptions = underAssumptions;
+    }
+  }
+
 private:
   // to be used for the premises of a refutation
   SATClauseList* _addedClauses;
@@ -434,6 +501,11 @@ private:
    * The inference inside _refutation.
    */
   PropInference* _refutationInference;  
+
+  ScopedPtr<SATPremiseLog> _premiseLog;
+  /** The premises of the last refutation reconstructed from _premiseLog */
+  SATClauseList* _refutationCore;
+  bool _refutedUnderAssumptions;
 };
 
 
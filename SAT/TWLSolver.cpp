@@ -30,6 +30,7 @@
 #include "Lib/BinaryHeap.hpp"
 #include "Lib/Environment.hpp"
 #include "Lib/Int.hpp"
+#include "Lib/Portability.hpp"
 
 #include "Lib/Timer.hpp"
 
@@ -66,7 +67,7 @@ using namespace Lib;
 
 TWLSolver::TWLSolver(const Options& opt, bool generateProofs)
 : _generateProofs(generateProofs), _status(SATISFIABLE), _assignment(0), _assignmentLevels(0),
-_windex(0), _varCnt(0), _level(1), _assumptionsAdded(false), _assumptionCnt(0), _unsatisfiableAssumptions(false)
+_windex(0), _bindex(0), _varCnt(0), _level(1), _assumptionsAdded(false), _assumptionCnt(0), _unsatisfiableAssumptions(false)
 {
   switch(opt.satVarSelector()) {
   case Options::SatVarSelector::ACTIVE:
@@ -139,6 +140,7 @@ void TWLSolver::ensureVarCount(unsigned newVarCnt)
   _propagationScheduled.expand(newVarCnt+1);
 
   _windex.expand((newVarCnt+1)*2);
+  _bindex.expand((newVarCnt+1)*2);
 
   _varCnt=newVarCnt;
 
@@ -158,6 +160,7 @@ unsigned TWLSolver::newVar()
   _propagationScheduled.expand(_varCnt+1);
 
   _windex.expand((_varCnt+1)*2);
+  _bindex.expand((_varCnt+1)*2);
 
   _variableSelector->ensureVarCount(_varCnt);
   
@@ -544,18 +547,15 @@ void TWLSolver::doSubsumptionResolution(SATLiteralStack& lits, SATClauseList*& p
 
     bool resolved = false;
     SATClause* resolvingClause = 0;
-    WatchStack::Iterator wit(getWatchStack(rLitOp));
+    BinaryWatchStack::Iterator wit(getBinaryWatchStack(rLitOp));
     while(wit.hasNext()) {
-      SATClause* cl = wit.next().cl;
-      if(cl->size()!=2) {
-	continue;
-      }
-      SATLiteral other = ((*cl)[0]==rLitOp) ? (*cl)[1] : (*cl)[0];
+      BinaryWatch watch = wit.next();
+      SATLiteral other = watch.other;
       ASS(other!=rLit);
       ASS(other!=rLitOp);
-      ASS((*cl)[0]==rLitOp || (*cl)[1]==rLitOp);
+      ASS((*watch.cl)[0]==rLitOp || (*watch.cl)[1]==rLitOp);
       if(litSet.find(other.content())) {
-	resolvingClause = cl;
+	resolvingClause = watch.cl;
 	resolved = true;
 	break;
       }
@@ -811,6 +811,40 @@ TWLSolver::ClauseVisitResult TWLSolver::visitWatchedClause(Watch watch, unsigned
   return VR_PROPAGATE;
 }
 
+/**
+ * Perform unit propagation of variable @c var along the binary clauses.
+ *
+ * If conflict occurs, return the clause that caused the conflict;
+ * otherwise return 0.
+ */
+SATClause* TWLSolver::propagateBinary(unsigned var)
+{
+  CALL("TWLSolver::propagateBinary");
+  ASS_G(var,0); ASS_LE(var,_varCnt);
+  ASS(!isUndefined(var));
+
+  BinaryWatchStack& implications = getTriggeredBinaryWatchStack(var, _assignment[var]);
+  BinaryWatch* end = implications.end();
+  for(BinaryWatch* w = implications.begin(); w!=end; w++) {
+    SATLiteral other = w->other;
+    if(isTrue(other)) {
+      continue;
+    }
+    if(isFalse(other)) {
+      return w->cl;
+    }
+    makeForcedAssignment(other, w->cl);
+  }
+  return 0;
+}
+
+/**
+ * Number of watches checked together by propagate(). The clauses
+ * of a batch whose blockers are not true get prefetched before
+ * the first of them is visited.
+ */
+static const size_t WATCH_BATCH_SIZE = 64/sizeof(Watch) ? 64/sizeof(Watch) : 1;
+
 /**
  * Perform unit propagation starting with variable @c var0.
  *
@@ -823,39 +857,72 @@ SATClause* TWLSolver::propagate(unsigned var)
   ASS_G(var,0); ASS_LE(var,_varCnt);
   ASS(!isUndefined(var));
 
-  //we go through the watch stack of literal opposite to the assigned value
-//  WatchStack::Iterator wit(getTriggeredWatchStack(var, _assignment[var]));
-  WatchStack::StableDelIterator wit(getTriggeredWatchStack(var, _assignment[var]));
-  while(wit.hasNext()) {
-    Watch watch=wit.next();
-    SATClause* cl = watch.cl;
-
-    unsigned litIndex;
-    ClauseVisitResult cvr = visitWatchedClause(watch, var, litIndex);
-    switch(cvr) {
-    case VR_CHANGE_WATCH:
-    {
-      WatchStack& tgtStack = getWatchStack((*cl)[litIndex]);
-      unsigned curWatchIndex = ((*cl)[0].var()==var) ? 0 : 1;
-      swap( (*cl)[curWatchIndex], (*cl)[litIndex] );
-      wit.del();
-      tgtStack.push(Watch(cl, (*cl)[1-curWatchIndex]));
-      break;
+  SATClause* conflict = propagateBinary(var);
+  if(conflict) {
+    return conflict;
+  }
+
+  //we go through the watch stack of literal opposite to the assigned value,
+  //watches that stay are compacted towards the bottom of the stack
+  //(nothing is pushed on this stack meanwhile, as the literals it
+  //could get are all false)
+  WatchStack& watches = getTriggeredWatchStack(var, _assignment[var]);
+  size_t sz = watches.size();
+  size_t kept = 0;
+  size_t i = 0;
+  while(i<sz) {
+    size_t batchEnd = std::min(i+WATCH_BATCH_SIZE, sz);
+    for(size_t j=i; j<batchEnd; j++) {
+      if(!isTrue(watches[j].blocker)) {
+	PREFETCH(watches[j].cl);
+      }
     }
-    case VR_CONFLICT:
-      return cl;
-    case VR_PROPAGATE:
-    {
-      //So let's unit-propagate...
-      SATLiteral undefLit=(*cl)[litIndex];
-      makeForcedAssignment(undefLit, cl);
-      break;
+
+    for(; i<batchEnd; i++) {
+      Watch watch=watches[i];
+      SATClause* cl = watch.cl;
+
+      unsigned litIndex;
+      ClauseVisitResult cvr = visitWatchedClause(watch, var, litIndex);
+      switch(cvr) {
+      case VR_CHANGE_WATCH:
+      {
+	WatchStack& tgtStack = getWatchStack((*cl)[litIndex]);
+	ASS_NEQ(&tgtStack, &watches);
+	unsigned curWatchIndex = ((*cl)[0].var()==var) ? 0 : 1;
+	swap( (*cl)[curWatchIndex], (*cl)[litIndex] );
+	tgtStack.push(Watch(cl, (*cl)[1-curWatchIndex]));
+	continue;
+      }
+      case VR_CONFLICT:
+	conflict = cl;
+	break;
+      case VR_PROPAGATE:
+      {
+	//So let's unit-propagate...
+	SATLiteral undefLit=(*cl)[litIndex];
+	makeForcedAssignment(undefLit, cl);
+	break;
+      }
+      case VR_NONE:
+	break;
+      }
+      watches[kept++] = watch;
+      if(conflict) {
+	i++;
+	break;
+      }
     }
-    case VR_NONE:
+    if(conflict) {
       break;
     }
   }
-  return 0;
+  //keep the watches we did not get to
+  while(i<sz) {
+    watches[kept++] = watches[i++];
+  }
+  watches.truncate(kept);
+  return conflict;
 }
 
 void TWLSolver::setAssignment(unsigned var, unsigned polarity)
@@ -1138,6 +1205,11 @@ void TWLSolver::insertIntoWatchIndex(SATClause* cl)
 {
   CALL("TWLSolver::insertIntoWatchIndex");
 
+  if(cl->length()==2) {
+    getBinaryWatchStack((*cl)[0]).push(BinaryWatch(cl, (*cl)[1]));
+    getBinaryWatchStack((*cl)[1]).push(BinaryWatch(cl, (*cl)[0]));
+    return;
+  }
   getWatchStack((*cl)[0]).push(Watch(cl, (*cl)[1]));
   getWatchStack((*cl)[1]).push(Watch(cl, (*cl)[0]));
 }
@@ -1184,6 +1256,31 @@ inline WatchStack& TWLSolver::getTriggeredWatchStack(unsigned var, PackedAsgnVal
   return getWatchStack(var, 1-assignment);
 }
 
+inline BinaryWatchStack& TWLSolver::getBinaryWatchStack(SATLiteral lit)
+{
+  CALL("TWLSolver::getBinaryWatchStack/1");
+
+  return _bindex[lit.content()];
+}
+
+inline BinaryWatchStack& TWLSolver::getBinaryWatchStack(unsigned var, unsigned polarity)
+{
+  CALL("TWLSolver::getBinaryWatchStack/2");
+  ASS_G(var,0); ASS_LE(var,_varCnt);
+  ASS_REP(polarity==0 || polarity==1, polarity);
+
+  return _bindex[2*var + polarity];
+}
+
+inline BinaryWatchStack& TWLSolver::getTriggeredBinaryWatchStack(unsigned var, PackedAsgnVal assignment)
+{
+  CALL("TWLSolver::getTriggeredBinaryWatchStack");
+  ASS_G(var,0); ASS_LE(var,_varCnt);
+  ASS(assignment!=AS_UNDEFINED);
+
+  return getBinaryWatchStack(var, 1-assignment);
+}
+
 
 /** Return true iff @c lit is true in the current assignment */
 inline bool TWLSolver::isTrue(const SATLiteral& lit) const
@@ -1454,7 +1551,9 @@ TWLSolver::SatLoopResult TWLSolver::runSatLoop(unsigned conflictCountLimit)
       PackedAsgnVal asgn = _lastAssignments[choiceVar];
       if(asgn==AS_UNDEFINED) {
 //	asgn = (getWatchStack(choiceVar, 0).size()>getWatchStack(choiceVar, 1).size()) ? AS_FALSE : AS_TRUE;
-	asgn = (getWatchStack(choiceVar, 0).size()>getWatchStack(choiceVar, 1).size()) ? AS_TRUE : AS_FALSE;
+	size_t negOccs = getWatchStack(choiceVar, 0).size()+getBinaryWatchStack(choiceVar, 0).size();
+	size_t posOccs = getWatchStack(choiceVar, 1).size()+getBinaryWatchStack(choiceVar, 1).size();
+	asgn = (negOccs>posOccs) ? AS_TRUE : AS_FALSE;
       }
       makeChoiceAssignment(choiceVar, asgn);
     }
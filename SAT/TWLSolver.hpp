@@ -59,6 +59,27 @@ struct Watch
 
 typedef Stack<Watch> WatchStack;
 
+/**
+ * Entry of the implication list of a literal for a binary clause.
+ *
+ * The other literal of the clause is stored right in the entry,
+ * so propagating along binary clauses needs no access to the clause.
+ */
+struct BinaryWatch
+{
+  BinaryWatch() {}
+  BinaryWatch(SATClause* cl, SATLiteral other) : other(other), cl(cl)
+  {
+    CALL("BinaryWatch::BinaryWatch/2");
+    ASS_EQ(cl->length(),2);
+    ASS((*cl)[0]==other || (*cl)[1]==other);
+  }
+  SATLiteral other;
+  SATClause* cl;
+};
+
+typedef Stack<BinaryWatch> BinaryWatchStack;
+
 
 class TWLSolver : public SATSolverWithAssumptions {
   friend class ClauseDisposer;
@@ -142,6 +163,9 @@ private:
   WatchStack& getWatchStack(SATLiteral lit);
   WatchStack& getWatchStack(unsigned var, unsigned polarity);
   WatchStack& getTriggeredWatchStack(unsigned var, PackedAsgnVal assignment);
+  BinaryWatchStack& getBinaryWatchStack(SATLiteral lit);
+  BinaryWatchStack& getBinaryWatchStack(unsigned var, unsigned polarity);
+  BinaryWatchStack& getTriggeredBinaryWatchStack(unsigned var, PackedAsgnVal assignment);
 
   bool isTrue(const SATLiteral& lit) const;
   bool isFalse(const SATLiteral& lit) const;
@@ -201,6 +225,7 @@ private:
 
   ClauseVisitResult visitWatchedClause(Watch watch, unsigned var, unsigned& litIndex);
 
+  SATClause* propagateBinary(unsigned var);
   SATClause* propagate(unsigned var);
 
   void getTwoHighestAssignmentLevels(SATClause* cl, unsigned& highestAL, unsigned& secondHighestAL);
@@ -272,6 +297,14 @@ private:
    * or it's two watched literals are undefined.
    */
   DArray<WatchStack> _windex;
+  /**
+   * Implication lists of binary clauses, which are not
+   * in @c _windex.
+   *
+   * A binary clause is in the lists of both its literals
+   * (the list of a literal is triggered when it becomes false).
+   */
+  DArray<BinaryWatchStack> _bindex;
 
   /**
    * Number of variables the solver is able to handle.
@@ -53,7 +53,7 @@ using namespace Lib;
 Z3Interfacing::Z3Interfacing(const Shell::Options& opts,SAT2FO& s2f, bool unsatCoresForAssumptions):
   _varCnt(0), sat2fo(s2f),_status(SATISFIABLE), _solver(_context),
   _model((_solver.check(),_solver.get_model())), _assumptions(_context), _unsatCoreForAssumptions(unsatCoresForAssumptions),
-  _showZ3(opts.showZ3()),_unsatCoreForRefutations(opts.z3UnsatCores())
+  _showZ3(opts.showZ3()),_unsatCoreForRefutations(opts.z3UnsatCores()), _declarations(_context)
 {
   CALL("Z3Interfacing::Z3Interfacing");
   _solver.reset();
@@ -143,6 +143,29 @@ SATSolver::Status Z3Interfacing::solve(unsigned conflictCountLimit)
   return _status;
 }
 
+void Z3Interfacing::push()
+{
+  CALL("Z3Interfacing::push");
+  BYPASSING_ALLOCATOR;
+
+  _solver.push();
+  _scopes.push(_scopeNamed.size());
+}
+
+void Z3Interfacing::pop()
+{
+  CALL("Z3Interfacing::pop");
+  BYPASSING_ALLOCATOR;
+  ASS(_scopes.isNonEmpty());
+
+  _solver.pop();
+  // the namings added in the scope are gone with it
+  unsigned start = _scopes.pop();
+  while (_scopeNamed.size()>start) {
+    _namedExpressions.remove(_scopeNamed.pop());
+  }
+}
+
 SATSolver::Status Z3Interfacing::solveUnderAssumptions(const SATLiteralStack& assumps, unsigned conflictCountLimit, bool onlyProperSubusets,bool withGuard)
 {
   CALL("Z3Interfacing::solveUnderAssumptions");
@@ -153,7 +176,7 @@ SATSolver::Status Z3Interfacing::solveUnderAssumptions(const SATLiteralStack& as
 
   ASS(!hasAssumptions());
 
-  _solver.push();
+  push();
 
   // load assumptions:
   SATLiteralStack::ConstIterator it(assumps);
@@ -174,7 +197,7 @@ SATSolver::Status Z3Interfacing::solveUnderAssumptions(const SATLiteralStack& as
 
   z3::check_result result = _solver.check();
 
-  _solver.pop();
+  pop();
 
   if (result == z3::check_result::unsat) {
 
@@ -379,14 +402,23 @@ z3::expr Z3Interfacing::getz3expr(Term* trm,bool isLit,bool&nameExpression,bool
     if(trm->arity()==0){
       if(symb->integerConstant()){
         IntegerConstantType value = symb->integerValue();
+        if(value.isBig()){
+          return _context.int_val(value.toString().c_str());
+        }
         return _context.int_val(value.toInner());
       }
       if(symb->realConstant()){
         RealConstantType value = symb->realValue();
+        if(value.numerator().isBig() || value.denominator().isBig()){
+          return _context.real_val(value.toString().c_str());
+        }
         return _context.real_val(value.numerator().toInner(),value.denominator().toInner());
       }
       if(symb->rationalConstant()){
         RationalConstantType value = symb->rationalValue();
+        if(value.numerator().isBig() || value.denominator().isBig()){
+          return _context.real_val(value.toString().c_str());
+        }
         return _context.real_val(value.numerator().toInner(),value.denominator().toInner());
       }
       if(!isLit && env.signature->isFoolConstantSymbol(true,trm->functor())){
@@ -678,12 +710,18 @@ z3::expr Z3Interfacing::getz3expr(Term* trm,bool isLit,bool&nameExpression,bool
 
     }
     //TODO check domain_sorts for args in equality and interpretted?
-    z3::sort_vector domain_sorts = z3::sort_vector(_context);
-    for(unsigned i=0;i<type->arity();i++){
-      domain_sorts.push_back(getz3sort(type->arg(i)));
+    DHMap<unsigned,unsigned>& decls = isLit ? _predicateDecls : _functionDecls;
+    unsigned* declIndex;
+    if(decls.getValuePtr(trm->functor(),declIndex)){
+      z3::sort_vector domain_sorts = z3::sort_vector(_context);
+      for(unsigned i=0;i<type->arity();i++){
+        domain_sorts.push_back(getz3sort(type->arg(i)));
+      }
+      z3::symbol name = _context.str_symbol(symb->name().c_str());
+      *declIndex = _declarations.size();
+      _declarations.push_back(_context.function(name,domain_sorts,getz3sort(range_sort)));
     }
-    z3::symbol name = _context.str_symbol(symb->name().c_str());
-    z3::func_decl f = _context.function(name,domain_sorts,getz3sort(range_sort));
+    z3::func_decl f = _declarations[*declIndex];
 
     // Finally create expr
     z3::expr e = f(args); 
@@ -710,6 +748,9 @@ z3::expr Z3Interfacing::getRepresentation(SATLiteral slit,bool withGuard)
       //cout << "got rep " << e << endl;
 
       if(nameExpression && _namedExpressions.insert(slit.var())) {
+        if(_scopes.isNonEmpty()){
+          _scopeNamed.push(slit.var());
+        }
         z3::expr bname = getNameExpr(slit.var()); 
         //cout << "Naming " << e << " as " << bname << endl;
         z3::expr naming = (bname == e);
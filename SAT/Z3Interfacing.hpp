@@ -136,8 +136,19 @@ public:
   void reset(){
     sat2fo.reset();
     _solver.reset();
+    _namedExpressions.reset();
+    _scopes.reset();
+    _scopeNamed.reset();
     _status = UNKNOWN; // I set it to unknown as I do not reset
   }
+
+  /**
+   * Open a scope. The clauses added after this call are retracted
+   * by the matching pop(), while the declarations and what the solver
+   * learned at the outer levels are kept.
+   */
+  void push();
+  void pop();
 private:
   // just to conform to the interface
   unsigned _varCnt;
@@ -193,6 +204,15 @@ private:
   bool _unsatCoreForRefutations;
 
   DHSet<unsigned> _namedExpressions;
+  /** variables named since the opening of each scope, see push() */
+  Stack<unsigned> _scopeNamed;
+  /** for each open scope the size of @b _scopeNamed when it was opened */
+  Stack<unsigned> _scopes;
+
+  /** declarations of the uninterpreted symbols, indexed by @b _functionDecls and @b _predicateDecls */
+  z3::func_decl_vector _declarations;
+  DHMap<unsigned,unsigned> _functionDecls;
+  DHMap<unsigned,unsigned> _predicateDecls;
 
   z3::expr getNameExpr(unsigned var){
     vstring name = "v"+Lib::Int::toString(var);
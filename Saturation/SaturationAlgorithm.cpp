@@ -116,6 +116,7 @@ SaturationAlgorithm::SaturationAlgorithm(Problem& prb, const Options& opt)
   : MainLoop(prb, opt),
     _limits(opt),
     _clauseActivationInProgress(false),
+    _releasePremises(false),
     _fwSimplifiers(0), _bwSimplifiers(0), _splitter(0),
     _consFinder(0), _labelFinder(0), _symEl(0), _answerLiteralManager(0),
     _instantiation(0),
@@ -174,6 +175,11 @@ SaturationAlgorithm::SaturationAlgorithm(Problem& prb, const Options& opt)
     _limits.setLimits(0,opt.maxWeight(),true);
   }
 
+  //premises are needed for the proof, and until the end of the search for interpolants and clause priorities
+  if (opt.releasePremises() && opt.proof()==Options::Proof::OFF && !env.colorUsed && !env.clausePriorities) {
+    _releasePremises = true;
+  }
+
   s_instance=this;
 }
 
@@ -750,6 +756,30 @@ void SaturationAlgorithm::addNewClause(Clause* cl)
   cl->decRefCnt();
 }
 
+/**
+ * Replace the inference of @b cl by an inference of the same rule and
+ * depth without premises, so that the premises can be deleted
+ *
+ * Everything computed from the premises of a new clause (split set,
+ * parenthood, induction depth) must have been computed before.
+ */
+void SaturationAlgorithm::releasePremises(Clause* cl)
+{
+  CALL("SaturationAlgorithm::releasePremises");
+
+  Inference* inf = cl->inference();
+  Inference::Iterator iit = inf->iterator();
+  if (!inf->hasNext(iit)) {
+    //nothing is kept alive by the inference (or it was released already)
+    return;
+  }
+
+  Inference* released = new Inference(inf->rule());
+  released->setMaxDepth(inf->maxDepth());
+  cl->setInference(released);
+  inf->destroy();
+}
+
 void SaturationAlgorithm::newClausesToUnprocessed()
 {
   CALL("SaturationAlgorithm::newClausesToUnprocessed");
@@ -776,6 +806,10 @@ void SaturationAlgorithm::newClausesToUnprocessed()
       ASSERTION_VIOLATION_REP(cl->store());
 #endif
     }
+    if (_releasePremises && !cl->isFromPreprocessing()) {
+      //the split set and the parenthood of cl have been established by now
+      releasePremises(cl);
+    }
     cl->decRefCnt(); //belongs to _newClauses.popWithoutDec()
   }
 }
@@ -171,6 +171,7 @@ private:
 
   void handleEmptyClause(Clause* cl);
   Clause* doImmediateSimplification(Clause* cl);
+  void releasePremises(Clause* cl);
   MainLoopResult saturateImpl();
   Limits _limits;
   SmartPtr<IndexManager> _imgr;
@@ -184,6 +185,8 @@ protected:
   bool _completeOptionSettings;
   int _startTime;
   bool _clauseActivationInProgress;
+  /** true if the premises of new clauses are released (option release_premises) */
+  bool _releasePremises;
 
   RCClauseStack _newClauses;
 
@@ -54,6 +54,8 @@
 #include "SAT/MinisatInterfacing.hpp"
 #include "SAT/Z3Interfacing.hpp"
 
+#include "DP/CombinedDP.hpp"
+#include "DP/LinearArithmeticDP.hpp"
 #include "DP/ShortConflictMetaDP.hpp"
 
 #include "SaturationAlgorithm.hpp"
@@ -116,13 +118,22 @@ void SplittingBranchSelector::init()
   }
   _minSCO = _parent.getOptions().splittingMinimizeModel() == Options::SplittingMinimizeModel::SCO;
 
-  if(_parent.getOptions().splittingCongruenceClosure() != Options::SplittingCongruenceClosure::OFF) {
-    _dp = new DP::SimpleCongruenceClosure(&_parent.getOrdering());
+  bool congruenceClosure = _parent.getOptions().splittingCongruenceClosure() != Options::SplittingCongruenceClosure::OFF;
+  bool linearArithmetic = _parent.getOptions().splittingLinearArithmetic();
+  if(congruenceClosure || linearArithmetic) {
+    if (congruenceClosure) {
+      _dp = new DP::SimpleCongruenceClosure(&_parent.getOrdering());
+    }
+    if (linearArithmetic) {
+      DecisionProcedure* la = new DP::LinearArithmeticDP();
+      _dp = congruenceClosure ? new DP::CombinedDP(_dp.release(), la) : la;
+    }
     if (_parent.getOptions().ccUnsatCores() == Options::CCUnsatCores::SMALL_ONES) {
       _dp = new ShortConflictMetaDP(_dp.release(), _parent.satNaming(), *_solver);
     }
     _ccMultipleCores = (_parent.getOptions().ccUnsatCores() != Options::CCUnsatCores::FIRST);
-
+  }
+  if(congruenceClosure) {
     _ccModel = (_parent.getOptions().splittingCongruenceClosure() == Options::SplittingCongruenceClosure::MODEL);
     if (_ccModel) {
       _dpModel = new DP::SimpleCongruenceClosure(&_parent.getOrdering());
@@ -411,6 +422,52 @@ int SplittingBranchSelector::assertedGroundPositiveEqualityCompomentMaxAge()
   return max;
 }
 
+/**
+ * Make @b dp contain exactly the literals of @b assignment
+ * (only the positive equalities if @b onlyEqualities is true).
+ *
+ * Each literal is asserted at its own backtracking level, so that
+ * only the literals after the longest common prefix with the previously
+ * asserted ones need to be retracted and added again. As the assignment
+ * is collected in the order of SAT variables, the older components
+ * tend to stay at the bottom of the stack.
+ */
+void SplittingBranchSelector::updateDPAssignment(DecisionProcedure& dp, LiteralStack& asserted,
+    const LiteralStack& assignment, bool onlyEqualities)
+{
+  CALL("SplittingBranchSelector::updateDPAssignment");
+  ASS_EQ(dp.level(),asserted.size());
+
+  static LiteralStack toAssert;
+  toAssert.reset();
+
+  LiteralStack::ConstIterator ait(assignment);
+  while(ait.hasNext()) {
+    Literal* lit = ait.next();
+    if(!onlyEqualities || (lit->isEquality() && lit->isPositive())) {
+      toAssert.push(lit);
+    }
+  }
+
+  unsigned common = 0;
+  while(common<asserted.size() && common<toAssert.size() && asserted[common]==toAssert[common]) {
+    common++;
+  }
+
+  dp.pop(asserted.size()-common);
+  asserted.truncate(common);
+
+  RSTAT_CTR_INC_MANY("ssat_dp_kept_literals",common);
+  RSTAT_CTR_INC_MANY("ssat_dp_asserted_literals",toAssert.size()-common);
+
+  for(unsigned i=common; i<toAssert.size(); i++) {
+    Literal* lit = toAssert[i];
+    dp.push();
+    dp.addLiterals(pvi( getSingletonIterator(lit) ), onlyEqualities);
+    asserted.push(lit);
+  }
+}
+
 SATSolver::Status SplittingBranchSelector::processDPConflicts()
 {
   CALL("SplittingBranchSelector::processDPConflicts");
@@ -433,8 +490,7 @@ SATSolver::Status SplittingBranchSelector::processDPConflicts()
       s2f.collectAssignment(*_solver, gndAssignment); 
       // ... moreover, _dp->addLiterals will filter the set anyway
 
-      _dp->reset();
-      _dp->addLiterals(pvi( LiteralStack::ConstIterator(gndAssignment) ));
+      updateDPAssignment(*_dp, _dpAsserted, gndAssignment, false);
       DecisionProcedure::Status dpStatus = _dp->getStatus(_ccMultipleCores);
 
       if(dpStatus!=DecisionProcedure::UNSATISFIABLE) {
@@ -481,8 +537,7 @@ SATSolver::Status SplittingBranchSelector::processDPConflicts()
     static LiteralStack model;
     model.reset();
 
-    _dpModel->reset();
-    _dpModel->addLiterals(pvi( LiteralStack::ConstIterator(gndAssignment) ),true /*only equalities now*/);
+    updateDPAssignment(*_dpModel, _dpModelAsserted, gndAssignment, true /*only equalities now*/);
     ALWAYS(_dpModel->getStatus(false) == DecisionProcedure::SATISFIABLE);
     _dpModel->getModel(model);
 
@@ -601,7 +656,36 @@ void SplittingBranchSelector::addSatClauseToSolver(SATClause* cl, bool branchRef
   if (branchRefutation && _minSCO) {
     _solver->addClauseIgnoredInPartialModel(cl);
   } else {
-    _solver->addClause(cl);
+    _solver->addDisposableClause(cl);
+  }
+}
+
+/**
+ * Add the split clauses @b cls to the solver in one go.
+ * (None of them is a branch refutation.)
+ *
+ * The clauses are not to be used after this call.
+ */
+void SplittingBranchSelector::addSatClausesToSolver(SATClauseStack& cls)
+{
+  CALL("SplittingBranchSelector::addSatClausesToSolver");
+
+  SATClauseStack::DelIterator it(cls);
+  while(it.hasNext()) {
+    SATClause* cl = Preprocess::removeDuplicateLiterals(it.next());
+    if(!cl) {
+      RSTAT_CTR_INC("splitter_tautology");
+      it.del();
+      continue;
+    }
+    it.replace(cl);
+  }
+
+  RSTAT_CTR_INC_MANY("ssat_sat_clauses",cls.size());
+
+  SATClauseStack::Iterator cit(cls);
+  while(cit.hasNext()) {
+    _solver->addDisposableClause(cit.next());
   }
 }
 
@@ -685,6 +769,9 @@ Splitter::~Splitter()
 {
   CALL("Splitter::~Splitter");
 
+  while(_splitBatch.isNonEmpty()) {
+    _splitBatch.pop()->decRefCnt();
+  }
   while(_db.isNonEmpty()) {
     if(_db.top()) {
       delete _db.top();
@@ -727,6 +814,7 @@ void Splitter::init(SaturationAlgorithm* sa)
   _flushPeriod = opts.splittingFlushPeriod();
   _flushQuotient = opts.splittingFlushQuotient();
   _flushThreshold = sa->getGeneratedClauseCount() + _flushPeriod;
+  _splitBatchSize = opts.splittingSplitBatch();
   _congruenceClosure = opts.splittingCongruenceClosure();
 #if VZ3
   hasSMTSolver = (opts.satSolver() == Options::SatSolver::Z3);
@@ -816,6 +904,8 @@ void Splitter::onAllProcessed()
 {
   CALL("Splitter::onAllProcessed");
 
+  flushSplitBatch();
+
   bool flushing = false;
   if(_flushPeriod) {
     if(_haveBranchRefutation) {
@@ -1108,6 +1198,9 @@ bool Splitter::getComponents(Clause* cl, Stack<LiteralStack>& acc)
 
 /**
  * Attempt to split clause @b cl, and return true if successful
+ *
+ * With a non-zero avatar_split_batch, a splittable clause is only
+ * recorded here and its split clause is created in flushSplitBatch.
  */
 bool Splitter::doSplitting(Clause* cl)
 {
@@ -1130,6 +1223,31 @@ bool Splitter::doSplitting(Clause* cl)
     return handleNonSplittable(cl);
   }
 
+  if (_splitBatchSize) {
+    cl->incRefCnt(); //dec in flushSplitBatch
+    _splitBatch.push(cl);
+    _splitBatchCompCnts.push(comps.size());
+    for(unsigned i=0; i<comps.size(); ++i) {
+      _splitBatchComps.push(comps[i]);
+    }
+    if (_splitBatch.size()>=_splitBatchSize) {
+      flushSplitBatch();
+    }
+    return true; // the clause is ours now
+  }
+
+  addSatClauseToSolver(buildSplitClause(cl, comps.begin(), comps.size()), false);
+  return true;
+}
+
+/**
+ * Name the components @b comps of the clause @b cl and return
+ * the SAT clause recording the split of @b cl
+ */
+SATClause* Splitter::buildSplitClause(Clause* cl, const LiteralStack* comps, unsigned compCnt)
+{
+  CALL("Splitter::buildSplitClause");
+
   static SATLiteralStack satClauseLits;
   satClauseLits.reset();
 
@@ -1139,7 +1257,6 @@ bool Splitter::doSplitting(Clause* cl)
   UnitList* ps = 0;
   FormulaList* resLst=0;
 
-  unsigned compCnt = comps.size();
   for(unsigned i=0; i<compCnt; ++i) {
     const LiteralStack& comp = comps[i];
     Clause* compCl;
@@ -1174,10 +1291,46 @@ bool Splitter::doSplitting(Clause* cl)
 
   splitClause->setInference(new FOConversionInference(scl));
 
-  addSatClauseToSolver(splitClause, false);
-
   env.statistics->satSplits++;
-  return true;
+  return splitClause;
+}
+
+/**
+ * Name the components of all the clauses collected by doSplitting
+ * and pass the resulting split clauses to the SAT solver at once.
+ *
+ * Must be called before the model is recomputed.
+ */
+void Splitter::flushSplitBatch()
+{
+  CALL("Splitter::flushSplitBatch");
+
+  if (_splitBatch.isEmpty()) {
+    return;
+  }
+
+  static SATClauseStack splitClauses;
+  splitClauses.reset();
+
+  const LiteralStack* comps = _splitBatchComps.begin();
+  for(unsigned i=0; i<_splitBatch.size(); ++i) {
+    Clause* cl = _splitBatch[i];
+    unsigned compCnt = _splitBatchCompCnts[i];
+    splitClauses.push(buildSplitClause(cl, comps, compCnt));
+    comps += compCnt;
+    cl->decRefCnt(); //inc in doSplitting
+  }
+  ASS_EQ(comps, _splitBatchComps.end());
+
+  RSTAT_CTR_INC("ssat_split_batches");
+  RSTAT_CTR_INC_MANY("ssat_split_batch_clauses", _splitBatch.size());
+
+  _splitBatch.reset();
+  _splitBatchComps.reset();
+  _splitBatchCompCnts.reset();
+
+  _clausesAdded = true;
+  _branchSelector.addSatClausesToSolver(splitClauses);
 }
 
 /**
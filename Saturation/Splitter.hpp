@@ -82,12 +82,15 @@ _solver=0;
   void considerPolarityAdvice(SATLiteral lit);
 
   void addSatClauseToSolver(SATClause* cl, bool refutation);
+  void addSatClausesToSolver(SATClauseStack& cls);
   void recomputeModel(SplitLevelStack& addedComps, SplitLevelStack& removedComps, bool randomize = false);
 
   void flush(SplitLevelStack& addedComps, SplitLevelStack& removedComps);
 
 private:
   SATSolver::Status processDPConflicts();
+  void updateDPAssignment(DecisionProcedure& dp, LiteralStack& asserted,
+      const LiteralStack& assignment, bool onlyEqualities);
   SATSolver::VarAssignment getSolverAssimentConsideringCCModel(unsigned var);
 
   void handleSatRefutation();
@@ -109,6 +112,13 @@ private:
   ScopedPtr<DecisionProcedure> _dp;
   // use a separate copy of the decision procedure for ccModel computations and fill it up only with equalities
   ScopedPtr<SimpleCongruenceClosure> _dpModel;
+
+  /**
+   * Ground literals currently asserted in _dp (and _dpModel),
+   * the i-th literal was added at the backtracking level i+1.
+   */
+  LiteralStack _dpAsserted;
+  LiteralStack _dpModelAsserted;
   
   /**
    * Contains selected component names (splitlevels)
@@ -240,6 +250,9 @@ private:
 
   Clause* buildAndInsertComponentClause(SplitLevel name, unsigned size, Literal* const * lits, Clause* orig=0);
 
+  SATClause* buildSplitClause(Clause* cl, const LiteralStack* comps, unsigned compCnt);
+  void flushSplitBatch();
+
   SplitLevel tryGetComponentNameOrAddNew(const LiteralStack& comp, Clause* orig, Clause*& compCl);
   SplitLevel tryGetComponentNameOrAddNew(unsigned size, Literal* const * lits, Clause* orig, Clause*& compCl);
 
@@ -257,6 +270,7 @@ private:
   Options::SplittingNonsplittableComponents _nonsplComps;
   unsigned _flushPeriod;
   float _flushQuotient;
+  unsigned _splitBatchSize;
   Options::SplittingDeleteDeactivated _deleteDeactivated;
   Options::SplittingCongruenceClosure _congruenceClosure;
 #if VZ3
@@ -300,6 +314,19 @@ private:
    * and will invariably change the SAT model.
    */
   RCClauseStack _fastClauses;
+
+  /**
+   * Splittable clauses waiting to have their components named and
+   * their split clauses passed to the SAT solver (only used when
+   * _splitBatchSize is non-zero).
+   *
+   * The components of the i-th clause are the next _splitBatchCompCnts[i]
+   * entries of _splitBatchComps. Clauses here have their reference
+   * counter increased.
+   */
+  ClauseStack _splitBatch;
+  Stack<LiteralStack> _splitBatchComps;
+  Stack<unsigned> _splitBatchCompCnts;
   
   SaturationAlgorithm* _sa;
 
@@ -34,6 +34,7 @@
 #include "Kernel/Clause.hpp"
 #include "Kernel/Formula.hpp"
 #include "Kernel/FormulaUnit.hpp"
+#include "Kernel/Problem.hpp"
 
 #include "Shell/Normalisation.hpp"
 #include "Shell/Options.hpp"
@@ -132,14 +133,14 @@ void Builder::build(VirtualIterator<vstring> fnameIterator)
 
   //first we need to prepare otions for the clausifier
   Options clausifyOptions(*env.options);
-  clausifyOptions._normalize=false;
-  clausifyOptions._sineSelection=Options::SS_OFF;
-  clausifyOptions._unusedPredicateDefinitionRemoval=false;
-  clausifyOptions._functionDefinitionElimination=Options::FDE_NONE;
-  clausifyOptions._inequalitySplitting=0;
-  clausifyOptions._equalityResolutionWithDeletion=Options::RA_OFF;
-  clausifyOptions._equalityProxy=Options::EP_OFF;
-  clausifyOptions._generalSplitting=Options::RA_OFF;
+  clausifyOptions.setNormalize(false);
+  clausifyOptions.setSineSelection(Options::SineSelection::OFF);
+  clausifyOptions.setUnusedPredicateDefinitionRemoval(false);
+  clausifyOptions.set("function_definition_elimination","none");
+  clausifyOptions.set("inequality_splitting","0");
+  clausifyOptions.set("equality_resolution_with_deletion","off");
+  clausifyOptions.set("equality_proxy","off");
+  clausifyOptions.set("general_splitting","off");
 
   bool haveEmptyClause=false;
 
@@ -151,10 +152,10 @@ void Builder::build(VirtualIterator<vstring> fnameIterator)
     UnitList* localUnits=0;
     UnitList::push(u, localUnits);
 
-    Property* prop = Property::scan(localUnits);
-    Preprocess preproc(*prop,clausifyOptions);
-    preproc.preprocess(localUnits);
-    delete prop;
+    Problem prb(localUnits);
+    Preprocess preproc(clausifyOptions);
+    preproc.preprocess(prb);
+    localUnits=prb.units();
 
     //here we go through generated clauses and we check whether there isn't an empty clause
     //(as storage.storeCNFOfUnit doesn't allow storing them)
@@ -177,6 +178,7 @@ cnf_storing_finished:
 
   storage.storeEmptyClausePossession(haveEmptyClause);
   if(haveEmptyClause) {
+    storage.finishStoring();
     return;
   }
 
@@ -186,7 +188,6 @@ cnf_storing_finished:
 
   //from here starts the SInE related part
 
-  _symExtr.onSignatureChange();
   SymId symIdBound=_symExtr.getSymIdBound();
 
   //determine symbol generality
@@ -280,6 +281,7 @@ cnf_storing_finished:
   }
 
   storage.storeUnitsWithoutSymbols(_unitsWithoutSymbols);
+  storage.finishStoring();
 }
 
 void Builder::updateDefRelation(Unit* u)
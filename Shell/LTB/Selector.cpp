@@ -131,22 +131,13 @@ SymIdIterator TranslatingSymbolCollector::getSymIds()
   }
 
 
-  int globPreds;
-  int globFuns;
-  _storage->getSignatureSize(globPreds, globFuns);
-
   VirtualIterator<pair<bool, unsigned> > results=_storage->getGlobalSymbols(queries);
   List<SymId>* res=0;
 
   while(results.hasNext()) {
     pair<bool, unsigned> s=results.next();
-    SymId sid;
-    if(s.first) {
-      sid=s.second;
-    }
-    else {
-      sid=globPreds+s.second;
-    }
+    //the same encoding as in SineSymbolExtractor::decodeSymId
+    SymId sid=2*s.second+(s.first ? 0 : 1);
     List<SymId>::push(sid, res);
   }
 
@@ -162,7 +153,7 @@ void Selector::selectForProblem(UnitList*& units)
 
   if(_storage.getEmptyClausePossession()) {
     Clause* cl=Clause::fromIterator(VirtualIterator<Literal*>::getEmpty(), Unit::AXIOM, new Inference(Inference::THEORY));
-    units->destroy();
+    UnitList::destroy(units);
     units=0;
     UnitList::push(cl, units);
     return;
@@ -21,9 +21,12 @@
  * Implements class Storage.
  */
 
-#include <malloc.h>
+#include <cerrno>
+#include <cstdio>
 #include <string.h>
-#include <libmemcached/memcached.h>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "Debug/Assertion.hpp"
 #include "Debug/RuntimeStatistics.hpp"
@@ -33,12 +36,15 @@
 #include "Lib/Exception.hpp"
 #include "Lib/Environment.hpp"
 #include "Lib/Int.hpp"
+#include "Lib/MappedFile.hpp"
+#include "Lib/Sort.hpp"
 #include "Lib/Stack.hpp"
 #include "Lib/Vector.hpp"
 
 #include "Kernel/Clause.hpp"
 #include "Kernel/Inference.hpp"
 #include "Kernel/Signature.hpp"
+#include "Kernel/Sorts.hpp"
 #include "Kernel/Term.hpp"
 #include "Kernel/TermIterators.hpp"
 
@@ -54,48 +60,51 @@ using namespace Kernel;
 
 const unsigned Storage::storedIntMaxSize;
 
+/**
+ * Name of the file holding the storage, in the current directory
+ */
+static const char* STORAGE_FILE_NAME = "vampire_ltb_storage";
+
+/**
+ * An embedded key/value store kept in the file STORAGE_FILE_NAME.
+ *
+ * While the storage is being built, the records are appended to a
+ * temporary file, each as (key length, value length, key, value),
+ * and only the keys and offsets of the records are kept in memory.
+ * finishBuilding() appends an index of the record offsets sorted by
+ * the keys and a trailer, and renames the file to STORAGE_FILE_NAME,
+ * so a storage that is still being built is never seen by the readers.
+ * A storage destroyed before finishBuilding() is discarded.
+ *
+ * A built storage is memory mapped and keys are looked up by binary
+ * search in the index, so retrieving a value costs no more than a few
+ * page cache accesses.
+ */
 class Storage::StorageImpl
 {
 public:
-  StorageImpl()
+  StorageImpl() : _fd(-1), _written(0), _buf(BUFFER_SIZE), _bufUsed(0), _index(0), _recordCnt(0)
   {
     CALL("Storage::StorageImpl::StorageImpl");
-
-    memc=memcached_create(&memcObj);
-    ASS_EQ(memc, &memcObj);
-
-    memcached_return res;
-    res=memcached_behavior_set(memc, MEMCACHED_BEHAVIOR_BINARY_PROTOCOL, 1);
-    if(res!=MEMCACHED_SUCCESS) { ASSERTION_VIOLATION_REP(res); INVALID_OPERATION("memcached fail"); }
-
-    res=memcached_server_add_unix_socket(memc, "vampire_mc_socket");
-    if(res!=MEMCACHED_SUCCESS) {
-      USER_ERROR("Cannot connect to memcached socket: "+Int::toString(res));
-    }
-
-    resStruct=memcached_result_create(memc, &resStructObj);
-    ASS_EQ(resStruct, &resStructObj);
   }
   ~StorageImpl()
   {
     CALL("Storage::StorageImpl::~StorageImpl");
 
-    memcached_result_free(resStruct);
-
-    memcached_free(memc);
+    if(_fd!=-1) {
+      //the building did not finish, so there is nothing to be kept
+      close(_fd);
+      unlink(tmpFileName().c_str());
+    }
   }
 
   vstring getString(const char* key, size_t keyLen, bool allowMiss=false)
   {
     CALL("Storage::StorageImpl::getString");
-    ASS_L(keyLen, MEMCACHED_MAX_KEY);
 
-    memcached_return res;
+    const char* value;
     size_t valueLen;
-    char* valueChars;
-    uint32_t flags;
-    valueChars=memcached_get(memc, key, keyLen, &valueLen, &flags, &res);
-    if(res==MEMCACHED_NOTFOUND) {
+    if(!find(key, keyLen, value, valueLen)) {
       if(allowMiss) {
 	return "";
       }
@@ -103,16 +112,7 @@ public:
 	throw StorageCorruptedException();
       }
     }
-    if(res!=MEMCACHED_SUCCESS) { ASSERTION_VIOLATION_REP(res); INVALID_OPERATION("memcached fail"); }
-    if(!valueChars) {
-      if(valueLen!=0) { ASSERTION_VIOLATION_REP(valueLen); INVALID_OPERATION("memcached fail"); }
-      //empty string was stored
-      return "";
-    }
-
-    vstring valueString(valueChars, valueLen);
-    free(valueChars);
-    return valueString;
+    return vstring(value, valueLen);
   }
 
   /**
@@ -125,133 +125,251 @@ public:
     CALL("Storage::StorageImpl::getStrings");
 
     size_t keyCnt=keys.size();
-
-    //there seems to be a problem with the memcached_fetch in the libmemcached library,
-    //so we just ask multiple times.
-#if 1
-    Vector<vstring>* values=Vector<vstring>::allocate(keys.size());
+    Vector<vstring>* values=Vector<vstring>::allocate(keyCnt);
     for(size_t i=0;i<keyCnt;i++) {
       (*values)[i]=getString(keys[i].c_str(), keys[i].size(), true);
     }
     return pvi( Vector<vstring>::DestructiveIterator(*values) );
-#else
-    if(keyCnt==0) {
-      return StringIterator::getEmpty();
+  }
+
+  void add(const char* key, size_t keyLen, const char* val, size_t valLen)
+  {
+    CALL("Storage::StorageImpl::add");
+    ASS_G(keyLen,0);
+    ASS_REP(key[0]==THEORY_FILES || key[0]==PRED_NUM_NAME || key[0]==FUN_NUM_NAME
+	|| key[0]==HAS_EMPTY_CLAUSE || valLen%storedIntMaxSize==0, (int)key[0]);
+
+    if(_fd==-1) {
+      startBuilding();
     }
 
-    if(keyCnt==1) {
-      vstring key=keys.top();
-      return pvi( getSingletonIterator( getString(key.c_str(), key.size(), true) ) );
+    if(!_offsets.insert(vstring(key, keyLen), _written+_bufUsed)) {
+      //the same key cannot be stored twice
+      ASSERTION_VIOLATION;
+      INVALID_OPERATION("LTB storage key stored twice");
     }
 
-    static DArray<const char*> keyPtrs;
-    static DArray<size_t> keyLengths;
-    keyPtrs.ensure(keyCnt);
-    keyLengths.ensure(keyCnt);
-    size_t maxKeyLen=0;
+    RecordHeader hdr;
+    hdr.keyLen=keyLen;
+    hdr.valLen=valLen;
+    append(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    append(key, keyLen);
+    append(val, valLen);
+  }
 
-    for(size_t i=0;i<keyCnt;i++) {
-      keyPtrs[i]=keys[i].c_str();
-      size_t keyLen=keys[i].size();
-      keyLengths[i]=keyLen;
-      if(keyLen>maxKeyLen) {
-	maxKeyLen=keyLen;
-      }
+  /**
+   * Append the sorted index and the trailer, and make the storage
+   * available under its final name.
+   */
+  void finishBuilding()
+  {
+    CALL("Storage::StorageImpl::finishBuilding");
+
+    if(_fd==-1) {
+      startBuilding();
     }
-    ASS_L(maxKeyLen, MEMCACHED_MAX_KEY);
 
-    memcached_return res;
+    Stack<IndexEntry> entries(_offsets.size());
+    DHMap<vstring,size_t>::Iterator oit(_offsets);
+    while(oit.hasNext()) {
+      IndexEntry e;
+      oit.next(e.key, e.offset);
+      entries.push(e);
+    }
+    _offsets.reset();
+    sort<IndexEntry>(entries.begin(), entries.end());
+
+    Trailer trailer;
+    trailer.indexOffset=_written+_bufUsed;
+    trailer.recordCnt=entries.size();
+    trailer.magic=STORAGE_MAGIC;
+
+    Stack<IndexEntry>::BottomFirstIterator eit(entries);
+    while(eit.hasNext()) {
+      size_t offset=eit.next().offset;
+      append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    }
+    append(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+    flush();
 
-    //in the memcached header file, the second argument is of type char**,
-    //however in the documentation it is of type const char * const *
-    res=memcached_mget(memc, const_cast<char**>(keyPtrs.array()), keyLengths.array(), keyCnt);
-    if(res!=MEMCACHED_SUCCESS) { ASSERTION_VIOLATION_REP(res); INVALID_OPERATION("memcached fail"); }
+    int fd=_fd;
+    _fd=-1;
+    if(close(fd)!=0 || rename(tmpFileName().c_str(), STORAGE_FILE_NAME)!=0) {
+      SYSTEM_FAIL("Cannot write the LTB storage file "+vstring(STORAGE_FILE_NAME), errno);
+    }
+  }
 
-    Vector<vstring>* values=Vector<vstring>::allocate(keys.size());
+private:
+  struct RecordHeader
+  {
+    unsigned keyLen;
+    unsigned valLen;
+  };
+  struct Trailer
+  {
+    /** position of the index in the file */
+    size_t indexOffset;
+    size_t recordCnt;
+    unsigned magic;
+  };
+  struct IndexEntry
+  {
+    IndexEntry() {}
+    IndexEntry(vstring key, size_t offset) : key(key), offset(offset) {}
+    vstring key;
+    size_t offset;
+
+    static Comparison compare(const IndexEntry& a, const IndexEntry& b)
+    {
+      int res=a.key.compare(b.key);
+      return res==0 ? EQUAL : (res<0 ? LESS : GREATER);
+    }
+  };
 
-    //now let's retrieve the results
+  static const unsigned STORAGE_MAGIC=0x5642544c;
+  static const size_t BUFFER_SIZE=1<<20;
 
-    //We assume the results will most likely be retrieved in order of the keys.
-    //In @b nextResIndex we store index of the first key that doesn't have its
-    //value retrieved yet.
-    size_t nextResIndex=0;
+  static vstring tmpFileName()
+  { return vstring(STORAGE_FILE_NAME)+".tmp"; }
 
-    static DArray<char> keyBuf;
-    keyBuf.ensure(maxKeyLen+1);
-    for(;;) {
-      size_t keyLen, valLen;
-      uint32_t flags;
-      char* valueChars=memcached_fetch(memc, keyBuf.array(), &keyLen, &valLen, &flags, &res);
-      if(!valueChars) {
-	ASS_EQ(res, MEMCACHED_END);
-	break;
-      }
-      if(res!=MEMCACHED_SUCCESS) { ASSERTION_VIOLATION_REP(res); INVALID_OPERATION("memcached fail"); }
-      ASS_L(nextResIndex,keyCnt); //if we got a value, we must also have some key without an answer
-      vstring valueStr(valueChars, valLen);
-      free(valueChars);
-      keyBuf[keyLen]=0;
-      //now we have a null-terminated string with key starting at keyBuf.array()
-
-      if(!strcmp(keyBuf.array(), keys[nextResIndex].c_str())) {
-	RSTAT_CTR_INC("in order memcached_mget results");
-	ASS_EQ((*values)[nextResIndex].size(),0);
-	(*values)[nextResIndex]=valueStr;
-	do {
-	  nextResIndex++;
-	} while(nextResIndex<keyCnt && (*values)[nextResIndex].size()!=0);
+  void startBuilding()
+  {
+    CALL("Storage::StorageImpl::startBuilding");
+
+    _fd=open(tmpFileName().c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+    if(_fd==-1) {
+      SYSTEM_FAIL("Cannot create the LTB storage file "+tmpFileName(), errno);
+    }
+  }
+
+  void append(const char* data, size_t len)
+  {
+    CALL("Storage::StorageImpl::append");
+
+    if(_bufUsed+len>BUFFER_SIZE) {
+      flush();
+      if(len>BUFFER_SIZE) {
+        write(data, len);
+        return;
       }
-      else {
-	RSTAT_CTR_INC("out of order memcached_mget results");
-	//let's find the position for the key we received
-	size_t i=nextResIndex+1;
-	//we do the check (*values)[i].size()!=0 only because it is
-	//easier to check for an empty string than to compare two strings
-	while(i<keyCnt && ( (*values)[i].size()!=0 || strcmp(keyBuf.array(), keys[i].c_str()) ) ) { i++; }
+    }
+    memcpy(_buf.array()+_bufUsed, data, len);
+    _bufUsed+=len;
+  }
 
-	//if we got a value, it's key must be there and without an answer yet
-	if(i==keyCnt) { ASSERTION_VIOLATION; INVALID_OPERATION("memcached fail"); }
+  void flush()
+  {
+    CALL("Storage::StorageImpl::flush");
 
-	(*values)[i]=valueStr;
+    write(_buf.array(), _bufUsed);
+    _bufUsed=0;
+  }
+
+  void write(const char* data, size_t len)
+  {
+    CALL("Storage::StorageImpl::write");
+
+    size_t remaining=len;
+    while(remaining) {
+      ssize_t res=::write(_fd, data, remaining);
+      if(res<=0) {
+	SYSTEM_FAIL("Cannot write the LTB storage file "+tmpFileName(), errno);
       }
+      data+=res;
+      remaining-=res;
     }
+    _written+=len;
+  }
 
-#if VDEBUG
-    for(size_t i=0;i<keyCnt;i++) {
-      vstring fetched=(*values)[i];
-      vstring check=getString(keys[i].c_str(), keys[i].size(), true);
-      ASS_REP2(fetched==check, fetched.size(), check.size());
+  void map()
+  {
+    CALL("Storage::StorageImpl::map");
+
+    if(!_file.open(STORAGE_FILE_NAME)) {
+      USER_ERROR("Cannot open the LTB storage file "+vstring(STORAGE_FILE_NAME));
+    }
+    if(_file.size()<sizeof(Trailer)) {
+      throw StorageCorruptedException();
+    }
+    Trailer trailer;
+    memcpy(&trailer, _file.data()+_file.size()-sizeof(Trailer), sizeof(Trailer));
+    if(trailer.magic!=STORAGE_MAGIC || trailer.indexOffset>_file.size()-sizeof(Trailer) ||
+	trailer.recordCnt!=(_file.size()-sizeof(Trailer)-trailer.indexOffset)/sizeof(size_t)) {
+      throw StorageCorruptedException();
     }
-#endif
+    _index=_file.data()+trailer.indexOffset;
+    _recordCnt=trailer.recordCnt;
+    //the lookups jump all over the file
+    _file.adviseRandomAccess();
+  }
 
-    return pvi( Vector<vstring>::DestructiveIterator(*values) );
-#endif
+  /**
+   * Return the key (through @b key and @b keyLen) and the value of the
+   * @b i-th record in the order of keys.
+   */
+  void getRecord(size_t i, const char*& key, size_t& keyLen, const char*& val, size_t& valLen)
+  {
+    size_t offset;
+    memcpy(&offset, _index+i*sizeof(size_t), sizeof(size_t));
+    RecordHeader hdr;
+    memcpy(&hdr, _file.data()+offset, sizeof(hdr));
+    key=_file.data()+offset+sizeof(hdr);
+    keyLen=hdr.keyLen;
+    val=key+keyLen;
+    valLen=hdr.valLen;
   }
 
-  void add(const char* key, size_t keyLen, const char* val, size_t valLen)
+  bool find(const char* key, size_t keyLen, const char*& val, size_t& valLen)
   {
-    CALL("Storage::StorageImpl::add");
-    ASS_G(keyLen,0);
-//    ASS(valLen<10000);
-    if(keyLen>=MEMCACHED_MAX_KEY) {
-      USER_ERROR("Maximum key length for memcached exceeded: "+Int::toString(keyLen));
-    }
-    if(valLen>=1000000) {
-      USER_ERROR("Maximum value length for memcached exceeded: "+Int::toString(valLen));
+    CALL("Storage::StorageImpl::find");
+    ASS_EQ(_fd,-1); //the storage cannot be read while being built
+
+    if(!_index) {
+      map();
     }
-    ASS_REP(key[0]==THEORY_FILES || key[0]==PRED_NUM_NAME || key[0]==FUN_NUM_NAME
-	|| key[0]==HAS_EMPTY_CLAUSE || valLen%storedIntMaxSize==0, (int)key[0]);
 
-    memcached_return res;
-    res=memcached_add(memc, key, keyLen, val, valLen, 0, 0);
-    if(res!=MEMCACHED_SUCCESS) { ASSERTION_VIOLATION_REP(res); INVALID_OPERATION("memcached fail"); }
+    size_t lo=0;
+    size_t hi=_recordCnt;
+    while(lo<hi) {
+      size_t mid=(lo+hi)/2;
+      const char* midKey;
+      size_t midKeyLen;
+      getRecord(mid, midKey, midKeyLen, val, valLen);
+      int cmp=memcmp(midKey, key, std::min(midKeyLen, keyLen));
+      if(cmp==0) {
+	if(midKeyLen==keyLen) {
+	  RSTAT_CTR_INC("ltb storage hits");
+	  return true;
+	}
+	cmp = midKeyLen<keyLen ? -1 : 1;
+      }
+      if(cmp<0) {
+	lo=mid+1;
+      }
+      else {
+	hi=mid;
+      }
+    }
+    RSTAT_CTR_INC("ltb storage misses");
+    return false;
   }
 
-private:
-  memcached_st* memc;
-  memcached_st memcObj;
-  memcached_result_st* resStruct;
-  memcached_result_st resStructObj;
+  /** descriptor of the file being built, or -1 */
+  int _fd;
+  /** number of bytes written into the file being built */
+  size_t _written;
+  /** data to be written into the file being built */
+  DArray<char> _buf;
+  /** number of bytes used in @b _buf */
+  size_t _bufUsed;
+  /** keys of the records in the file being built and their offsets */
+  DHMap<vstring,size_t> _offsets;
+
+  /** the built storage */
+  MappedFile _file;
+  /** start of the index in @b _file, or zero if not mapped yet */
+  const char* _index;
+  size_t _recordCnt;
 };
 
 Storage::Storage(bool translateSignature)
@@ -271,6 +389,18 @@ Storage::~Storage()
   delete _impl;
 }
 
+/**
+ * Make the stored data available to the readers of the storage.
+ * Must be called after all the data is stored, as a storage
+ * that is destroyed before is discarded.
+ */
+void Storage::finishStoring()
+{
+  CALL("Storage::finishStoring");
+
+  _impl->finishBuilding();
+}
+
 vstring Storage::getConstKey(KeyPrefix p)
 {
   CALL("Storage::getConstKey");
@@ -738,7 +868,7 @@ UnitList* Storage::getClausesByUnitNumbers(VirtualIterator<unsigned> numIt)
 	Literal* lit;
 	if(locFunctor==0) {
 	  ASS_EQ(arity, 2);
-	  lit=Literal::createEquality(polarity, termStack[0], termStack[1]);
+	  lit=Literal::createEquality(polarity, termStack[0], termStack[1], Sorts::SRT_DEFAULT);
 	}
 	else {
 	  lit=Literal::create(locFunctor, arity, polarity, false, termStack.begin());
@@ -101,6 +101,8 @@ public:
 
   void storeEmptyClausePossession(bool hasEmptyClause);
 
+  void finishStoring();
+
 private:
   class StorageImpl;
 
@@ -104,9 +104,12 @@ LispParser::Expression* LispParser::parse()
 //} // parse()
 
 /**
+ * Parse expressions into the list @c expr0 until the end of the input.
+ * If @c single is true, stop as soon as the list opened just before
+ * the call has been closed.
  * @since 26/08/2009 Redmond
  */
-void LispParser::parse(List** expr0)
+void LispParser::parse(List** expr0, bool single)
 {
   CALL("LispParser::parse/1");
 
@@ -164,12 +167,66 @@ void LispParser::parse(List** expr0)
     }
 
   parsing_level_done:
+    if (single && _balance==0) {
+      return;
+    }
     ASS(stack.isNonEmpty());
     expr = stack.pop();
   }
 
 } // parse()
 
+/**
+ * Read the next top-level expression, or return 0 at the end of the input.
+ * Unlike parse(), this does not build the expression list of the whole
+ * input, so the caller can process and destroy the expressions one by one.
+ */
+LispParser::Expression* LispParser::parseNext()
+{
+  CALL("LispParser::parseNext");
+  ASS_EQ(_balance,0);
+
+  Token t;
+  _lexer.readToken(t);
+  switch (t.tag) {
+  case TT_EOF:
+    return 0;
+  case TT_RPAR:
+    throw Exception("unmatched right parenthesis",t);
+  case TT_LPAR:
+    {
+      _balance++;
+      Expression* result = new Expression(LIST);
+      parse(&result->list,true);
+      return result;
+    }
+  default:
+    return new Expression(ATOM,t.text);
+  }
+} // parseNext()
+
+/**
+ * Destroy the expression together with all its subexpressions
+ */
+void LispParser::Expression::destroy()
+{
+  CALL("LispParser::Expression::destroy");
+
+  static Stack<Expression*> toDestroy;
+  ASS(toDestroy.isEmpty());
+
+  toDestroy.push(this);
+  while (toDestroy.isNonEmpty()) {
+    Expression* e = toDestroy.pop();
+    List::Iterator sit(e->list);
+    while (sit.hasNext()) {
+      toDestroy.push(sit.next());
+    }
+    List::destroy(e->list);
+    delete e;
+  }
+} // LispParser::Expression::destroy
+
 /**
  * Return a LISP string corresponding to this expression
  * @since 26/08/2009 Redmond
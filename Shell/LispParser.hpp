@@ -89,13 +89,16 @@ public:
     bool get1Arg(vstring functionName, Expression*& arg);
     bool getPair(Expression*& el1, Expression*& el2);
     bool getSingleton(Expression*& el);
+
+    void destroy();
   };
 
   typedef Lib::List<Expression*> List;
 
   explicit LispParser(LispLexer& lexer);
   Expression* parse();
-  void parse(List**);
+  void parse(List**, bool single=false);
+  Expression* parseNext();
 
   /**
    * Class Exception. Implements parser exceptions.
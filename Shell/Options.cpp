@@ -113,6 +113,8 @@ void Options::Options::init()
                                         "clausify",
                                         "consequence_elimination",
                                         "grounding",
+                                        "ltb_build",
+                                        "ltb_solve",
                                         "model_check",
                                         "output",
                                         "portfolio",
@@ -135,6 +137,7 @@ void Options::Options::init()
     "  -tpreprocess,tclausify: output modes for theory input"
     "  -output,profile: output information about the problem\n"
     "  -sat_solver: accepts problems in DIMACS and uses the internal sat solver\n   directly\n"
+    "  -ltb_build,ltb_solve: build the storage of the theory files included by the\n   input, and solve the input with axioms selected from it (vltb executable only)\n"
     "Some modes are not currently maintained:\n"
     "  -bpa: perform bound propagation\n"
     "  -consequence_elimination: perform consequence elimination\n"
@@ -203,6 +206,13 @@ void Options::Options::init()
     _ltbDirectory.description = "Directory for output from LTB mode. Default is to put output next to problem.";
     _lookup.insert(&_ltbDirectory);
 
+    _ltbResidentBase = BoolOptionValue("ltb_resident_base","",false);
+    _ltbResidentBase.description = "In LTB mode, normalise the axioms included by the batch file and build their SInE selection structure once per batch, "
+                                   "so that the process solving a problem only needs to process the problem's own formulas. "
+                                   "Strategies using SInE with the batch's generality threshold then select the batch axioms through this structure.";
+    _lookup.insert(&_ltbResidentBase);
+    _ltbResidentBase.setExperimental();
+
     _decode = DecodeOptionValue("decode","",this);
     _decode.description="Decodes an encoded strategy. Can be used to replay a strategy. To make Vampire output an encoded version of the strategy use the encode option.";
     _lookup.insert(&_decode);
@@ -300,6 +310,24 @@ void Options::Options::init()
         "(such as with AVATAR proofs or with global subsumption).";
     _lookup.insert(&_minimizeSatProofs);
 
+    _streamSatProofs = BoolOptionValue("stream_sat_proofs","",false);
+    _streamSatProofs.description="Do not keep the clauses added to (minisat based) proof producing SAT solvers in memory, "
+        "but log them to a memory mapped temporary file and reconstruct just an unsat core from the log after a refutation. "
+        "This does not apply to the solver of global subsumption, which is refuted after each successful check, "
+        "nor to the solver of finite model building, which does not record proofs.";
+    _lookup.insert(&_streamSatProofs);
+    _streamSatProofs.setExperimental();
+
+    _releasePremises = BoolOptionValue("release_premises","",false);
+    _releasePremises.description="Do not let the inferences of derived clauses keep their premises in memory, "
+        "so that deleted clauses can be freed. Only possible when no proof is output.";
+    _lookup.insert(&_releasePremises);
+    _releasePremises.setExperimental();
+    _releasePremises.reliesOn(_proof.is(equal(Proof::OFF)));
+    _releasePremises.reliesOn(_questionAnswering.is(equal(QuestionAnsweringMode::OFF)));
+    _releasePremises.reliesOn(_showInterpolant.is(equal(InterpolantMode::OFF)));
+    _releasePremises.reliesOn(_showSymbolElimination.is(equal(false)));
+
     _proofExtra = ChoiceOptionValue<ProofExtra>("proof_extra","",ProofExtra::OFF,{"off","free","full"});
     _proofExtra.description="Add extra detail to proofs. "
       "When 'free' this uses known information only. " 
@@ -614,6 +642,16 @@ void Options::Options::init()
     _lookup.insert(&_printClausifierPremises);
     _printClausifierPremises.tag(OptionTag::OUTPUT);
 
+    _streamingClausify = BoolOptionValue("streaming_clausify","",false);
+    _streamingClausify.description="In the clausify modes, clausify and print the TPTP input one annotated formula at a time instead of "
+      "reading and preprocessing the whole problem first. Only the per-formula preprocessing steps are performed: "
+      "SInE selection, theory axioms, FOOL elimination (use newcnf instead), and the steps that need the whole problem "
+      "(such as unused definition removal or equality proxy) are skipped.";
+    _lookup.insert(&_streamingClausify);
+    _streamingClausify.reliesOn(_mode.is(equal(Mode::CLAUSIFY)->Or(_mode.is(equal(Mode::TCLAUSIFY)))));
+    _streamingClausify.reliesOn(_inputSyntax.is(equal(InputSyntax::TPTP)));
+    _streamingClausify.tag(OptionTag::OUTPUT);
+
     _showAll = BoolOptionValue("show_everything","",false);
     _showAll.description="Turn (almost) all of the showX commands on";
     _lookup.insert(&_showAll);
@@ -1287,6 +1325,18 @@ void Options::Options::init()
     _instGenBigRestartRatio.reliesOn(_saturationAlgorithm.is(equal(SaturationAlgorithm::INST_GEN)));
     _instGenBigRestartRatio.setRandomChoices({"0.0","0.1","0.2","0.3","0.4","0.5","0.6","0.7","0.8","0.9","1.0"});
 
+    _instGenIncremental = BoolOptionValue("inst_gen_incremental","igi",false);
+    _instGenIncremental.description=
+    "Keep all generated instances and the SAT solver state for the whole run instead of restarting. "
+    "Instances of a clause that are instances of an already generated one are blocked by dismatching constraints "
+    "and, when the passive set runs out, only the active clauses whose selection no longer agrees with the model are reconsidered. "
+    "The restart options are ignored in this mode.";
+    _lookup.insert(&_instGenIncremental);
+    _instGenIncremental.tag(OptionTag::INST_GEN);
+    _instGenIncremental.reliesOn(_saturationAlgorithm.is(equal(SaturationAlgorithm::INST_GEN)));
+    _instGenIncremental.setExperimental();
+    _instGenIncremental.setRandomChoices({"on","off"});
+
     _instGenPassiveReactivation = BoolOptionValue("inst_gen_passive_reactivation","igpr",false);
     _instGenPassiveReactivation.description="When the model describing the selection function changes some active clauses may become lazily deselected. If passive reaction is selected these clauses are added into the passive set before recomputing the next model, otherwise they are added back to active.";
     _lookup.insert(&_instGenPassiveReactivation);
@@ -1410,6 +1460,21 @@ void Options::Options::init()
     _ccUnsatCores.setRandomChoices({"first", "small_ones", "all"});
     _ccUnsatCores.setExperimental();
 
+    _splittingLinearArithmetic = BoolOptionValue("avatar_linear_arithmetic","ala",false);
+    _splittingLinearArithmetic.description="Use a simplex-based decision procedure for ground linear arithmetic on top of the AVATAR SAT solver"
+                                           " (together with congruence closure, if that is on). This ensures that the ground arithmetic components in AVATAR models are consistent."
+                                           " The procedure only asserts ground inequalities and positive equalities over numbers; any other literal"
+                                           " (a disequality, a non-ground or a non-arithmetic one) is skipped and makes it incomplete, as does any"
+                                           " integer constraint, so it rarely reports SATISFIABLE and mostly only detects conflicts. Its update and check"
+                                           " steps scan all the rows of the tableau densely, so it is meant for small numbers of components.";
+    _lookup.insert(&_splittingLinearArithmetic);
+    _splittingLinearArithmetic.tag(OptionTag::AVATAR);
+    _splittingLinearArithmetic.reliesOn(_splitting.is(equal(true)));
+#if VZ3
+    _splittingLinearArithmetic.reliesOn(_satSolver.is(notEqual(SatSolver::Z3)));
+#endif
+    _splittingLinearArithmetic.setRandomChoices({"on","off"});
+
     _splittingLiteralPolarityAdvice = ChoiceOptionValue<SplittingLiteralPolarityAdvice>(
                                                 "avatar_literal_polarity_advice","alpa",
                                                 SplittingLiteralPolarityAdvice::NONE,
@@ -1489,6 +1554,16 @@ void Options::Options::init()
     _splittingFlushQuotient.reliesOn(_splitting.is(equal(true)));
     _splittingFlushQuotient.setRandomChoices({"1.0","1.1","1.2","1.4","2.0"});
 
+    _splittingSplitBatch = UnsignedOptionValue("avatar_split_batch","asb",0);
+    _splittingSplitBatch.description=
+    "collect up to this many splittable clauses before naming their components and passing the split clauses to the SAT solver in one go."
+    " The batch is always processed before the model is recomputed. If equal to zero, each clause is split immediately.";
+    _lookup.insert(&_splittingSplitBatch);
+    _splittingSplitBatch.tag(OptionTag::AVATAR);
+    _splittingSplitBatch.setExperimental();
+    _splittingSplitBatch.reliesOn(_splitting.is(equal(true)));
+    _splittingSplitBatch.setRandomChoices({"0","16","64","256"});
+
     _splittingNonsplittableComponents = ChoiceOptionValue<SplittingNonsplittableComponents>("avatar_nonsplittable_components","anc",
                                                                                               SplittingNonsplittableComponents::KNOWN,
                                                                                               {"all","all_dependent","known","none"});
@@ -413,6 +413,10 @@ public:
     CLAUSIFY,
     CONSEQUENCE_ELIMINATION,
     GROUNDING,
+    /** build the storage of a large theory (only supported by the vltb executable) */
+    LTB_BUILD,
+    /** solve a problem with axioms selected from the storage (only supported by the vltb executable) */
+    LTB_SOLVE,
     MODEL_CHECK,
     /** this mode only outputs the input problem, without any preprocessing */
     OUTPUT,
@@ -1836,6 +1840,8 @@ public:
   void setStatistics(Statistics newVal) { _statistics.actualValue=newVal; }
   Proof proof() const { return _proof.actualValue; }
   bool minimizeSatProofs() const { return _minimizeSatProofs.actualValue; }
+  bool streamSatProofs() const { return _streamSatProofs.actualValue; }
+  bool releasePremises() const { return _releasePremises.actualValue; }
   ProofExtra proofExtra() const { return _proofExtra.actualValue; }
   bool proofChecking() const { return _proofChecking.actualValue; }
   int naming() const { return _naming.actualValue; }
@@ -1854,6 +1860,7 @@ public:
   bool flattenTopLevelConjunctions() const { return _flattenTopLevelConjunctions.actualValue; }
   LTBLearning ltbLearning() const { return _ltbLearning.actualValue; }
   vstring ltbDirectory() const { return _ltbDirectory.actualValue; }
+  bool ltbResidentBase() const { return _ltbResidentBase.actualValue; }
   Mode mode() const { return _mode.actualValue; }
   Schedule schedule() const { return _schedule.actualValue; }
   vstring scheduleName() const { return _schedule.getStringOfValue(_schedule.actualValue); }
@@ -1877,6 +1884,7 @@ public:
   int rowVariableMaxLength() const { return _rowVariableMaxLength.actualValue; }
   //void setRowVariableMaxLength(int newVal) { _rowVariableMaxLength = newVal; }
   bool printClausifierPremises() const { return _printClausifierPremises.actualValue; }
+  bool streamingClausify() const { return _streamingClausify.actualValue; }
 
   // IMPORTANT, if you add a showX command then include showAll
   bool showAll() const { return _showAll.actualValue; }
@@ -2055,6 +2063,7 @@ public:
   bool inductionUnitOnly() const { return _inductionUnitOnly.actualValue; }
 
   float instGenBigRestartRatio() const { return _instGenBigRestartRatio.actualValue; }
+  bool instGenIncremental() const { return _instGenIncremental.actualValue; }
   bool instGenPassiveReactivation() const { return _instGenPassiveReactivation.actualValue; }
   int instGenResolutionRatioInstGen() const { return _instGenResolutionInstGenRatio.actualValue; }
   int instGenResolutionRatioResolution() const { return _instGenResolutionInstGenRatio.otherValue; }
@@ -2100,9 +2109,11 @@ public:
   bool splittingBufferedSolver() const { return _splittingBufferedSolver.actualValue; }
   int splittingFlushPeriod() const { return _splittingFlushPeriod.actualValue; }
   float splittingFlushQuotient() const { return _splittingFlushQuotient.actualValue; }
+  unsigned splittingSplitBatch() const { return _splittingSplitBatch.actualValue; }
   bool splittingEagerRemoval() const { return _splittingEagerRemoval.actualValue; }
   SplittingCongruenceClosure splittingCongruenceClosure() const { return _splittingCongruenceClosure.actualValue; }
   CCUnsatCores ccUnsatCores() const { return _ccUnsatCores.actualValue; }
+  bool splittingLinearArithmetic() const { return _splittingLinearArithmetic.actualValue; }
 
   void setProof(Proof p) { _proof.actualValue = p; }
   bool bpEquivalentVariableRemoval() const { return _equivalentVariableRemoval.actualValue; }
@@ -2329,6 +2340,7 @@ private:
   ChoiceOptionValue<InputSyntax> _inputSyntax;
   ChoiceOptionValue<Instantiation> _instantiation;
   FloatOptionValue _instGenBigRestartRatio;
+  BoolOptionValue _instGenIncremental;
   BoolOptionValue _instGenPassiveReactivation;
   RatioOptionValue _instGenResolutionInstGenRatio;
   //IntOptionValue _instGenResolutionRatioResolution;
@@ -2356,6 +2368,7 @@ private:
   BoolOptionValue _lrsWeightLimitOnly;
   ChoiceOptionValue<LTBLearning> _ltbLearning;
   StringOptionValue _ltbDirectory;
+  BoolOptionValue _ltbResidentBase;
 
   LongOptionValue _maxActive;
   IntOptionValue _maxAnswers;
@@ -2377,9 +2390,12 @@ private:
   BoolOptionValue _outputAxiomNames;
 
   BoolOptionValue _printClausifierPremises;
+  BoolOptionValue _streamingClausify;
   StringOptionValue _problemName;
   ChoiceOptionValue<Proof> _proof;
   BoolOptionValue _minimizeSatProofs;
+  BoolOptionValue _streamSatProofs;
+  BoolOptionValue _releasePremises;
   ChoiceOptionValue<ProofExtra> _proofExtra;
   BoolOptionValue _proofChecking;
   
@@ -2458,9 +2474,11 @@ private:
   ChoiceOptionValue<SplittingAddComplementary> _splittingAddComplementary;
   ChoiceOptionValue<SplittingCongruenceClosure> _splittingCongruenceClosure;
   ChoiceOptionValue<CCUnsatCores> _ccUnsatCores;
+  BoolOptionValue _splittingLinearArithmetic;
   BoolOptionValue _splittingEagerRemoval;
   UnsignedOptionValue _splittingFlushPeriod;
   FloatOptionValue _splittingFlushQuotient;
+  UnsignedOptionValue _splittingSplitBatch;
   ChoiceOptionValue<SplittingNonsplittableComponents> _splittingNonsplittableComponents;
   ChoiceOptionValue<SplittingMinimizeModel> _splittingMinimizeModel;
   ChoiceOptionValue<SplittingLiteralPolarityAdvice> _splittingLiteralPolarityAdvice;
@@ -23,6 +23,8 @@
 
 #include <cmath>
 
+#include "Debug/RuntimeStatistics.hpp"
+
 #include "Lib/Deque.hpp"
 #include "Lib/DHSet.hpp"
 #include "Lib/DHMultiset.hpp"
@@ -30,6 +32,7 @@
 #include "Lib/List.hpp"
 #include "Lib/Metaiterators.hpp"
 #include "Lib/Set.hpp"
+#include "Lib/Sort.hpp"
 #include "Lib/TimeCounter.hpp"
 #include "Lib/VirtualIterator.hpp"
 
@@ -266,6 +269,147 @@ void SineBase::initGeneralityFunction(UnitList* units)
   }
 }
 
+//////////////////////////////////////
+// SineIndex
+//////////////////////////////////////
+
+SineIndex* SineIndex::s_shared = 0;
+
+/**
+ * Orders triggers of a symbol by the decreasing least generality of their
+ * units, so that the units triggered under any tolerance come first
+ */
+struct SineIndex::TriggerComparator
+{
+  static Comparison compare(const Trigger& t1, const Trigger& t2)
+  {
+    if (t1.leastGen!=t2.leastGen) {
+      return t1.leastGen>t2.leastGen ? LESS : GREATER;
+    }
+    return t1.unitNum>t2.unitNum ? LESS : (t1.unitNum==t2.unitNum ? EQUAL : GREATER);
+  }
+};
+
+SineIndex::SineIndex(UnitList* units)
+{
+  CALL("SineIndex::SineIndex");
+
+  TimeCounter tc(TC_SINE_SELECTION);
+
+  initGeneralityFunction(units);
+
+  SymId symIdBound=_symExtr.getSymIdBound();
+  unsigned unitCnt=UnitList::length(units);
+
+  _units.ensure(unitCnt);
+  _leastGen.ensure(unitCnt);
+  _symStart.init(symIdBound+1,0);
+
+  //compute the least generality of each unit and count the triggers of each symbol
+  unsigned unitNum=0;
+  unsigned triggerCnt=0;
+  UnitList::Iterator uit(units);
+  while (uit.hasNext()) {
+    Unit* u=uit.next();
+    _units[unitNum]=u;
+
+    unsigned leastGenVal=0;
+    SymIdIterator sit=_symExtr.extractSymIds(u);
+    while (sit.hasNext()) {
+      SymId sym=sit.next();
+      unsigned val=_gen[sym];
+      ASS_G(val,0);
+      if (!leastGenVal || val<leastGenVal) {
+        leastGenVal=val;
+      }
+      _symStart[sym+1]++;
+      triggerCnt++;
+    }
+    _leastGen[unitNum]=leastGenVal;
+    unitNum++;
+  }
+  for (SymId sym=0;sym<symIdBound;sym++) {
+    _symStart[sym+1]+=_symStart[sym];
+  }
+
+  DArray<unsigned> fill;
+  fill.initFromArray(symIdBound,_symStart);
+  _triggers.ensure(triggerCnt);
+  for (unitNum=0;unitNum<unitCnt;unitNum++) {
+    SymIdIterator sit=_symExtr.extractSymIds(_units[unitNum]);
+    while (sit.hasNext()) {
+      Trigger& t=_triggers[fill[sit.next()]++];
+      t.leastGen=_leastGen[unitNum];
+      t.unitNum=unitNum;
+    }
+  }
+  for (SymId sym=0;sym<symIdBound;sym++) {
+    sort<TriggerComparator>(_triggers.array()+_symStart[sym],_triggers.array()+_symStart[sym+1]);
+  }
+}
+
+/**
+ * Return true if @b units are exactly the indexed units in the same order
+ */
+bool SineIndex::covers(UnitList* units) const
+{
+  CALL("SineIndex::covers");
+
+  unsigned unitNum=0;
+  UnitList::Iterator uit(units);
+  while (uit.hasNext()) {
+    if (unitNum==_units.size() || uit.next()!=_units[unitNum]) {
+      return false;
+    }
+    unitNum++;
+  }
+  return unitNum==_units.size();
+}
+
+/**
+ * Push into @b res the units that the symbol @b sym triggers with the
+ * given tolerance and generality threshold
+ *
+ * The units are pushed in the reverse of their original order, which is
+ * the order in which the D-relation of @b SineSelector yields them.
+ */
+void SineIndex::getDefiningUnits(SymId sym, float tolerance, unsigned genThreshold, Stack<Unit*>& res) const
+{
+  CALL("SineIndex::getDefiningUnits");
+
+  unsigned val=_gen[sym];
+  bool all=val<=genThreshold || tolerance==-1.0f;
+
+  static Stack<unsigned> unitNums;
+  unitNums.reset();
+  for (unsigned i=_symStart[sym];i<_symStart[sym+1];i++) {
+    const Trigger& t=_triggers[i];
+    if (!all && val>static_cast<unsigned>(static_cast<int>(t.leastGen*tolerance))) {
+      //all the remaining units have smaller least generality
+      break;
+    }
+    unitNums.push(t.unitNum);
+  }
+  sort<DefaultComparator>(unitNums.begin(),unitNums.end());
+  while (unitNums.isNonEmpty()) {
+    res.push(_units[unitNums.pop()]);
+  }
+}
+
+/**
+ * Make @b index the index shared by the SInE selections in this process
+ * (and in the processes forked from it)
+ */
+void SineIndex::setShared(SineIndex* index)
+{
+  CALL("SineIndex::setShared");
+
+  if (s_shared) {
+    delete s_shared;
+  }
+  s_shared=index;
+}
+
 SineSelector::SineSelector(const Options& opt)
 : _onIncluded(opt.sineSelection()==Options::SineSelection::INCLUDED),
   _genThreshold(opt.sineGeneralityThreshold()),
@@ -312,14 +456,7 @@ void SineSelector::updateDefRelation(Unit* u)
   SymIdIterator sit=_symExtr.extractSymIds(u);
 
   if (!sit.hasNext()) {
-    if(env.clausePriorities){
-      env.clausePriorities->insert(u,1);
-    }
-    if(env.clauseSineLevels){
-      env.clauseSineLevels->insert(u,1);
-      // cout << "set level for a non-symboler " << u->toString() << " as " << "(1)" << endl;
-    }
-    _unitsWithoutSymbols.push(u);
+    addUnitWithoutSymbols(u);
     return;
   }
 
@@ -385,6 +522,23 @@ void SineSelector::updateDefRelation(Unit* u)
 
 }
 
+/**
+ * Register unit @b u that contains no symbols, so that it will always be selected
+ */
+void SineSelector::addUnitWithoutSymbols(Unit* u)
+{
+  CALL("SineSelector::addUnitWithoutSymbols");
+
+  if(env.clausePriorities){
+    env.clausePriorities->insert(u,1);
+  }
+  if(env.clauseSineLevels){
+    env.clauseSineLevels->insert(u,1);
+    // cout << "set level for a non-symboler " << u->toString() << " as " << "(1)" << endl;
+  }
+  _unitsWithoutSymbols.push(u);
+}
+
 void SineSelector::perform(Problem& prb)
 {
   CALL("SineSelector::perform");
@@ -401,16 +555,27 @@ bool SineSelector::perform(UnitList*& units)
 
   TimeCounter tc(TC_SINE_SELECTION);
 
-  initGeneralityFunction(units);
-
-  SymId symIdBound=_symExtr.getSymIdBound();
+  //the shared index already contains the generality and the D-relation
+  //for any tolerance, if it was built from the same units
+  SineIndex* index=SineIndex::shared();
+  if (index && !index->covers(units)) {
+    index=0;
+  }
+  if (index) {
+    RSTAT_CTR_INC("sine selections using shared index");
+  }
+  else {
+    initGeneralityFunction(units);
+    _def.init(_symExtr.getSymIdBound(),0);
+  }
 
   Set<Unit*> selected;
   Stack<Unit*> selectedStack; //on this stack there are Units in the order they were selected
   Deque<Unit*> newlySelected;
+  DHSet<SymId> usedSymIds; //symbols whose defining units were already selected (with the index)
+  Stack<Unit*> defUnits;
 
   //build the D-relation and select the non-axiom formulas
-  _def.init(symIdBound,0);
   unsigned numberUnitsLeftOut = 0;
   UnitList::Iterator uit2(units);
   while (uit2.hasNext()) {
@@ -419,7 +584,12 @@ bool SineSelector::perform(UnitList*& units)
     bool performSelection= _onIncluded ? u->included() : ((u->inputType()==Unit::AXIOM)
                             || (env.options->guessTheGoal() != Options::GoalGuess::OFF && u->inputType()==Unit::ASSUMPTION));
     if (performSelection) { // register the unit for later
-      updateDefRelation(u);
+      if (!index) {
+        updateDefRelation(u);
+      }
+      else if (!index->hasSymbols(numberUnitsLeftOut-1)) {
+        addUnitWithoutSymbols(u);
+      }
     }
     else { // goal units are immediately taken
       selected.insert(u);
@@ -478,9 +648,23 @@ bool SineSelector::perform(UnitList*& units)
         }
       }
 
-      UnitList::Iterator defUnits(_def[sym]);
-      while (defUnits.hasNext()) {
-        Unit* du=defUnits.next();
+      defUnits.reset();
+      if (index) {
+        if (usedSymIds.insert(sym)) {
+          index->getDefiningUnits(sym,_tolerance,_genThreshold,defUnits);
+        }
+      }
+      else {
+        defUnits.loadFromIterator(UnitList::Iterator(_def[sym]));
+        //all defining units for the symbol sym will be selected,
+        //so we can remove them from the relation
+        UnitList::destroy(_def[sym]);
+        _def[sym]=0;
+      }
+
+      Stack<Unit*>::BottomFirstIterator duit(defUnits);
+      while (duit.hasNext()) {
+        Unit* du=duit.next();
         if (selected.contains(du)) {
           continue;
         }
@@ -498,10 +682,6 @@ bool SineSelector::perform(UnitList*& units)
           // cout << "set level for " << du->toString() << " in iteration as " << env.maxClausePriority+1 << endl;
         }
       }
-      //all defining units for the symbol sym were selected,
-      //so we can remove them from the relation
-      UnitList::destroy(_def[sym]);
-      _def[sym]=0;
     }
   }
 
@@ -572,6 +752,30 @@ SineTheorySelector::SineTheorySelector(const Options& opt)
   CALL("SineTheorySelector::SineTheorySelector");
 }
 
+/**
+ * Return true if the SInE selection requested by @b opt can be performed
+ * by this class
+ *
+ * This is not the case when SInE is off, when it only assigns priorities,
+ * when the tolerance is not finite or exceeds the limit implied by the
+ * value of @b maxTolerance, and when the generality threshold differs
+ * from the one the D-relation was built with.
+ */
+bool SineTheorySelector::supports(const Options& opt) const
+{
+  CALL("SineTheorySelector::supports");
+
+  if (opt.sineSelection()!=Options::SineSelection::AXIOMS &&
+      opt.sineSelection()!=Options::SineSelection::INCLUDED) {
+    return false;
+  }
+  if (opt.sineGeneralityThreshold()!=_genThreshold) {
+    return false;
+  }
+  float tolerance=opt.sineTolerance();
+  return tolerance>=1.0f && tolerance*strictTolerance<=maxTolerance;
+}
+
 void SineTheorySelector::handlePossibleSignatureChange()
 {
   CALL("SineTheorySelector::handlePossibleSignatureChange");
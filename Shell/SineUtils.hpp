@@ -67,6 +67,55 @@ protected:
   SineSymbolExtractor _symExtr;
 };
 
+/**
+ * Symbol generality and the defining relation of a set of units for all
+ * tolerance and generality threshold values at once
+ *
+ * For each symbol, the units it may trigger are kept sorted by their
+ * least symbol generality, so the units the symbol triggers under a
+ * particular tolerance form a prefix of the list. Selections with
+ * different SInE settings over the same units (such as by the slices of
+ * a portfolio) can then share one index and only pay for what they select.
+ */
+class SineIndex
+  : public SineBase
+{
+public:
+  CLASS_NAME(SineIndex);
+  USE_ALLOCATOR(SineIndex);
+
+  SineIndex(UnitList* units);
+
+  bool covers(UnitList* units) const;
+
+  /** True if the @b unitNum -th unit of the index contains some symbol */
+  bool hasSymbols(unsigned unitNum) const { return _leastGen[unitNum]!=0; }
+
+  void getDefiningUnits(SymId sym, float tolerance, unsigned genThreshold, Stack<Unit*>& res) const;
+
+  /** Return the index shared by the selections in this process, or zero */
+  static SineIndex* shared() { return s_shared; }
+  static void setShared(SineIndex* index);
+private:
+  struct Trigger
+  {
+    unsigned leastGen;
+    unsigned unitNum;
+  };
+  struct TriggerComparator;
+  struct UnitNumComparator;
+
+  static SineIndex* s_shared;
+
+  /** the indexed units in their original order */
+  DArray<Unit*> _units;
+  /** generality of the least general symbol of each unit, zero for units without symbols */
+  DArray<unsigned> _leastGen;
+  /** triggers of symbol @b s are at positions from _symStart[s] up to _symStart[s+1] */
+  DArray<unsigned> _symStart;
+  DArray<Trigger> _triggers;
+};
+
 /**
  * Class that performs the SInE axiom selection on a single problem
  */
@@ -91,6 +140,7 @@ private:
   void init();
 
   void updateDefRelation(Unit* u);
+  void addUnitWithoutSymbols(Unit* u);
 
   bool _onIncluded;
   bool _strict;
@@ -127,6 +177,8 @@ public:
 
   void initSelectionStructure(UnitList* units);
   void perform(UnitList*& units);
+
+  bool supports(const Options& opt) const;
 private:
 
   /** The integer tolerance value is the float option value multiplied by 10 and
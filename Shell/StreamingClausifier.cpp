@@ -0,0 +1,468 @@
+
+/*
+ * File StreamingClausifier.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file StreamingClausifier.cpp
+ * Implements class StreamingClausifier.
+ */
+
+#include <fstream>
+
+#include "Lib/Environment.hpp"
+#include "Lib/List.hpp"
+#include "Lib/Sort.hpp"
+#include "Lib/TimeCounter.hpp"
+
+#include "Kernel/Clause.hpp"
+#include "Kernel/FormulaUnit.hpp"
+#include "Kernel/Inference.hpp"
+#include "Kernel/Signature.hpp"
+#include "Kernel/Sorts.hpp"
+
+#include "Inferences/TautologyDeletionISE.hpp"
+
+#include "Flattening.hpp"
+#include "FOOLElimination.hpp"
+#include "NNF.hpp"
+#include "Options.hpp"
+#include "Rectify.hpp"
+#include "SimplifyFalseTrue.hpp"
+#include "Skolem.hpp"
+#include "Statistics.hpp"
+#include "TPTPPrinter.hpp"
+#include "UIHelper.hpp"
+
+#include "StreamingClausifier.hpp"
+
+namespace Shell
+{
+
+using namespace Inferences;
+
+StreamingClausifier::StreamingClausifier(const Options& opts, bool theory)
+: _opts(opts), _theory(theory),
+  // For now just force eprPreservingNaming to be false, as in Preprocess::naming
+  _naming(opts.naming(), false),
+  _newCnf(opts.naming()),
+  _keepFormulas(false),
+  _nextSort(0), _nextFunction(0), _nextPredicate(0),
+  _printedConjecture(false)
+{
+  CALL("StreamingClausifier::StreamingClausifier");
+
+  _simplifier.addFront(new TrivialInequalitiesRemovalISE());
+  _simplifier.addFront(new TautologyDeletionISE());
+  _simplifier.addFront(new DuplicateLiteralRemovalISE());
+}
+
+/**
+ * Read the input problem and output its clauses.
+ */
+void StreamingClausifier::perform()
+{
+  CALL("StreamingClausifier::perform");
+
+  TimeCounter tc(TC_PARSING);
+  env.statistics->phase = Statistics::PARSING;
+
+  vstring inputFile = _opts.inputFile();
+
+  istream* input;
+  if (inputFile=="") {
+    input=&cin;
+  } else {
+    // CAREFUL: this might not be enough if the ifstream (re)allocates while being operated
+    BYPASSING_ALLOCATOR;
+
+    input=new ifstream(inputFile.c_str());
+    if (input->fail()) {
+      USER_ERROR("Cannot open problem file: "+inputFile);
+    }
+  }
+
+  env.beginOutput();
+  {
+    Parse::TPTP parser(*input,inputFile);
+    parser.setUnitHandler(this);
+    try{
+      parser.parse();
+    }
+    catch (UserErrorException& exception) {
+      vstring msg = exception.msg();
+      throw Parse::TPTP::ParseErrorException(msg,parser.lineNumber());
+    }
+    UIHelper::setConjecturePresence(parser.containsConjecture());
+  }
+
+  if (!_printedConjecture && UIHelper::haveConjecture()) {
+    // see clausifyMode() in vampire.cpp
+    unsigned p = env.signature->addFreshPredicate(0,"p");
+    Clause* c = new(2) Clause(2,Unit::NEGATED_CONJECTURE,new Inference(Inference::INPUT));
+    (*c)[0] = Literal::create(p,0,true,false,0);
+    (*c)[1] = Literal::create(p,0,false,false,0);
+    env.out() << TPTPPrinter::toString(c) << "\n";
+  }
+  env.endOutput();
+
+  if (inputFile!="") {
+    BYPASSING_ALLOCATOR;
+
+    delete static_cast<ifstream*>(input);
+  }
+} // StreamingClausifier::perform
+
+/**
+ * Clausify and output a unit that has just been parsed, then release it.
+ */
+void StreamingClausifier::handleUnit(Unit* unit)
+{
+  CALL("StreamingClausifier::handleUnit");
+
+  if (_introduced.size()) {
+    checkSymbols(unit);
+  }
+
+  if (unit->isClause()) {
+    _clauses.push(static_cast<Clause*>(unit));
+  }
+  else {
+    clausify(static_cast<FormulaUnit*>(unit));
+  }
+
+  outputDeclarations();
+  Stack<Clause*>::Iterator cit(_clauses);
+  while (cit.hasNext()) {
+    output(cit.next());
+  }
+
+  release();
+} // StreamingClausifier::handleUnit
+
+/**
+ * Perform the per unit steps of Preprocess::preprocess on @b unit and
+ * collect the resulting clauses in @b _clauses.
+ */
+void StreamingClausifier::clausify(FormulaUnit* unit)
+{
+  CALL("StreamingClausifier::clausify");
+
+  if (FOOLElimination::needsElimination(unit)) {
+    if (!_opts.newCNF()) {
+      USER_ERROR("Streaming clausification of formulas with $ite, $let or boolean terms requires --newcnf on");
+    }
+    _keepFormulas = true;
+  }
+
+  addStep(unit);
+  env.statistics->phase = Statistics::PREPROCESS_1;
+  FormulaUnit* fu = Rectify::rectify(unit);
+  addStep(fu);
+  if (!_opts.newCNF()) {
+    // NewCNF effectively implements this simplification already
+    fu = SimplifyFalseTrue::simplify(fu);
+    addStep(fu);
+  }
+  fu = Flattening::flatten(fu);
+  addStep(fu);
+
+  env.statistics->phase = Statistics::PREPROCESS_2;
+  fu = NNF::ennf(fu);
+  addStep(fu);
+  fu = Flattening::flatten(fu);
+  addStep(fu);
+
+  if (_opts.newCNF()) {
+    env.statistics->phase = Statistics::NEW_CNF;
+    _newCnf.clausify(fu,_clauses);
+    return;
+  }
+
+  UnitList* defs = UnitList::empty();
+  if (_opts.naming()) {
+    env.statistics->phase = Statistics::NAMING;
+    fu = _naming.apply(fu,defs);
+    addStep(fu);
+  }
+  UnitList::push(fu,defs);
+
+  UnitList::Iterator uit(defs);
+  while (uit.hasNext()) {
+    FormulaUnit* v = static_cast<FormulaUnit*>(uit.next());
+    addStep(v);
+    env.statistics->phase = Statistics::PREPROCESS_3;
+    v = NNF::nnf(v);
+    addStep(v);
+    v = Flattening::flatten(v);
+    addStep(v);
+    v = Skolem::skolemise(v);
+    addStep(v);
+    env.statistics->phase = Statistics::CLAUSIFICATION;
+    _cnf.clausify(v,_clauses);
+  }
+  UnitList::destroy(defs);
+} // StreamingClausifier::clausify
+
+/**
+ * Remember @b unit to be released together with the current unit.
+ */
+void StreamingClausifier::addStep(FormulaUnit* unit)
+{
+  CALL("StreamingClausifier::addStep");
+
+  if (_steps.isEmpty() || _steps.top()!=unit) {
+    _steps.push(unit);
+  }
+}
+
+/**
+ * Raise a user error if @b unit uses a symbol introduced by clausification
+ * of the previous units.
+ */
+void StreamingClausifier::checkSymbols(Unit* unit)
+{
+  CALL("StreamingClausifier::checkSymbols");
+
+  SineSymbolExtractor::SymIdIterator sit = _symExtr.extractSymIds(unit);
+  while (sit.hasNext()) {
+    unsigned id = sit.next();
+    if (!_introduced.find(id)) {
+      continue;
+    }
+    bool pred;
+    unsigned functor;
+    SineSymbolExtractor::decodeSymId(id, pred, functor);
+    vstring name = pred ? env.signature->predicateName(functor) : env.signature->functionName(functor);
+    USER_ERROR("Symbol "+name+" was introduced by the streaming clausification before being used in the input");
+  }
+} // StreamingClausifier::checkSymbols
+
+/**
+ * Output the declarations of the sorts and symbols added to the signature
+ * since the last call and remember which of them were introduced by clausification.
+ */
+void StreamingClausifier::outputDeclarations()
+{
+  CALL("StreamingClausifier::outputDeclarations");
+
+  Signature& sig = *env.signature;
+  unsigned sorts = env.sorts->count();
+  unsigned funcs = sig.functions();
+  unsigned preds = sig.predicates();
+  if (_nextSort==sorts && _nextFunction==funcs && _nextPredicate==preds) {
+    return;
+  }
+
+  for (unsigned i=_nextFunction; i<funcs; i++) {
+    if (sig.getFunction(i)->introduced()) {
+      _introduced.insert(2*i+1);
+    }
+  }
+  for (unsigned i=_nextPredicate; i<preds; i++) {
+    if (sig.getPredicate(i)->introduced()) {
+      _introduced.insert(2*i);
+    }
+  }
+
+  UIHelper::outputSortDeclarations(env.out(), _nextSort);
+  UIHelper::outputSymbolDeclarations(env.out(), _nextFunction, _nextPredicate);
+  _nextSort = sorts;
+  _nextFunction = funcs;
+  _nextPredicate = preds;
+} // StreamingClausifier::outputDeclarations
+
+/**
+ * Simplify and output the clause @b cl, as clausifyMode() in vampire.cpp does.
+ */
+void StreamingClausifier::output(Clause* cl)
+{
+  CALL("StreamingClausifier::output");
+
+  Clause* simpl = _simplifier.simplify(cl);
+  if (!simpl) {
+    return;
+  }
+  if (simpl!=cl) {
+    _clauses.push(simpl);
+  }
+  _printedConjecture |= simpl->inputType() == Unit::CONJECTURE || simpl->inputType() == Unit::NEGATED_CONJECTURE;
+  if (!_theory) {
+    env.out() << TPTPPrinter::toString(simpl) << "\n";
+    return;
+  }
+
+  Formula* f = Formula::fromClause(simpl);
+  // CONJECTURE is evil, as it cannot occur multiple times
+  FormulaUnit* fu = new FormulaUnit(f,new Inference1(Inference::FORMULIFY,simpl),
+      simpl->inputType() == Unit::CONJECTURE ? Unit::NEGATED_CONJECTURE : simpl->inputType());
+  env.out() << TPTPPrinter::toString(fu) << "\n";
+
+  collectFormulas(f);
+  releaseFormulas();
+  fu->destroy();
+} // StreamingClausifier::output
+
+/**
+ * Add to @b _formulas the subformulas of @b f and to the other sets the
+ * list cells they consist of.
+ */
+void StreamingClausifier::collectFormulas(Formula* f)
+{
+  CALL("StreamingClausifier::collectFormulas");
+
+  static Stack<Formula*> todo;
+  todo.push(f);
+  while (todo.isNonEmpty()) {
+    f = todo.pop();
+    // the constant formulas are shared
+    if (f==Formula::trueFormula() || f==Formula::falseFormula() || !_formulas.insert(f)) {
+      continue;
+    }
+    switch (f->connective()) {
+    case AND:
+    case OR:
+      // if a cell is already known then so is the rest of the list
+      for (FormulaList* fs = f->args(); fs && _formulaCells.insert(fs); fs = fs->tail()) {
+        todo.push(fs->head());
+      }
+      break;
+    case IMP:
+    case IFF:
+    case XOR:
+      todo.push(f->left());
+      todo.push(f->right());
+      break;
+    case NOT:
+      todo.push(f->uarg());
+      break;
+    case FORALL:
+    case EXISTS:
+      for (Formula::VarList* vs = f->vars(); vs && _varCells.insert(vs); vs = vs->tail()) {}
+      for (Formula::SortList* ss = f->sorts(); ss && _sortCells.insert(ss); ss = ss->tail()) {}
+      todo.push(f->qarg());
+      break;
+    default:
+      break;
+    }
+  }
+} // StreamingClausifier::collectFormulas
+
+/**
+ * Delete the formulas and list cells collected by collectFormulas().
+ */
+void StreamingClausifier::releaseFormulas()
+{
+  CALL("StreamingClausifier::releaseFormulas");
+
+  DHSet<Formula*>::Iterator fit(_formulas);
+  while (fit.hasNext()) {
+    fit.next()->destroy();
+  }
+  DHSet<FormulaList*>::Iterator flit(_formulaCells);
+  while (flit.hasNext()) {
+    delete flit.next();
+  }
+  DHSet<Formula::VarList*>::Iterator vit(_varCells);
+  while (vit.hasNext()) {
+    delete vit.next();
+  }
+  DHSet<Formula::SortList*>::Iterator sit(_sortCells);
+  while (sit.hasNext()) {
+    delete sit.next();
+  }
+  _formulas.reset();
+  _formulaCells.reset();
+  _varCells.reset();
+  _sortCells.reset();
+} // StreamingClausifier::releaseFormulas
+
+/**
+ * Orders units so that each unit comes before its premises, which have
+ * smaller numbers since they were created earlier
+ */
+struct StreamingClausifier::NewerFirstComparator
+{
+  static Comparison compare(Unit* u1, Unit* u2)
+  {
+    return u1->number()>u2->number() ? LESS : (u1->number()==u2->number() ? EQUAL : GREATER);
+  }
+};
+
+/**
+ * Release the clauses and the formula units of the current unit.
+ *
+ * Besides the units in @b _steps, this covers the definitions that
+ * skolemisation and naming created along the way, which are only
+ * reachable as premises of the inferences.
+ */
+void StreamingClausifier::release()
+{
+  CALL("StreamingClausifier::release");
+
+  static DHSet<Unit*> units;
+  static Stack<Unit*> todo;
+  units.reset();
+  todo.reset();
+  todo.loadFromIterator(Stack<FormulaUnit*>::Iterator(_steps));
+  Stack<Clause*>::Iterator cit(_clauses);
+  while (cit.hasNext()) {
+    todo.push(cit.next());
+  }
+  while (todo.isNonEmpty()) {
+    Unit* u = todo.pop();
+    if (!u->isClause() && !units.insert(u)) {
+      continue;
+    }
+    Inference* inf = u->inference();
+    Inference::Iterator iit = inf->iterator();
+    while (inf->hasNext(iit)) {
+      Unit* premise = inf->next(iit);
+      if (!premise->isClause()) {
+        todo.push(premise);
+      }
+    }
+  }
+
+  // the clauses refer to the formula units, so they go first;
+  // simplified clauses were pushed after their premises
+  while (_clauses.isNonEmpty()) {
+    _clauses.pop()->destroy();
+  }
+
+  if (!_keepFormulas) {
+    DHSet<Unit*>::Iterator uit(units);
+    while (uit.hasNext()) {
+      collectFormulas(static_cast<FormulaUnit*>(uit.next())->formula());
+    }
+    releaseFormulas();
+  }
+
+  // destroying an inference looks at its premises
+  static Stack<Unit*> ordered;
+  ordered.reset();
+  ordered.loadFromIterator(DHSet<Unit*>::Iterator(units));
+  sort<NewerFirstComparator>(ordered.begin(),ordered.end());
+  Stack<Unit*>::BottomFirstIterator oit(ordered);
+  while (oit.hasNext()) {
+    static_cast<FormulaUnit*>(oit.next())->destroy();
+  }
+
+  _steps.reset();
+  _keepFormulas = false;
+} // StreamingClausifier::release
+
+}
@@ -0,0 +1,122 @@
+
+/*
+ * File StreamingClausifier.hpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+/**
+ * @file StreamingClausifier.hpp
+ * Defines class StreamingClausifier.
+ */
+
+#ifndef __StreamingClausifier__
+#define __StreamingClausifier__
+
+#include "Forwards.hpp"
+
+#include "Lib/Allocator.hpp"
+#include "Lib/DHSet.hpp"
+#include "Lib/Stack.hpp"
+
+#include "Kernel/Formula.hpp"
+
+#include "Inferences/InferenceEngine.hpp"
+
+#include "Parse/TPTP.hpp"
+
+#include "CNF.hpp"
+#include "Naming.hpp"
+#include "NewCNF.hpp"
+#include "SineUtils.hpp"
+
+namespace Shell {
+
+using namespace Lib;
+using namespace Kernel;
+
+/**
+ * Clausification of a TPTP problem one unit at a time (option streaming_clausify).
+ *
+ * Each unit is clausified and printed as soon as the parser reads it.
+ * Its clauses, the formula units it went through and their formulas are
+ * released right after that, so what remains of the input are the
+ * signature and the shared terms and literals.
+ *
+ * Only the preprocessing steps that work on a single unit are performed.
+ * Since the symbols introduced by clausification cannot be renamed once
+ * they have been printed, an input unit using one of them is an error.
+ */
+class StreamingClausifier
+  : public Parse::TPTP::UnitHandler
+{
+public:
+  CLASS_NAME(StreamingClausifier);
+  USE_ALLOCATOR(StreamingClausifier);
+
+  StreamingClausifier(const Options& opts, bool theory);
+
+  void perform();
+
+  void handleUnit(Unit* unit);
+
+private:
+  struct NewerFirstComparator;
+
+  void clausify(FormulaUnit* unit);
+  void addStep(FormulaUnit* unit);
+  void checkSymbols(Unit* unit);
+  void outputDeclarations();
+  void output(Clause* cl);
+  void collectFormulas(Formula* f);
+  void releaseFormulas();
+  void release();
+
+  const Options& _opts;
+  /** output formulas rather than clauses (mode tclausify) */
+  bool _theory;
+
+  Naming _naming;
+  NewCNF _newCnf;
+  CNF _cnf;
+  Inferences::CompositeISE _simplifier;
+
+  /** the clauses of the current unit */
+  Stack<Clause*> _clauses;
+  /** formula units created for the current unit, in the order of creation */
+  Stack<FormulaUnit*> _steps;
+  /** the formulas of the current unit cannot be released (they are referred to from special terms) */
+  bool _keepFormulas;
+
+  /** formulas of the units being released */
+  DHSet<Formula*> _formulas;
+  DHSet<FormulaList*> _formulaCells;
+  DHSet<Formula::VarList*> _varCells;
+  DHSet<Formula::SortList*> _sortCells;
+
+  /** symbols introduced by clausification, as ids of @b _symExtr */
+  DHSet<unsigned> _introduced;
+  SineSymbolExtractor _symExtr;
+
+  /** the first sort, function and predicate whose declaration was not output yet */
+  unsigned _nextSort;
+  unsigned _nextFunction;
+  unsigned _nextPredicate;
+
+  bool _printedConjecture;
+};
+
+}
+
+#endif // __StreamingClausifier__
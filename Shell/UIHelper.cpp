@@ -238,7 +238,7 @@ Problem* UIHelper::getInputProblem(const Options& opts)
   break;
   case Options::InputSyntax::TPTP:
     {
-      Parse::TPTP parser(*input);
+      Parse::TPTP parser(*input,inputFile);
       try{
         parser.parse();
       }
@@ -529,19 +529,20 @@ void UIHelper::outputSatisfiableResult(ostream& out)
 }
 
 /**
- * Output to @b out all symbol declarations for the current signature.
+ * Output to @b out all symbol declarations for the current signature,
+ * starting from function @b firstFunction and predicate @b firstPredicate.
  * Symbols having default types will not be output.
  * @author Andrei Voronkov
  * @since 03/07/2013 Manchester
  */
-void UIHelper::outputSymbolDeclarations(ostream& out)
+void UIHelper::outputSymbolDeclarations(ostream& out, unsigned firstFunction, unsigned firstPredicate)
 {
   CALL("UIHelper::outputSymbolDeclarations");
 
   Signature& sig = *env.signature;
 
   unsigned funcs = sig.functions();
-  for (unsigned i=0; i<funcs; ++i) {
+  for (unsigned i=firstFunction; i<funcs; ++i) {
     if (!env.options->showFOOL()) {
       if (env.signature->isFoolConstantSymbol(true,i) || env.signature->isFoolConstantSymbol(false,i)) {
         continue;
@@ -550,7 +551,7 @@ void UIHelper::outputSymbolDeclarations(ostream& out)
     outputSymbolTypeDeclarationIfNeeded(out, true, i);
   }
   unsigned preds = sig.predicates();
-  for (unsigned i=0; i<preds; ++i) {
+  for (unsigned i=firstPredicate; i<preds; ++i) {
     outputSymbolTypeDeclarationIfNeeded(out, false, i);
   }
 } // UIHelper::outputSymbolDeclarations
@@ -626,17 +627,18 @@ void UIHelper::outputSymbolTypeDeclarationIfNeeded(ostream& out, bool function,
 }
 
 /**
- * Output to @b out all sort declarations for the current signature.
+ * Output to @b out all sort declarations for the current signature,
+ * starting from sort @b firstSort.
  * Built-in sorts and structures sorts will not be output.
  * @author Evgeny Kotelnikov
  * @since 04/09/2015 Gothneburg
  */
-void UIHelper::outputSortDeclarations(ostream& out)
+void UIHelper::outputSortDeclarations(ostream& out, unsigned firstSort)
 {
   CALL("UIHelper::outputSortDeclarations");
 
   unsigned sorts = (*env.sorts).count();
-  for (unsigned sort = Sorts::SRT_BOOL; sort < sorts; ++sort) {
+  for (unsigned sort = max(firstSort, (unsigned)Sorts::SRT_BOOL); sort < sorts; ++sort) {
     if (sort < Sorts::FIRST_USER_SORT && ((sort != Sorts::SRT_BOOL) || !env.options->showFOOL())) {
       continue;
     }
@@ -63,10 +63,10 @@ public:
   static void outputSatisfiableResult(ostream& out);
   static void outputSaturatedSet(ostream& out, UnitIterator uit);
 
-  static void outputSymbolDeclarations(ostream& out);
+  static void outputSymbolDeclarations(ostream& out, unsigned firstFunction=0, unsigned firstPredicate=0);
   static void outputSymbolTypeDeclarationIfNeeded(ostream& out, bool function, unsigned symNumber);
 
-  static void outputSortDeclarations(ostream& out);
+  static void outputSortDeclarations(ostream& out, unsigned firstSort=0);
 
   /**
    * A hacky global flag distinguishing the parent and the child in portfolio modes.
@@ -27,7 +27,6 @@
 #include "Kernel/Term.hpp"
 #include "Kernel/Sorts.hpp"
 
-#include "Indexing/LiteralSubstitutionTreeWithoutTop.hpp"
 #include "Indexing/LiteralSubstitutionTree.hpp"
 #include "Indexing/LiteralIndex.hpp"
 #include "Indexing/Index.hpp"
@@ -44,7 +43,7 @@ using namespace Indexing;
 TEST_FUN(index)
 {
   cout << endl;
-  LiteralIndexingStructure * is = new LiteralSubstitutionTreeWithoutTop();
+  LiteralIndexingStructure * is = new LiteralSubstitutionTree();
   DismatchingLiteralIndex* dismatchIndex = new DismatchingLiteralIndex(is);
 
   unsigned f = env.signature->addFunction("f",2);
@@ -0,0 +1,228 @@
+/*
+ * File tInduction.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+#include "Forwards.hpp"
+#include "Lib/Environment.hpp"
+
+#include "Kernel/Clause.hpp"
+#include "Kernel/Formula.hpp"
+#include "Kernel/FormulaUnit.hpp"
+#include "Kernel/Inference.hpp"
+#include "Kernel/InferenceStore.hpp"
+#include "Kernel/MLVariant.hpp"
+#include "Kernel/RobSubstitution.hpp"
+#include "Kernel/Signature.hpp"
+#include "Kernel/Sorts.hpp"
+#include "Kernel/Term.hpp"
+#include "Kernel/Theory.hpp"
+
+#include "Indexing/Index.hpp"
+#include "Indexing/ResultSubstitution.hpp"
+
+#include "Inferences/BinaryResolution.hpp"
+#include "Inferences/Induction.hpp"
+
+#include "Shell/NewCNF.hpp"
+#include "Shell/NNF.hpp"
+#include "Shell/Options.hpp"
+
+#include "Test/UnitTesting.hpp"
+
+#define UNIT_ID induction
+UT_CREATE;
+
+using namespace Kernel;
+using namespace Indexing;
+using namespace Inferences;
+using namespace Shell;
+
+/**
+ * Return the unit clause of the literal ~@b pred(0,@b c) with a fresh
+ * integer constant @b c and a fresh predicate @b pred
+ *
+ * The constant is not the first argument, as the first argument of the
+ * literal is not considered for induction.
+ */
+Clause* inductionPremise(const char* pred, const char* c)
+{
+  unsigned f = env.signature->addFunction(c,0);
+  env.signature->getFunction(f)->setType(OperatorType::getConstantsType(Sorts::SRT_INTEGER));
+  unsigned p = env.signature->addPredicate(pred,2);
+  env.signature->getPredicate(p)->setType(OperatorType::getPredicateType({Sorts::SRT_INTEGER,Sorts::SRT_INTEGER}));
+
+  TermList zero(theory->representConstant(IntegerConstantType(0)));
+  Clause* cl = new(1) Clause(1,Unit::AXIOM,new Inference(Inference::INPUT));
+  (*cl)[0] = Literal::create2(p,false,zero,TermList(Term::createConstant(f)));
+  // the inferences are performed with active clauses
+  cl->setStore(Clause::ACTIVE);
+  return cl;
+}
+
+/**
+ * Produce the clauses of the mathematical induction on the constant of
+ * the unit clause @b premise as it was done before the templates: the
+ * schemas are built for the inducted literal, clausified by NewCNF and
+ * resolved with the premise
+ */
+void inductByNewCNF(Clause* premise, Stack<Formula*>& hyps, Stack<Clause*>& res)
+{
+  Literal* lit = (*premise)[0];
+  Term* term = lit->nthArgument(1)->term();
+  Literal* clit = Literal::complementaryLiteral(lit);
+
+  TermList zero(theory->representConstant(IntegerConstantType(0)));
+  TermList one(theory->representConstant(IntegerConstantType(1)));
+  TermList mone(theory->representConstant(IntegerConstantType(-1)));
+  unsigned plus = env.signature->getInterpretingSymbol(Theory::INT_PLUS);
+  unsigned less = env.signature->getInterpretingSymbol(Theory::INT_LESS);
+
+  TermList x(0,false);
+  TermList y(1,false);
+
+  TermReplacement cr1(term,zero);
+  TermReplacement cr2(term,x);
+  TermReplacement cr3(term,y);
+  TermReplacement cr4(term,TermList(Term::create2(plus,x,one)));
+  TermReplacement cr5(term,TermList(Term::create2(plus,x,mone)));
+  Formula* Lzero = new AtomicFormula(cr1.transform(clit));
+  Formula* Lx = new AtomicFormula(cr2.transform(clit));
+  Literal* Ly = cr3.transform(clit);
+  Formula* Lxpo = new AtomicFormula(cr4.transform(clit));
+  Formula* Lxmo = new AtomicFormula(cr5.transform(clit));
+  Formula* Lxgz = new AtomicFormula(Literal::create2(less,false,x,zero));
+  Formula* Lygz = new AtomicFormula(Literal::create2(less,false,y,zero));
+  Formula* Lxlz = new AtomicFormula(Literal::create2(less,false,zero,x));
+  Formula* Lylz = new AtomicFormula(Literal::create2(less,false,zero,y));
+
+  hyps.push(new BinaryFormula(Connective::IMP,
+      new JunctionFormula(Connective::AND,new FormulaList(Lzero,new FormulaList(
+        Formula::quantify(new BinaryFormula(Connective::IMP,
+          new JunctionFormula(Connective::AND,new FormulaList(Lxgz,new FormulaList(Lx,0))),Lxpo)),0))),
+      Formula::quantify(new BinaryFormula(Connective::IMP,Lygz,new AtomicFormula(Ly)))));
+  hyps.push(new BinaryFormula(Connective::IMP,
+      new JunctionFormula(Connective::AND,new FormulaList(Lzero,new FormulaList(
+        Formula::quantify(new BinaryFormula(Connective::IMP,
+          new JunctionFormula(Connective::AND,new FormulaList(Lxlz,new FormulaList(Lx,0))),Lxmo)),0))),
+      Formula::quantify(new BinaryFormula(Connective::IMP,Lylz,new AtomicFormula(Ly)))));
+
+  NewCNF cnf(0);
+  cnf.setForInduction();
+  Stack<Clause*> hypClauses;
+  for(unsigned i=0;i<hyps.size();i++){
+    FormulaUnit* fu = new FormulaUnit(hyps[i],new Inference(Inference::INDUCTION),Unit::AXIOM);
+    cnf.clausify(NNF::ennf(fu),hypClauses);
+  }
+
+  Stack<Clause*>::Iterator cit(hypClauses);
+  while(cit.hasNext()){
+    RobSubstitution* subst = new RobSubstitution();
+    subst->unify(TermList(lit),0,TermList(Ly),1);
+    SLQueryResult qr(lit,premise,ResultSubstitution::fromSubstitution(subst,1,0));
+    res.push(BinaryResolution::generateClause(cit.next(),Ly,qr,*env.options));
+  }
+}
+
+/**
+ * Return the clause the induction inference of @b cl is performed on,
+ * i.e. the premise of @b cl that is not @b premise
+ */
+Clause* instanceOf(Clause* cl, Clause* premise)
+{
+  Inference* inf = cl->inference();
+  Inference::Iterator iit = inf->iterator();
+  while(inf->hasNext(iit)){
+    Unit* u = inf->next(iit);
+    if(u!=premise){
+      return static_cast<Clause*>(u);
+    }
+  }
+  ASSERTION_VIOLATION;
+}
+
+/**
+ * Return the clause of the literals of @b cl transformed by @b renaming
+ */
+Clause* renamed(Clause* cl, SymbolRenaming& renaming)
+{
+  Stack<Literal*> lits;
+  for(unsigned i=0;i<cl->length();i++){
+    lits.push(renaming.transform((*cl)[i]));
+  }
+  return Clause::fromStack(lits,Unit::AXIOM,new Inference(Inference::INPUT));
+}
+
+// the instances of the template give the same clauses as the clausification
+// of the instantiated schemas, and the instantiated schemas are the premises
+// of the instances in proofs
+TEST_FUN(mathInductionTemplate)
+{
+  env.options->set("induction","math");
+  Induction induction;
+
+  // builds the template and the integer constants of the schemas
+  ClauseIterator warmUp = induction.generateClauses(inductionPremise("p","a"));
+  while(warmUp.hasNext()){
+    warmUp.next();
+  }
+
+  Clause* premise = inductionPremise("q","b");
+
+  unsigned firstOld = env.signature->functions();
+  Stack<Formula*> hyps;
+  Stack<Clause*> oldClauses;
+  inductByNewCNF(premise,hyps,oldClauses);
+
+  unsigned firstNew = env.signature->functions();
+  Stack<Clause*> newClauses;
+  ClauseIterator cit = induction.generateClauses(premise);
+  while(cit.hasNext()){
+    newClauses.push(cit.next());
+  }
+  ASS_EQ(newClauses.size(),oldClauses.size());
+
+  // the instances introduce as many skolem functions as NewCNF, though not
+  // in the same order, so all of them are identified in the comparison
+  ASS_EQ(env.signature->functions()-firstNew,firstNew-firstOld);
+  DHMap<unsigned,unsigned> skolems;
+  for(unsigned f=firstOld+1;f<env.signature->functions();f++){
+    skolems.insert(f,firstOld);
+  }
+  SymbolRenaming renaming(skolems);
+
+  Stack<Clause*> oldRenamed;
+  for(unsigned i=0;i<oldClauses.size();i++){
+    oldRenamed.push(renamed(oldClauses[i],renaming));
+  }
+
+  for(unsigned i=0;i<newClauses.size();i++){
+    Clause* cl = newClauses[i];
+    Clause* rcl = renamed(cl,renaming);
+    bool found = false;
+    for(unsigned j=0;j<oldRenamed.size() && !found;j++){
+      found = MLVariant::isVariant(rcl,oldRenamed[j]);
+    }
+    ASS_REP(found,cl->toString());
+
+    Clause* inst = instanceOf(cl,premise);
+    UnitIterator parents = InferenceStore::instance()->getParents(inst);
+    ALWAYS(parents.hasNext());
+    Unit* hyp = parents.next();
+    ASS(!hyp->isClause());
+    vstring hypStr = static_cast<FormulaUnit*>(hyp)->formula()->toString();
+    ASS_REP(hypStr==hyps[0]->toString() || hypStr==hyps[1]->toString(),hypStr);
+  }
+}
@@ -44,7 +44,7 @@ using namespace Inferences;
 TEST_FUN(instances)
 {
 
-  unsigned mult = theory->getFnNum(Theory::INT_MULTIPLY);
+  unsigned mult = env.signature->getInterpretingSymbol(Theory::INT_MULTIPLY);
   TermList two(theory->representConstant(IntegerConstantType("2")));
   TermList five(theory->representConstant(IntegerConstantType("5")));
   TermList x(1,false);
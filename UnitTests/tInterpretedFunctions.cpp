@@ -26,6 +26,7 @@
 #include "Kernel/Signature.hpp"
 #include "Kernel/Term.hpp"
 #include "Kernel/Sorts.hpp"
+#include "Kernel/Theory.hpp"
 
 #include "Kernel/InterpretedLiteralEvaluator.hpp"
 
@@ -123,3 +124,161 @@ TEST_FUN(interpFunc4)
 
 }
 */
+
+IntegerConstantType num(const char* str)
+{
+  return IntegerConstantType(vstring(str));
+}
+
+/**
+ * Check that @b n has the value @b expected, and that it is stored in the
+ * same way as the numeral parsed from @b expected (inline if it fits into
+ * an int), as the comparison of values relies on that
+ */
+void checkValue(const IntegerConstantType& n, const char* expected)
+{
+  ASS_EQ(n.toString(), vstring(expected));
+  ASS_EQ(n, num(expected));
+}
+
+// carries from the inline representation and across several limbs
+TEST_FUN(bigCarry)
+{
+  checkValue(IntegerConstantType(INT_MAX)+IntegerConstantType(1), "2147483648");
+  checkValue(IntegerConstantType(INT_MIN)-IntegerConstantType(1), "-2147483649");
+  checkValue(num("4294967295")+num("1"), "4294967296");
+  checkValue(num("18446744073709551615")+num("1"), "18446744073709551616");
+  checkValue(num("79228162514264337593543950335")+num("79228162514264337593543950335"),
+      "158456325028528675187087900670");
+  checkValue(num("-18446744073709551615")-num("1"), "-18446744073709551616");
+  checkValue(-IntegerConstantType(INT_MIN), "2147483648");
+  checkValue(-num("2147483648"), "-2147483648");
+}
+
+// borrows across several limbs, shrinking back to the inline representation
+TEST_FUN(bigBorrow)
+{
+  checkValue(num("18446744073709551616")-num("1"), "18446744073709551615");
+  checkValue(num("79228162514264337593543950336")-num("18446744073709551617"),
+      "79228162495817593519834398719");
+  checkValue(num("18446744073709551616")-num("18446744073709551615"), "1");
+  checkValue(num("-18446744073709551616")+num("18446744073709551615"), "-1");
+  checkValue(num("5")-num("18446744073709551616"), "-18446744073709551611");
+  checkValue(num("-2147483649")+num("1"), "-2147483648");
+  checkValue(num("2147483648")-num("2147483648"), "0");
+}
+
+TEST_FUN(bigMultiply)
+{
+  checkValue(IntegerConstantType(65536)*IntegerConstantType(65536), "4294967296");
+  checkValue(num("18446744073709551615")*num("18446744073709551615"),
+      "340282366920938463426481119284349108225");
+  checkValue(num("-4294967296")*num("4294967296"), "-18446744073709551616");
+  checkValue(num("-4294967296")*num("-4294967296"), "18446744073709551616");
+  checkValue(num("79228162514264337593543950335")*num("1099511627783"),
+      "87112285932314843784223749864587958157305");
+  checkValue(num("18446744073709551616")*IntegerConstantType(0), "0");
+}
+
+/**
+ * Check that @b n divided by @b d gives quotient @b quot and remainder
+ * @b rem, with the remainder non-negative for both arguments positive
+ */
+void checkDivision(const char* n, const char* d, const char* quot, const char* rem)
+{
+  checkValue(num(n)/num(d), quot);
+  checkValue(num(n)%num(d), rem);
+  checkValue(num(n).quotientE(num(d)), quot);
+  checkValue(num(n).quotientF(num(d)), quot);
+}
+
+// divisors whose top limb needs to be shifted by up to 31 bits
+TEST_FUN(bigDivideNormalise)
+{
+  checkDivision("340282366920938463463374607431768211455", "4294967297",
+      "79228162495817593524129366015", "0");
+  checkDivision("1461501637330902918203684832716283019655932555321", "18446744078004518919",
+      "79228162495817593494064594957", "124554063838");
+  checkDivision("18446744073709551616", "3", "6148914691236517205", "1");
+  checkDivision("4294967296", "4294967297", "0", "4294967296");
+}
+
+// cases in which the estimated quotient digit is one too large and the divisor is added back
+TEST_FUN(bigDivideAddBack)
+{
+  checkDivision("39614081257132168796771975171", "9903520314283042199192993793",
+      "3", "9903520314283042199192993792");
+  checkDivision("730750818835592642570504054548153590213156798464", "18446744078004518913",
+      "39614081257132168795068602764", "7315928776234722932");
+  checkDivision("730750818495310275612406423097095723297676460033", "39614081257132168796291523606",
+      "18446744069414584319", "19510086729738159444010525719");
+  checkDivision("340282366881324382215465810675425131237", "39614081257132168798919458815",
+      "8589934590", "39614081247908796776376220387");
+  checkDivision("170141183460469231722463931681176813568", "39614081257132168796771975167",
+      "4294967295", "39614081247908796766359650303");
+}
+
+// quotients and remainders of all sign combinations
+TEST_FUN(bigQuotientSigns)
+{
+  // dividend, divisor, quotient_e, quotient_t, quotient_f, truncated remainder
+  static const char* cases[][6] = {
+    { "7", "2", "3", "3", "3", "1" },
+    { "7", "-2", "-3", "-3", "-4", "1" },
+    { "-7", "2", "-4", "-3", "-4", "-1" },
+    { "-7", "-2", "4", "3", "3", "-1" },
+    { "1180591620717411303429", "8589934595", "137438953424", "137438953424", "137438953424", "149" },
+    { "1180591620717411303429", "-8589934595", "-137438953424", "-137438953424", "-137438953425", "149" },
+    { "-1180591620717411303429", "8589934595", "-137438953425", "-137438953424", "-137438953425", "-149" },
+    { "-1180591620717411303429", "-8589934595", "137438953425", "137438953424", "137438953424", "-149" },
+    { "18446744073709551616", "-3", "-6148914691236517205", "-6148914691236517205", "-6148914691236517206", "1" },
+    { "-18446744073709551616", "3", "-6148914691236517206", "-6148914691236517205", "-6148914691236517206", "-1" },
+    { "-18446744073709551616", "-3", "6148914691236517206", "6148914691236517205", "6148914691236517205", "-1" },
+    { "6", "-1099511627776", "0", "0", "-1", "6" },
+    { "-6", "1099511627776", "-1", "0", "-1", "-6" },
+    { "-6", "-1099511627776", "1", "0", "0", "-6" },
+    { "79228162514264338693055578112", "-18446744073709551617", "-4294967296", "-4294967296", "-4294967297", "1095216660480" },
+    { "-79228162514264338693055578112", "18446744073709551617", "-4294967297", "-4294967296", "-4294967297", "-1095216660480" },
+    { "-79228162514264338693055578112", "-18446744073709551617", "4294967297", "4294967296", "4294967296", "-1095216660480" },
+    { "-18446744073709551616", "4294967296", "-4294967296", "-4294967296", "-4294967296", "0" },
+    { "-18446744073709551616", "-4294967296", "4294967296", "4294967296", "4294967296", "0" },
+  };
+
+  for (unsigned i = 0; i<sizeof(cases)/sizeof(cases[0]); i++) {
+    IntegerConstantType n = num(cases[i][0]);
+    IntegerConstantType d = num(cases[i][1]);
+    IntegerConstantType absD = d.isNegative() ? -d : d;
+
+    IntegerConstantType qE = n.quotientE(d);
+    IntegerConstantType qT = n.quotientT(d);
+    IntegerConstantType qF = n.quotientF(d);
+    checkValue(qE, cases[i][2]);
+    checkValue(qT, cases[i][3]);
+    checkValue(qF, cases[i][4]);
+    checkValue(n%d, cases[i][5]);
+
+    // the remainders have the sign required by the respective rounding
+    IntegerConstantType rE = n-qE*d;
+    IntegerConstantType rT = n-qT*d;
+    IntegerConstantType rF = n-qF*d;
+    ASS(!rE.isNegative() && rE<absD);
+    ASS(rT.isZero() || rT.isNegative()==n.isNegative());
+    ASS(rF.isZero() || rF.isNegative()==d.isNegative());
+    ASS_EQ(rT, n%d);
+  }
+}
+
+TEST_FUN(bigGcd)
+{
+  checkValue(IntegerConstantType::gcd(num("18446744073709551616"), num("3298534883328")), "1099511627776");
+  checkValue(IntegerConstantType::gcd(num("-1180591620717411303424"), num("171798691840")), "34359738368");
+  // (2^61-1)*(2^31-1) and (2^61-1)*(2^89-1)
+  checkValue(IntegerConstantType::gcd(num("4951760154835678088235319297"),
+      num("1427247692705959880439315947500961989719490561")), "2305843009213693951");
+  checkValue(IntegerConstantType::gcd(IntegerConstantType(INT_MIN), num("1099511627776")), "2147483648");
+  checkValue(IntegerConstantType::gcd(num("18446744073709551617"), num("-18446744073709551617")),
+      "18446744073709551617");
+  checkValue(IntegerConstantType::gcd(num("18446744073709551617"), num("3")), "1");
+  // zero arguments give 1, as with Int::gcd
+  checkValue(IntegerConstantType::gcd(IntegerConstantType(0), num("18446744073709551616")), "1");
+}
@@ -38,7 +38,7 @@ using namespace Shell;
 
 TEST_FUN(interpNorm1)
 {
-  unsigned succ = theory->getFnNum(Theory::INT_SUCCESSOR);
+  unsigned succ = env.signature->getInterpretingSymbol(Theory::INT_SUCCESSOR);
   TermList two(theory->representConstant(IntegerConstantType(2)));
   TermList twoS(Term::create1(succ, two));
   Literal* lit = Literal::createEquality(true, twoS, twoS, Sorts::SRT_INTEGER);
@@ -0,0 +1,570 @@
+/*
+ * File tLinearArithmeticDP.cpp.
+ *
+ * This file is part of the source code of the software program
+ * Vampire. It is protected by applicable
+ * copyright laws.
+ *
+ * This source code is distributed under the licence found here
+ * https://vprover.github.io/license.html
+ * and in the source directory
+ *
+ * In summary, you are allowed to use Vampire for non-commercial
+ * purposes but not allowed to distribute, modify, copy, create derivatives,
+ * or use in competitions.
+ * For other uses of Vampire please contact developers for a different
+ * licence, which we will make an effort to provide.
+ */
+
+#include "Forwards.hpp"
+#include "Lib/DHMap.hpp"
+#include "Lib/Environment.hpp"
+#include "Lib/Int.hpp"
+#include "Lib/Random.hpp"
+#include "Lib/Stack.hpp"
+
+#include "Kernel/Signature.hpp"
+#include "Kernel/Sorts.hpp"
+#include "Kernel/Term.hpp"
+#include "Kernel/Theory.hpp"
+
+#include "DP/LinearArithmeticDP.hpp"
+
+#include "Test/UnitTesting.hpp"
+
+#define UNIT_ID linArithDP
+UT_CREATE;
+
+using namespace std;
+using namespace Lib;
+using namespace Kernel;
+using namespace DP;
+
+typedef RationalConstantType Rat;
+typedef DecisionProcedure::Status Status;
+
+/** Number of variables of the constraints */
+static const unsigned VAR_CNT = 3;
+
+/**
+ * A constraint sum(coeffs[i]*x_i) op rhs, where op is = for equalities,
+ * < for strict and <= for the other inequalities
+ */
+struct LinConstraint
+{
+  LinConstraint() : rhs(0), strict(false), equality(false)
+  {
+    for (unsigned i=0; i<VAR_CNT; i++) {
+      coeffs[i] = 0;
+    }
+  }
+  LinConstraint(int c0, int c1, int c2, int rhs, bool strict, bool equality=false)
+    : rhs(rhs), strict(strict), equality(equality)
+  {
+    coeffs[0] = c0;
+    coeffs[1] = c1;
+    coeffs[2] = c2;
+  }
+
+  int coeffs[VAR_CNT];
+  int rhs;
+  bool strict;
+  bool equality;
+};
+
+typedef Stack<LinConstraint> LinConstraintStack;
+
+Rat rat(int n)
+{
+  return Rat(IntegerConstantType(n));
+}
+
+/**
+ * Builds the literals of constraints over the constants x0,x1,x2 of
+ * the sort $real or $int
+ */
+class LitBuilder
+{
+public:
+  LitBuilder(bool integer) : _integer(integer)
+  {
+    _sort = integer ? Sorts::SRT_INTEGER : Sorts::SRT_REAL;
+    for (unsigned i=0; i<VAR_CNT; i++) {
+      vstring name = (integer ? "i" : "r") + Int::toString(i);
+      unsigned fn = env.signature->addFunction(name, 0);
+      env.signature->getFunction(fn)->setType(OperatorType::getConstantsType(_sort));
+      _vars[i] = TermList(Term::createConstant(fn));
+    }
+  }
+
+  /**
+   * Return a literal expressing @b c, written in the way given by
+   * @b form, so that all the interpreted predicates and negations get used
+   */
+  Literal* literal(const LinConstraint& c, unsigned form)
+  {
+    TermList lhs = linear(c);
+    TermList rhs = number(c.rhs);
+    if (c.equality) {
+      return form%2 ? Literal::createEquality(true, rhs, lhs, _sort)
+                    : Literal::createEquality(true, lhs, rhs, _sort);
+    }
+    switch (form%3) {
+    case 0:
+      return Literal::create2(pred(c.strict ? LESS : LESS_EQUAL), true, lhs, rhs);
+    case 1:
+      return Literal::create2(pred(c.strict ? GREATER : GREATER_EQUAL), true, rhs, lhs);
+    default:
+      // ~(lhs>=rhs) is lhs<rhs and ~(lhs>rhs) is lhs<=rhs
+      return Literal::create2(pred(c.strict ? GREATER_EQUAL : GREATER), false, lhs, rhs);
+    }
+  }
+
+private:
+  enum Pred { LESS, LESS_EQUAL, GREATER, GREATER_EQUAL };
+
+  unsigned pred(Pred p)
+  {
+    static const Interpretation realPreds[] = { Theory::REAL_LESS, Theory::REAL_LESS_EQUAL,
+        Theory::REAL_GREATER, Theory::REAL_GREATER_EQUAL };
+    static const Interpretation intPreds[] = { Theory::INT_LESS, Theory::INT_LESS_EQUAL,
+        Theory::INT_GREATER, Theory::INT_GREATER_EQUAL };
+    return env.signature->getInterpretingSymbol(_integer ? intPreds[p] : realPreds[p]);
+  }
+
+  TermList number(int n)
+  {
+    if (_integer) {
+      return TermList(theory->representConstant(IntegerConstantType(n)));
+    }
+    return TermList(theory->representConstant(RealConstantType(rat(n))));
+  }
+
+  TermList linear(const LinConstraint& c)
+  {
+    unsigned plus = env.signature->getInterpretingSymbol(_integer ? Theory::INT_PLUS : Theory::REAL_PLUS);
+    unsigned mul = env.signature->getInterpretingSymbol(_integer ? Theory::INT_MULTIPLY : Theory::REAL_MULTIPLY);
+    TermList res;
+    bool empty = true;
+    for (unsigned i=0; i<VAR_CNT; i++) {
+      if (!c.coeffs[i]) {
+        continue;
+      }
+      TermList mon = c.coeffs[i]==1 ? _vars[i] : TermList(Term::create2(mul, number(c.coeffs[i]), _vars[i]));
+      res = empty ? mon : TermList(Term::create2(plus, res, mon));
+      empty = false;
+    }
+    return empty ? number(0) : res;
+  }
+
+  bool _integer;
+  unsigned _sort;
+  TermList _vars[VAR_CNT];
+};
+
+/** A constraint of the Fourier-Motzkin elimination */
+struct RatConstraint
+{
+  Rat coeffs[VAR_CNT];
+  Rat rhs;
+  bool strict;
+};
+
+/**
+ * Return true iff the constraints have a real solution, decided
+ * by Fourier-Motzkin elimination
+ */
+bool realFeasible(const LinConstraintStack& cs)
+{
+  Rat zero = rat(0);
+  Stack<RatConstraint> cur;
+  for (unsigned i=0; i<cs.size(); i++) {
+    const LinConstraint& c = cs[i];
+    RatConstraint rc;
+    for (unsigned j=0; j<VAR_CNT; j++) {
+      rc.coeffs[j] = rat(c.coeffs[j]);
+    }
+    rc.rhs = rat(c.rhs);
+    rc.strict = c.strict && !c.equality;
+    cur.push(rc);
+    if (c.equality) {
+      for (unsigned j=0; j<VAR_CNT; j++) {
+        rc.coeffs[j] = -rc.coeffs[j];
+      }
+      rc.rhs = -rc.rhs;
+      cur.push(rc);
+    }
+  }
+
+  for (unsigned v=0; v<VAR_CNT; v++) {
+    Stack<RatConstraint> next;
+    Stack<RatConstraint> pos;
+    Stack<RatConstraint> neg;
+    for (unsigned i=0; i<cur.size(); i++) {
+      RatConstraint& rc = cur[i];
+      if (rc.coeffs[v]==zero) {
+        next.push(rc);
+        continue;
+      }
+      // scale so that the coefficient of v is 1 or -1
+      Rat f = rc.coeffs[v]>zero ? rc.coeffs[v] : -rc.coeffs[v];
+      for (unsigned j=0; j<VAR_CNT; j++) {
+        rc.coeffs[j] = rc.coeffs[j]/f;
+      }
+      rc.rhs = rc.rhs/f;
+      (rc.coeffs[v]>zero ? pos : neg).push(rc);
+    }
+    for (unsigned i=0; i<pos.size(); i++) {
+      for (unsigned j=0; j<neg.size(); j++) {
+        RatConstraint sum;
+        for (unsigned k=0; k<VAR_CNT; k++) {
+          sum.coeffs[k] = pos[i].coeffs[k]+neg[j].coeffs[k];
+        }
+        sum.rhs = pos[i].rhs+neg[j].rhs;
+        sum.strict = pos[i].strict || neg[j].strict;
+        next.push(sum);
+      }
+    }
+    cur = next;
+  }
+
+  for (unsigned i=0; i<cur.size(); i++) {
+    if (cur[i].strict ? !(zero<cur[i].rhs) : !(zero<=cur[i].rhs)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** Return true iff the constraints have an integer solution with all values in [-bound,bound] */
+bool integerFeasibleInBox(const LinConstraintStack& cs, int bound)
+{
+  int vals[VAR_CNT];
+  for (unsigned i=0; i<VAR_CNT; i++) {
+    vals[i] = -bound;
+  }
+  for (;;) {
+    bool sat = true;
+    for (unsigned i=0; sat && i<cs.size(); i++) {
+      const LinConstraint& c = cs[i];
+      int lhs = 0;
+      for (unsigned j=0; j<VAR_CNT; j++) {
+        lhs += c.coeffs[j]*vals[j];
+      }
+      sat = c.equality ? lhs==c.rhs : (c.strict ? lhs<c.rhs : lhs<=c.rhs);
+    }
+    if (sat) {
+      return true;
+    }
+    unsigned i = 0;
+    while (i<VAR_CNT && vals[i]==bound) {
+      vals[i++] = -bound;
+    }
+    if (i==VAR_CNT) {
+      return false;
+    }
+    vals[i]++;
+  }
+}
+
+/**
+ * Put the constraints behind the literals of the procedure's unsat
+ * core into @b core, checking that each of them is in @b asserted
+ */
+void getCore(LinearArithmeticDP& dp, DHMap<Literal*,LinConstraint>& asserted, LinConstraintStack& core)
+{
+  ASS_EQ(dp.getUnsatCoreCount(), 1u);
+  LiteralStack lits;
+  dp.getUnsatCore(lits, 0);
+  ASS(lits.isNonEmpty());
+  core.reset();
+  while (lits.isNonEmpty()) {
+    Literal* l = lits.pop();
+    LinConstraint c;
+    bool found = asserted.find(l, c);
+    ASS_REP(found, l->toString());
+    core.push(c);
+  }
+}
+
+/**
+ * Add @b cs to @b dp in a new level and return the status. The constraints
+ * are recorded in @b asserted, and if the status is UNSATISFIABLE, it is
+ * checked that the core has no real (@b integer false) or no integer
+ * (@b integer true) solution.
+ */
+Status pushConstraints(LinearArithmeticDP& dp, LitBuilder& b, bool integer,
+    DHMap<Literal*,LinConstraint>& asserted, const LinConstraintStack& cs)
+{
+  dp.push();
+  LiteralStack lits;
+  for (unsigned i=0; i<cs.size(); i++) {
+    Literal* l = b.literal(cs[i], asserted.size()+i);
+    asserted.set(l, cs[i]);
+    lits.push(l);
+  }
+  dp.addLiterals(pvi(LiteralStack::Iterator(lits)), false);
+  Status res = dp.getStatus(false);
+  if (res==DecisionProcedure::UNSATISFIABLE) {
+    LinConstraintStack core;
+    getCore(dp, asserted, core);
+    if (integer) {
+      ASS(!integerFeasibleInBox(core, 10));
+    }
+    else {
+      ASS(!realFeasible(core));
+    }
+  }
+  return res;
+}
+
+Status pushConstraint(LinearArithmeticDP& dp, LitBuilder& b, bool integer,
+    DHMap<Literal*,LinConstraint>& asserted, const LinConstraint& c)
+{
+  LinConstraintStack cs;
+  cs.push(c);
+  return pushConstraints(dp, b, integer, asserted, cs);
+}
+
+#define SAT DecisionProcedure::SATISFIABLE
+#define UNSAT DecisionProcedure::UNSATISFIABLE
+#define UNKNOWN DecisionProcedure::UNKNOWN
+
+TEST_FUN(linArithStrictBounds)
+{
+  LitBuilder b(false);
+  DHMap<Literal*,LinConstraint> asserted;
+
+  {
+    // x0<1 & x0>=1, only the infinitesimal separates the bounds
+    LinearArithmeticDP dp;
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(1,0,0, 1, true)), SAT);
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(-1,0,0, -1, false)), UNSAT);
+  }
+  {
+    // x0<1 & x0>0
+    LinearArithmeticDP dp;
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(1,0,0, 1, true)), SAT);
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(-1,0,0, 0, true)), SAT);
+  }
+  {
+    // x0+x1<2 & x0>=1 & x1>=1 is infeasible, x0+x1<=2 instead is not
+    LinearArithmeticDP dp;
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(-1,0,0, -1, false)), SAT);
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(0,-1,0, -1, false)), SAT);
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(1,1,0, 2, false)), SAT);
+    dp.pop();
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(1,1,0, 2, true)), UNSAT);
+  }
+  {
+    // x0<x1 & x1<x0 through a single slack with both strict bounds
+    LinearArithmeticDP dp;
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(1,-1,0, 0, true)), SAT);
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(-1,1,0, 0, true)), UNSAT);
+  }
+  {
+    // 2*x0+2*x1<3 & x0+x1>=3/2 with the strictness in the scaled form
+    LinearArithmeticDP dp;
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(2,2,0, 3, true)), SAT);
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(-4,-4,0, -6, false)), UNSAT);
+  }
+}
+
+TEST_FUN(linArithIntegerRounding)
+{
+  LitBuilder b(true);
+  DHMap<Literal*,LinConstraint> asserted;
+
+  {
+    // -2*x0<=3 gives x0>=-1 after dividing by the negative factor
+    LinearArithmeticDP dp;
+    ASS_EQ(pushConstraint(dp, b, true, asserted, LinConstraint(-2,0,0, 3, false)), UNKNOWN);
+    ASS_EQ(pushConstraint(dp, b, true, asserted, LinConstraint(1,0,0, -1, true)), UNSAT);
+  }
+  {
+    // -2*x0<=3 & x0<=-1 has the solution x0=-1
+    LinearArithmeticDP dp;
+    ASS_EQ(pushConstraint(dp, b, true, asserted, LinConstraint(-2,0,0, 3, false)), UNKNOWN);
+    ASS_EQ(pushConstraint(dp, b, true, asserted, LinConstraint(1,0,0, -1, false)), UNKNOWN);
+  }
+  {
+    // -2*x0<4 gives x0>=-1, 2*x0<=-3 gives x0<=-2
+    LinearArithmeticDP dp;
+    ASS_EQ(pushConstraint(dp, b, true, asserted, LinConstraint(-2,0,0, 4, true)), UNKNOWN);
+    ASS_EQ(pushConstraint(dp, b, true, asserted, LinConstraint(2,0,0, -3, false)), UNSAT);
+  }
+  {
+    // -3*(x0+x1)<=-4 gives x0+x1>=2, 2*(x0+x1)<=3 gives x0+x1<=1, over one slack
+    LinearArithmeticDP dp;
+    ASS_EQ(pushConstraint(dp, b, true, asserted, LinConstraint(-3,-3,0, -4, false)), UNKNOWN);
+    ASS_EQ(pushConstraint(dp, b, true, asserted, LinConstraint(2,2,0, 3, false)), UNSAT);
+  }
+  {
+    // the strict x0+x1<2 gives x0+x1<=1, while x0+x1>=1 is consistent with it
+    LinearArithmeticDP dp;
+    ASS_EQ(pushConstraint(dp, b, true, asserted, LinConstraint(1,1,0, 2, true)), UNKNOWN);
+    ASS_EQ(pushConstraint(dp, b, true, asserted, LinConstraint(-1,-1,0, -1, false)), UNKNOWN);
+    ASS_EQ(pushConstraint(dp, b, true, asserted, LinConstraint(-1,-1,0, -2, false)), UNSAT);
+  }
+}
+
+TEST_FUN(linArithPushPop)
+{
+  LitBuilder b(false);
+  DHMap<Literal*,LinConstraint> asserted;
+  LinearArithmeticDP dp;
+
+  LinConstraintStack base;
+  base.push(LinConstraint(-1,0,0, -1, false));
+  base.push(LinConstraint(0,1,0, 1, false));
+  ASS_EQ(pushConstraints(dp, b, false, asserted, base), SAT);
+  ASS_EQ(dp.level(), 1u);
+
+  // x0+x1>=4 forces x0>=3
+  ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(-1,-1,0, -4, false)), SAT);
+  ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(1,0,0, 2, false)), UNSAT);
+  ASS_EQ(dp.level(), 3u);
+
+  // constraints added on top of a conflict do not change it
+  ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(0,0,1, 0, false)), UNSAT);
+  dp.pop();
+  ASS_EQ(dp.getStatus(false), UNSAT);
+
+  dp.pop();
+  ASS_EQ(dp.level(), 2u);
+  ASS_EQ(dp.getStatus(false), SAT);
+
+  // without x0+x1>=4 the bound x0<=2 is consistent again
+  dp.pop();
+  ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(1,0,0, 2, false)), SAT);
+  ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(-1,-1,0, -4, false)), UNSAT);
+  dp.pop(2);
+  ASS_EQ(dp.level(), 1u);
+
+  // the bounds of the popped levels are gone, those of the first remain
+  ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(1,0,0, 1, true)), UNSAT);
+  dp.pop();
+  ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(1,1,0, 2, false)), SAT);
+  dp.pop(2);
+  ASS_EQ(dp.level(), 0u);
+  ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(1,0,0, 0, false)), SAT);
+}
+
+TEST_FUN(linArithBlandPivoting)
+{
+  LitBuilder b(false);
+  DHMap<Literal*,LinConstraint> asserted;
+
+  for (int slack=-2; slack>=-4; slack--) {
+    // x0-x1>=1 & x1-x2>=1 & x2-x0>=slack, feasible iff slack<=-2
+    LinearArithmeticDP dp;
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(-1,1,0, -1, false)), SAT);
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(0,-1,1, -1, false)), SAT);
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(1,0,-1, -slack, false)), SAT);
+  }
+  {
+    LinearArithmeticDP dp;
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(-1,1,0, -1, false)), SAT);
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(0,-1,1, -1, false)), SAT);
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(1,0,-1, 1, false)), UNSAT);
+  }
+  {
+    // a degenerate system, where all the bounds meet in the origin and
+    // every pivot keeps the values, which cycles without Bland's rule
+    LinearArithmeticDP dp;
+    LinConstraintStack cs;
+    cs.push(LinConstraint(1,-2,1, 0, false));
+    cs.push(LinConstraint(-2,1,1, 0, false));
+    cs.push(LinConstraint(1,1,-2, 0, false));
+    cs.push(LinConstraint(-1,-1,-1, 0, false));
+    ASS_EQ(pushConstraints(dp, b, false, asserted, cs), SAT);
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(-1,0,0, -1, false)), SAT);
+    ASS_EQ(pushConstraint(dp, b, false, asserted, LinConstraint(1,1,1, 2, false)), UNSAT);
+  }
+}
+
+/**
+ * Return a random constraint with small coefficients over at least one variable
+ */
+LinConstraint randomConstraint(bool integer)
+{
+  LinConstraint c;
+  bool nonzero = false;
+  while (!nonzero) {
+    for (unsigned i=0; i<VAR_CNT; i++) {
+      c.coeffs[i] = Random::getInteger(integer ? 7 : 5)-(integer ? 3 : 2);
+      nonzero |= c.coeffs[i]!=0;
+    }
+  }
+  c.rhs = Random::getInteger(13)-6;
+  c.strict = Random::getInteger(2);
+  c.equality = !Random::getInteger(6);
+  return c;
+}
+
+/**
+ * Run random sequences of pushes and pops against the procedure and check
+ * the results against all the constraints of the current levels
+ */
+void randomPushPop(bool integer)
+{
+  LitBuilder b(integer);
+  DHMap<Literal*,LinConstraint> asserted;
+  Random::setSeed(1);
+
+  for (unsigned round=0; round<150; round++) {
+    LinearArithmeticDP dp;
+    LinConstraintStack active;
+    Stack<unsigned> levelStarts;
+    for (unsigned step=0; step<12; step++) {
+      // the Fourier-Motzkin elimination of the oracle is exponential,
+      // so there are at most eight active constraints
+      if (levelStarts.isNonEmpty() && (active.size()>=7 || !Random::getInteger(3))) {
+        unsigned cnt = Random::getInteger(levelStarts.size())+1;
+        dp.pop(cnt);
+        while (cnt--) {
+          active.truncate(levelStarts.pop());
+        }
+      }
+      else {
+        levelStarts.push(active.size());
+        LinConstraintStack cs;
+        unsigned cnt = Random::getInteger(2)+1;
+        while (cnt--) {
+          cs.push(randomConstraint(integer));
+          active.push(cs.top());
+        }
+        pushConstraints(dp, b, integer, asserted, cs);
+      }
+      ASS_EQ(dp.level(), levelStarts.size());
+
+      Status st = dp.getStatus(false);
+      bool feasible = realFeasible(active);
+      if (integer) {
+        // only the empty system of integer constraints is known to be satisfiable
+        if (active.isNonEmpty()) {
+          ASS_NEQ(st, SAT);
+        }
+        if (integerFeasibleInBox(active, 10)) {
+          ASS_NEQ(st, UNSAT);
+        }
+        if (!feasible) {
+          ASS_EQ(st, UNSAT);
+        }
+      }
+      else {
+        ASS_EQ(st, feasible ? SAT : UNSAT);
+      }
+    }
+  }
+}
+
+TEST_FUN(linArithRandomReal)
+{
+  randomPushPop(false);
+}
+
+TEST_FUN(linArithRandomInteger)
+{
+  randomPushPop(true);
+}
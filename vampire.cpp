@@ -83,6 +83,7 @@
 #include "Parse/TPTP.hpp"
 #include "Shell/FOOLElimination.hpp"
 #include "Shell/Statistics.hpp"
+#include "Shell/StreamingClausifier.hpp"
 #include "Shell/UIHelper.hpp"
 #include "Shell/LaTeX.hpp"
 
@@ -695,6 +696,12 @@ void clausifyMode(bool theory)
 {
   CALL("clausifyMode()");
 
+  if (env.options->streamingClausify()) {
+    StreamingClausifier(*env.options, theory).perform();
+    vampireReturnValue = VAMP_RESULT_STATUS_SUCCESS;
+    return;
+  }
+
   CompositeISE simplifier;
   simplifier.addFront(new TrivialInequalitiesRemovalISE());
   simplifier.addFront(new TautologyDeletionISE());
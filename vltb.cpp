@@ -17,7 +17,9 @@
  * licence, which we will make an effort to provide. 
  */
 /**
- * @file vampire.cpp. Implements the top-level procedures of Vampire.
+ * @file vltb.cpp. Implements the top-level procedures of the large theory
+ * batch executable, which builds the storage of a theory (Shell::LTB::Builder)
+ * and solves problems with axioms selected from it (Shell::LTB::Selector).
  */
 
 #include <iostream>
@@ -29,73 +31,45 @@
 
 #include "Lib/Exception.hpp"
 #include "Lib/Environment.hpp"
-#include "Lib/Int.hpp"
 #include "Lib/Random.hpp"
-#include "Lib/Set.hpp"
+#include "Lib/ScopedPtr.hpp"
 #include "Lib/Stack.hpp"
 #include "Lib/TimeCounter.hpp"
-#include "Lib/Timer.hpp"
 #include "Lib/VString.hpp"
 #include "Lib/List.hpp"
-#include "Lib/Vector.hpp"
 #include "Lib/System.hpp"
-#include "Lib/Metaiterators.hpp"
 
-#include "Kernel/Clause.hpp"
-#include "Kernel/Formula.hpp"
-#include "Kernel/FormulaUnit.hpp"
-#include "Kernel/InferenceStore.hpp"
-#include "Kernel/Term.hpp"
-
-#include "Indexing/SubstitutionTree.hpp"
-#include "Indexing/LiteralMiniIndex.hpp"
+#include "Kernel/Problem.hpp"
 
 #include "Shell/CommandLine.hpp"
-#include "Shell/Grounding.hpp"
-#include "Shell/Interpolants.hpp"
-#include "Shell/LaTeX.hpp"
-#include "Shell/LispLexer.hpp"
-#include "Shell/LispParser.hpp"
 #include "Shell/Options.hpp"
-#include "Shell/Property.hpp"
 #include "Shell/Preprocess.hpp"
-#include "Shell/Refutation.hpp"
-#include "Shell/TheoryFinder.hpp"
-#include "Shell/SimplifyProver.hpp"
 #include "Shell/Statistics.hpp"
-#include "Shell/TPTP.hpp"
+#include "Shell/UIHelper.hpp"
 
 #include "Shell/LTB/Builder.hpp"
 #include "Shell/LTB/Selector.hpp"
 
 #include "Parse/TPTP.hpp"
 
-#include "Saturation/SaturationAlgorithm.hpp"
-
-#include "SAT/DIMACS.hpp"
-#include "SAT/SATClause.hpp"
-
+#include "Saturation/ProvingHelper.hpp"
 
 #if CHECK_LEAKS
 #include "Lib/MemoryLeak.hpp"
 #endif
 
-#define SPIDER 0
-#define SAVE_SPIDER_PROPERTIES 0
-
 using namespace Shell;
-using namespace SAT;
 using namespace Saturation;
-using namespace Inferences;
 
-UnitList* globUnitList=0;
-
-ClauseIterator getProblemClauses()
+/**
+ * Return the preprocessed input problem with the axioms selected
+ * for it from the storage
+ */
+Problem* getPreprocessedProblem()
 {
-  CALL("getProblemClauses");
+  CALL("getPreprocessedProblem");
 
   Shell::LTB::Selector selector;
-  Property property;
 
   UnitList* units;
   {
@@ -114,17 +88,17 @@ ClauseIterator getProblemClauses()
     }
 
     env.statistics->phase=Statistics::PARSING;
-    if(env.options->inputSyntax()!=Options::IS_TPTP) {
+    if(env.options->inputSyntax()!=Options::InputSyntax::TPTP) {
       USER_ERROR("Unsupported input syntax");
     }
 
     {
       Parse::TPTP parser(*input);
-      StringList::Iterator names(selector.theoryFileNames());
+      Shell::LTB::StringList::Iterator names(selector.theoryFileNames());
       while (names.hasNext()) {
 	parser.addForbiddenInclude(names.next());
       }
-      parser.parse()
+      parser.parse();
       units = parser.units();
     }
 
@@ -138,75 +112,19 @@ ClauseIterator getProblemClauses()
 
   TimeCounter tc2(TC_PREPROCESSING);
 
-  env.statistics->phase=Statistics::PROPERTY_SCANNING;
-  property.scan(units);
-  Preprocess prepro(property,*env.options);
-  //phases for preprocessing are being set inside the proprocess method
-  prepro.preprocess(units);
-
-  globUnitList=units;
+  Problem* prb = new Problem(units);
+  Preprocess prepro(*env.options);
+  //phases for preprocessing are being set inside the preprocess method
+  prepro.preprocess(*prb);
 
-  return pvi( getStaticCastIterator<Clause*>(UnitList::Iterator(units)) );
+  return prb;
 }
 
-void outputResult()
+void explainException(Exception& exception)
 {
-  CALL("outputResult()");
-
-  switch (env.statistics->terminationReason) {
-  case Statistics::REFUTATION:
-    env.out << "Refutation found. Thanks to "
-	    << env.options->thanks() << "!\n";
-    if (env.options->proof() != Options::PROOF_OFF) {
-//	Shell::Refutation refutation(env.statistics->refutation,
-//		env.options->proof() == Options::PROOF_ON);
-//	refutation.output(env.out);
-      InferenceStore::instance()->outputProof(env.out, env.statistics->refutation);
-    }
-    if(env.options->showInterpolant()!=Options::INTERP_OFF) {
-      ASS(env.statistics->refutation->isClause());
-      Formula* interpolant=Interpolants::getInterpolant(static_cast<Clause*>(env.statistics->refutation));
-      env.out << "Interpolant: " << interpolant->toString() << endl;
-    }
-    if(env.options->latexOutput()!="off") {
-      ofstream latexOut(env.options->latexOutput().c_str());
-
-      LaTeX formatter;
-      latexOut<<formatter.refutationToString(env.statistics->refutation);
-    }
-    break;
-  case Statistics::TIME_LIMIT:
-    env.out << "Time limit reached!\n";
-    break;
-  case Statistics::MEMORY_LIMIT:
-#if VDEBUG
-    Allocator::reportUsageByClasses();
-#endif
-    env.out << "Memory limit exceeded!\n";
-    break;
-  case Statistics::REFUTATION_NOT_FOUND:
-    if(env.options->complete()) {
-      ASS_EQ(env.options->saturationAlgorithm(), Options::LRS);
-      env.out << "Refutation not found, LRS age and weight limit was active for some time!\n";
-    } else {
-      env.out << "Refutation not found with incomplete strategy!\n";
-    }
-    break;
-  case Statistics::SATISFIABLE:
-    env.out << "Refutation not found!\n";
-    break;
-  case Statistics::UNKNOWN:
-    env.out << "Unknown reason of termination!\n";
-    break;
-  default:
-    ASSERTION_VIOLATION;
-  }
-  env.statistics->print();
-}
-
-void explainException (Exception& exception)
-{
-  exception.cry(env.out);
+  env.beginOutput();
+  exception.cry(env.out());
+  env.endOutput();
 } // explainException
 
 void ltbBuildMode()
@@ -227,11 +145,9 @@ void ltbBuildMode()
   istream& input=*input0;
 
   Stack<vstring> nameStack;
-  char lineBuf[1024];
+  vstring line;
 
-  while(!input.eof()) {
-    input.getline(lineBuf, 1024);
-    vstring line(lineBuf);
+  while(getline(input, line)) {
     if(line.length()<12 || line.substr(0,9)!="include('" || line.substr(line.length()-3,3)!="').") {
       continue;
     }
@@ -252,33 +168,12 @@ void ltbSolveMode()
 {
   CALL("ltbSolveMode");
 
+  ScopedPtr<Problem> prb(getPreprocessedProblem());
+  ProvingHelper::runVampireSaturation(*prb, *env.options);
+
   env.beginOutput();
-  env.out()<<env.options->testId()<<" on "<<env.options->problemName()<<endl;
+  UIHelper::outputResult(env.out());
   env.endOutput();
-  try {
-    ClauseIterator clauses=getProblemClauses();
-    Unit::onPreprocessingEnd();
-
-    env.statistics->phase=Statistics::SATURATION;
-    MainLoopSP salg=MainLoop::createFromOptions();
-    salg->addInputClauses(clauses);
-
-    MainLoopResult sres(salg->saturate());
-    env.statistics->phase=Statistics::FINALIZATION;
-    sres.updateStatistics();
-  }
-  catch(MemoryLimitExceededException) {
-    env.statistics->terminationReason=Statistics::MEMORY_LIMIT;
-    env.statistics->refutation=0;
-    size_t limit=Allocator::getMemoryLimit();
-    //add extra 1 MB to allow proper termination
-    Allocator::setMemoryLimit(limit+1000000);
-  }
-  catch(TimeLimitExceededException) {
-    env.statistics->terminationReason=Statistics::TIME_LIMIT;
-    env.statistics->refutation=0;
-  }
-  outputResult();
 }
 
 /**
@@ -291,6 +186,7 @@ int main(int argc, char* argv [])
 {
   CALL ("main");
 
+  System::registerArgv0(argv[0]);
   System::setSignalHandlers();
    // create random seed for the random number generation
   Lib::Random::setSeed(123456);
@@ -305,10 +201,10 @@ int main(int argc, char* argv [])
 
     switch (env.options->mode())
     {
-    case Options::MODE_LTB_BUILD:
+    case Options::Mode::LTB_BUILD:
       ltbBuildMode();
       break;
-    case Options::MODE_LTB_SOLVE:
+    case Options::Mode::LTB_SOLVE:
       ltbSolveMode();
       break;
     default:
@@ -316,10 +212,6 @@ int main(int argc, char* argv [])
       break;
     }
 #if CHECK_LEAKS
-    if (globUnitList) {
-      MemoryLeak leak;
-      leak.release(globUnitList);
-    }
     delete env.signature;
     env.signature = 0;
 #endif
@@ -345,17 +237,16 @@ int main(int argc, char* argv [])
     MemoryLeak::cancelReport();
 #endif
     explainException(exception);
-    env.statistics->print();
   }
   catch (std::bad_alloc& _) {
     reportSpiderFail();
 #if CHECK_LEAKS
     MemoryLeak::cancelReport();
 #endif
-    env.out << "Insufficient system memory" << '\n';
+    env.beginOutput();
+    env.out() << "Insufficient system memory" << '\n';
+    env.endOutput();
   }
-//   delete env.allocator;
 
   return EXIT_SUCCESS;
 } // main
-